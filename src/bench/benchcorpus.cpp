@@ -0,0 +1,281 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "benchcorpus.h"
+
+#include "bzlib.h"
+#include "zlib.h"
+
+BenchCorpus::BenchCorpus(quint32 nSeed) : m_nState(nSeed ? nSeed : 1)
+{
+}
+
+QStringList BenchCorpus::create(const QString &sDirectory)
+{
+    QStringList listResult;
+
+    QDir().mkpath(sDirectory);
+
+    QList<RECORD> listSmall = createRecords(2000, 4 * 1024);
+    QList<RECORD> listLarge = createRecords(16, 4 * 1024 * 1024);
+
+    QList<RECORD> listNested;
+    listNested.append({QStringLiteral("inner.zip"), createZip(listSmall.mid(0, 500), true)});
+    listNested.append({QStringLiteral("payload.bin"), createRandom(1024 * 1024)});
+
+    QByteArray baStream = createText(32 * 1024 * 1024);
+
+    QList<RECORD> listCases;
+    listCases.append({QStringLiteral("zip_stored_small.zip"), createZip(listSmall, false)});
+    listCases.append({QStringLiteral("zip_deflate_small.zip"), createZip(listSmall, true)});
+    listCases.append({QStringLiteral("zip_deflate_large.zip"), createZip(listLarge, true)});
+    listCases.append({QStringLiteral("zip_nested.zip"), createZip(listNested, true)});
+    listCases.append({QStringLiteral("stream.gz"), compressGzip(baStream)});
+    listCases.append({QStringLiteral("stream.bz2"), compressBzip2(baStream)});
+    listCases.append({QStringLiteral("random.bin"), createRandom(16 * 1024 * 1024)});
+
+    qint32 nNumberOfCases = listCases.count();
+
+    for (qint32 i = 0; i < nNumberOfCases; i++) {
+        QString sFileName = sDirectory + QDir::separator() + listCases.at(i).sName;
+
+        if (writeFile(sFileName, listCases.at(i).baData)) {
+            listResult.append(sFileName);
+        }
+    }
+
+    return listResult;
+}
+
+QList<BenchCorpus::RECORD> BenchCorpus::createTriageFixtures()
+{
+    struct _MAGIC {
+        const char *pPattern;
+        qint32 nSize;
+        const char *pName;
+    };
+
+    static const _MAGIC magics[] = {
+        {"Rar!\x1A\x07\x00", 7, "RAR"},
+        {"7z\xBC\xAF\x27\x1C", 6, "7-Zip"},
+        {"\xFD" "7zXZ\x00", 6, "XZ"},
+        {"MSCF\x00\x00\x00\x00", 8, "CAB"},
+        {"\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1", 8, "OLE"},
+        {"%PDF-1.7\n", 9, "PDF"},
+    };
+
+    QList<RECORD> listResult;
+
+    qint32 nNumberOfMagics = sizeof(magics) / sizeof(magics[0]);
+
+    for (qint32 i = 0; i < nNumberOfMagics; i++) {
+        listResult.append({QString::fromLatin1(magics[i].pName), QByteArray(magics[i].pPattern, magics[i].nSize) + createText(64 * 1024)});
+    }
+
+    // Readers accept a PDF header within the first KB
+    listResult.append({QStringLiteral("PDF after a preamble"), createText(700) + QByteArrayLiteral("%PDF-1.4\n") + createText(64 * 1024)});
+    // Stored text: neither the head entropy nor a media magic would send it deep
+    QList<RECORD> listText;
+
+    for (qint32 i = 0; i < 16; i++) {
+        listText.append({QString("text%1.txt").arg(i), createText(4 * 1024)});
+    }
+
+    listResult.append({QStringLiteral("ZIP stored"), createZip(listText, false)});
+    listResult.append({QStringLiteral("ZIP behind a stub"), createText(2048) + createZip(listText, false)});
+
+    return listResult;
+}
+
+QByteArray BenchCorpus::createZip(const QList<RECORD> &listRecords, bool bDeflate)
+{
+    QByteArray baResult;
+    QByteArray baCentral;
+
+    QDataStream dsResult(&baResult, QIODevice::WriteOnly);
+    dsResult.setByteOrder(QDataStream::LittleEndian);
+
+    QDataStream dsCentral(&baCentral, QIODevice::WriteOnly);
+    dsCentral.setByteOrder(QDataStream::LittleEndian);
+
+    qint32 nNumberOfRecords = listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const RECORD &record = listRecords.at(i);
+
+        QByteArray baName = record.sName.toUtf8();
+        QByteArray baData = bDeflate ? compressDeflate(record.baData) : record.baData;
+        quint16 nMethod = bDeflate ? 8 : 0;
+        quint32 nCRC = (quint32)crc32(0, (const Bytef *)record.baData.constData(), (uInt)record.baData.size());
+        quint32 nOffset = (quint32)baResult.size();
+
+        dsResult << (quint32)0x04034B50 << (quint16)20 << (quint16)0 << nMethod << (quint16)0 << (quint16)0x21 << nCRC << (quint32)baData.size()
+                 << (quint32)record.baData.size() << (quint16)baName.size() << (quint16)0;
+        dsResult.writeRawData(baName.constData(), baName.size());
+        dsResult.writeRawData(baData.constData(), baData.size());
+
+        dsCentral << (quint32)0x02014B50 << (quint16)20 << (quint16)20 << (quint16)0 << nMethod << (quint16)0 << (quint16)0x21 << nCRC << (quint32)baData.size()
+                  << (quint32)record.baData.size() << (quint16)baName.size() << (quint16)0 << (quint16)0 << (quint16)0 << (quint16)0 << (quint32)0 << nOffset;
+        dsCentral.writeRawData(baName.constData(), baName.size());
+    }
+
+    quint32 nCentralOffset = (quint32)baResult.size();
+
+    dsResult.writeRawData(baCentral.constData(), baCentral.size());
+    dsResult << (quint32)0x06054B50 << (quint16)0 << (quint16)0 << (quint16)nNumberOfRecords << (quint16)nNumberOfRecords << (quint32)baCentral.size() << nCentralOffset
+             << (quint16)0;
+
+    return baResult;
+}
+
+QByteArray BenchCorpus::compressDeflate(const QByteArray &baData)
+{
+    QByteArray baResult;
+
+    z_stream strm = {};
+
+    // Raw deflate, as stored in zip records
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+        baResult.resize((int)deflateBound(&strm, (uLong)baData.size()));
+
+        strm.next_in = (Bytef *)baData.constData();
+        strm.avail_in = (uInt)baData.size();
+        strm.next_out = (Bytef *)baResult.data();
+        strm.avail_out = (uInt)baResult.size();
+
+        deflate(&strm, Z_FINISH);
+
+        baResult.resize((int)strm.total_out);
+
+        deflateEnd(&strm);
+    }
+
+    return baResult;
+}
+
+QByteArray BenchCorpus::compressGzip(const QByteArray &baData)
+{
+    QByteArray baResult;
+
+    z_stream strm = {};
+
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+        baResult.resize((int)deflateBound(&strm, (uLong)baData.size()) + 32);
+
+        strm.next_in = (Bytef *)baData.constData();
+        strm.avail_in = (uInt)baData.size();
+        strm.next_out = (Bytef *)baResult.data();
+        strm.avail_out = (uInt)baResult.size();
+
+        deflate(&strm, Z_FINISH);
+
+        baResult.resize((int)strm.total_out);
+
+        deflateEnd(&strm);
+    }
+
+    return baResult;
+}
+
+QByteArray BenchCorpus::compressBzip2(const QByteArray &baData)
+{
+    QByteArray baResult(baData.size() + baData.size() / 100 + 600, Qt::Uninitialized);
+
+    unsigned int nDestSize = (unsigned int)baResult.size();
+
+    if (BZ2_bzBuffToBuffCompress(baResult.data(), &nDestSize, (char *)baData.constData(), (unsigned int)baData.size(), 9, 0, 0) == BZ_OK) {
+        baResult.resize((int)nDestSize);
+    } else {
+        baResult.clear();
+    }
+
+    return baResult;
+}
+
+quint32 BenchCorpus::random()
+{
+    // xorshift32
+    m_nState ^= m_nState << 13;
+    m_nState ^= m_nState >> 17;
+    m_nState ^= m_nState << 5;
+
+    return m_nState;
+}
+
+QByteArray BenchCorpus::createText(qint32 nSize)
+{
+    static const char *pszWords[] = {"unpack", "archive", "entry", "header", "section", "stream", "block", "record", "packer", "signature", "offset", "size"};
+    const qint32 nNumberOfWords = sizeof(pszWords) / sizeof(pszWords[0]);
+
+    QByteArray baResult;
+    baResult.reserve(nSize + 16);
+
+    while (baResult.size() < nSize) {
+        baResult.append(pszWords[random() % nNumberOfWords]);
+        baResult.append((random() % 8) ? ' ' : '\n');
+    }
+
+    baResult.resize(nSize);
+
+    return baResult;
+}
+
+QByteArray BenchCorpus::createRandom(qint32 nSize)
+{
+    QByteArray baResult(nSize, Qt::Uninitialized);
+
+    char *pData = baResult.data();
+
+    for (qint32 i = 0; i < nSize; i++) {
+        pData[i] = (char)(random() >> 24);
+    }
+
+    return baResult;
+}
+
+QList<BenchCorpus::RECORD> BenchCorpus::createRecords(qint32 nNumberOfRecords, qint32 nRecordSize)
+{
+    QList<RECORD> listResult;
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        RECORD record = {};
+        record.sName = QStringLiteral("dir%1/file%2.%3").arg(i % 16).arg(i).arg((i % 4) ? QStringLiteral("txt") : QStringLiteral("bin"));
+        // One record in four is incompressible
+        record.baData = (i % 4) ? createText(nRecordSize) : createRandom(nRecordSize);
+
+        listResult.append(record);
+    }
+
+    return listResult;
+}
+
+bool BenchCorpus::writeFile(const QString &sFileName, const QByteArray &baData)
+{
+    bool bResult = false;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        bResult = (file.write(baData) == baData.size());
+        file.close();
+    }
+
+    return bResult;
+}
@@ -0,0 +1,62 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BENCHCORPUS_H
+#define BENCHCORPUS_H
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QString>
+
+// Fixed synthetic corpus: the same seed always produces byte-identical files, so
+// throughput figures of two builds are comparable.
+class BenchCorpus {
+public:
+    struct RECORD {
+        QString sName;
+        QByteArray baData;
+    };
+
+    static const qint32 N_VERSION = 1;  // Bumped whenever a case changes; reports of different versions are not comparable
+
+    explicit BenchCorpus(quint32 nSeed = 0x5EED1234);
+
+    // Writes every case into sDirectory and returns the file names
+    QStringList create(const QString &sDirectory);
+    // Containers whose head also looks like plain text; triage must send each of them deep
+    QList<RECORD> createTriageFixtures();
+
+    static QByteArray createZip(const QList<RECORD> &listRecords, bool bDeflate);
+    static QByteArray compressDeflate(const QByteArray &baData);
+    static QByteArray compressGzip(const QByteArray &baData);
+    static QByteArray compressBzip2(const QByteArray &baData);
+
+private:
+    quint32 random();
+    QByteArray createText(qint32 nSize);
+    QByteArray createRandom(qint32 nSize);
+    QList<RECORD> createRecords(qint32 nNumberOfRecords, qint32 nRecordSize);
+    static bool writeFile(const QString &sFileName, const QByteArray &baData);
+
+    quint32 m_nState;
+};
+
+#endif  // BENCHCORPUS_H
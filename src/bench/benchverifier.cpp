@@ -0,0 +1,210 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "benchverifier.h"
+
+#include <algorithm>
+
+namespace {
+
+QString scanResultToString(const XScanEngine::SCAN_RESULT &scanResult)
+{
+    QStringList listRecords;
+
+    qint32 nNumberOfRecords = scanResult.listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const XScanEngine::SCANSTRUCT &scanStruct = scanResult.listRecords.at(i);
+
+        listRecords.append(QStringLiteral("%1: %2(%3)[%4]").arg(scanStruct.sType, scanStruct.sName, scanStruct.sVersion, scanStruct.sInfo));
+    }
+
+    return listRecords.join(QStringLiteral("; "));
+}
+
+}  // namespace
+
+BenchVerifier::PIPELINE BenchVerifier::getReferencePipeline()
+{
+    PIPELINE result = {};
+    result.nNumberOfWorkers = 1;
+
+    return result;
+}
+
+BenchVerifier::RUN BenchVerifier::run(const QList<BatchScheduler::ITEM> &listItems, const UnpackEngine::OPTIONS &options, const PIPELINE &pipeline,
+                                      const QString &sOutputDirectory)
+{
+    RUN result = {};
+    result.bIsValid = true;
+
+    QDir(sOutputDirectory).removeRecursively();
+
+    QThreadPool decodePool;
+    decodePool.setMaxThreadCount(qMax(1, pipeline.nNumberOfDecodeThreads));
+
+    QScopedPointer<AsyncWriter> pAsyncWriter;
+
+    if (pipeline.nNumberOfWriters > 0) {
+        pAsyncWriter.reset(new AsyncWriter(pipeline.nNumberOfWriters));
+    }
+
+    UnpackEngine::OPTIONS _options = options;
+    _options.bMemoryMap = pipeline.bMemoryMap;
+    _options.pMemoryBudget = nullptr;
+    _options.pDecodePool = (pipeline.nNumberOfDecodeThreads > 0) ? &decodePool : nullptr;
+    _options.pAsyncWriter = pAsyncWriter.data();
+
+    qint32 nNumberOfWorkers = qMax(1, pipeline.nNumberOfWorkers);
+
+    QVector<UnpackEngine *> listEngines;
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        listEngines.append(new UnpackEngine);
+    }
+
+    QMutex mutex;
+
+    BatchScheduler scheduler;
+    scheduler.setItems(listItems);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    scheduler.process(nNumberOfWorkers, [&](qint32 nWorker, const BatchScheduler::ITEM &item) {
+        UnpackEngine::RESULT fileResult =
+            listEngines.at(nWorker)->processFile(item.sFileName, sOutputDirectory + QDir::separator() + item.sRelativeName, _options);
+        QString sResult = resultToString(fileResult, sOutputDirectory);
+
+        QMutexLocker locker(&mutex);
+        result.mapResults.insert(item.sRelativeName, sResult);
+
+        if (fileResult.status != UnpackEngine::STATUS_OK) {
+            result.bIsValid = false;
+        }
+    });
+
+    // Timed until the last file is on disk
+    if (pAsyncWriter) {
+        pAsyncWriter->waitForDone();
+
+        if (!pAsyncWriter->takeFailedFiles().isEmpty()) {
+            result.bIsValid = false;
+        }
+    }
+
+    result.nTime = timer.nsecsElapsed();
+
+    qDeleteAll(listEngines);
+
+    result.mapTree = hashTree(sOutputDirectory);
+
+    return result;
+}
+
+QStringList BenchVerifier::compare(const RUN &reference, const RUN &optimized, qint32 nMaxDifferences)
+{
+    QStringList listResult;
+
+    QMapIterator<QString, QString> itResults(reference.mapResults);
+
+    while (itResults.hasNext() && (listResult.count() < nMaxDifferences)) {
+        itResults.next();
+
+        if (!optimized.mapResults.contains(itResults.key())) {
+            listResult.append(QStringLiteral("result missing: %1").arg(itResults.key()));
+        } else if (optimized.mapResults.value(itResults.key()) != itResults.value()) {
+            listResult.append(QStringLiteral("result differs: %1\n  reference: %2\n  optimized: %3")
+                                  .arg(itResults.key(), itResults.value(), optimized.mapResults.value(itResults.key())));
+        }
+    }
+
+    QMapIterator<QString, QByteArray> itTree(reference.mapTree);
+
+    while (itTree.hasNext() && (listResult.count() < nMaxDifferences)) {
+        itTree.next();
+
+        if (!optimized.mapTree.contains(itTree.key())) {
+            listResult.append(QStringLiteral("file missing: %1").arg(itTree.key()));
+        } else if (optimized.mapTree.value(itTree.key()) != itTree.value()) {
+            listResult.append(QStringLiteral("file differs: %1").arg(itTree.key()));
+        }
+    }
+
+    QMapIterator<QString, QByteArray> itExtra(optimized.mapTree);
+
+    while (itExtra.hasNext() && (listResult.count() < nMaxDifferences)) {
+        itExtra.next();
+
+        if (!reference.mapTree.contains(itExtra.key())) {
+            listResult.append(QStringLiteral("file extra: %1").arg(itExtra.key()));
+        }
+    }
+
+    return listResult;
+}
+
+QString BenchVerifier::resultToString(const UnpackEngine::RESULT &result, const QString &sOutputDirectory)
+{
+    QStringList listEntries;
+
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        const UnpackEngine::ENTRY &entry = result.listEntries.at(i);
+
+        // Error messages may name output files
+        QString sErrorString = entry.sErrorString;
+        sErrorString.replace(sOutputDirectory, QStringLiteral("<output>"));
+
+        listEntries.append(QStringLiteral("%1|%2|%3|%4|%5|%6")
+                               .arg(entry.sPath, QString::number(entry.nLevel), entry.sFileType, QString::number(entry.bIsValid), sErrorString,
+                                    scanResultToString(entry.scanResult)));
+    }
+
+    std::sort(listEntries.begin(), listEntries.end());
+
+    return QStringLiteral("%1|%2|%3|%4\n%5")
+        .arg(UnpackEngine::statusToString(result.status), result.sFileType, QString::number(result.nNumberOfEntries), scanResultToString(result.scanResult),
+             listEntries.join(QLatin1Char('\n')));
+}
+
+QMap<QString, QByteArray> BenchVerifier::hashTree(const QString &sDirectory)
+{
+    QMap<QString, QByteArray> mapResult;
+
+    QDir dir(sDirectory);
+    QDirIterator it(sDirectory, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        QString sFileName = it.next();
+
+        QFile file(sFileName);
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+
+        if (file.open(QIODevice::ReadOnly) && hash.addData(&file)) {
+            mapResult.insert(dir.relativeFilePath(sFileName), hash.result());
+        } else {
+            mapResult.insert(dir.relativeFilePath(sFileName), QByteArray());
+        }
+    }
+
+    return mapResult;
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BENCHVERIFIER_H
+#define BENCHVERIFIER_H
+
+#include <QCryptographicHash>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+
+#include "batchscheduler.h"
+#include "unpackengine.h"
+
+// Runs the corpus through the reference pipeline (one worker, buffered reads, sequential
+// decoding and writing) and through the optimized one, then compares the extracted trees
+// by SHA-1 and the detections entry by entry. Neither pipeline gets a memory budget; what
+// it skips depends on timing and would differ between them.
+class BenchVerifier {
+public:
+    struct PIPELINE {
+        qint32 nNumberOfWorkers;
+        qint32 nNumberOfDecodeThreads;  // 0: sequential
+        qint32 nNumberOfWriters;        // 0: written by the workers
+        bool bMemoryMap;
+    };
+
+    struct RUN {
+        QMap<QString, QByteArray> mapTree;  // Path under the output directory -> SHA-1
+        QMap<QString, QString> mapResults;  // Input -> canonical result
+        qint64 nTime;                       // ns
+        bool bIsValid;
+    };
+
+    static PIPELINE getReferencePipeline();
+    static RUN run(const QList<BatchScheduler::ITEM> &listItems, const UnpackEngine::OPTIONS &options, const PIPELINE &pipeline, const QString &sOutputDirectory);
+    // Human-readable differences, at most nMaxDifferences; empty: identical
+    static QStringList compare(const RUN &reference, const RUN &optimized, qint32 nMaxDifferences);
+
+private:
+    // Entries sorted by path, so the order in which workers finished does not matter
+    static QString resultToString(const UnpackEngine::RESULT &result, const QString &sOutputDirectory);
+    static QMap<QString, QByteArray> hashTree(const QString &sDirectory);
+};
+
+#endif  // BENCHVERIFIER_H
@@ -0,0 +1,430 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef USE_ARCHIVE
+#define USE_ARCHIVE
+#endif
+#ifndef USE_DEX
+#define USE_DEX
+#endif
+#ifndef USE_PDF
+#define USE_PDF
+#endif
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include <cstdio>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "../global.h"
+#include "batchscheduler.h"
+#include "benchcorpus.h"
+#include "benchverifier.h"
+#include "formattriage.h"
+#include "unpackengine.h"
+
+namespace {
+
+const qint32 N_MAX_DIFFERENCES = 100;  // Reported by --verify
+
+struct CASE_RESULT {
+    qint64 nInputSize;
+    qint64 nOutputSize;
+    qint64 nNumberOfFiles;
+    qint64 nBestTime;
+    qint64 nTotalTime;
+    qint64 nStageTime[UnpackProfiler::__STAGE_SIZE];
+    qint64 nPeakRSSBefore;  // Process high-water mark when the case started
+    bool bIsValid;
+};
+
+qint64 getPeakRSS()
+{
+    qint64 nResult = 0;
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS pmc = {};
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        nResult = (qint64)pmc.PeakWorkingSetSize;
+    }
+#else
+    struct rusage usage = {};
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef Q_OS_MACOS
+        nResult = (qint64)usage.ru_maxrss;
+#else
+        nResult = (qint64)usage.ru_maxrss * 1024;
+#endif
+    }
+#endif
+    return nResult;
+}
+
+void addResult(CASE_RESULT *pCaseResult, const UnpackEngine::RESULT &result)
+{
+    pCaseResult->nInputSize += result.nSize;
+    pCaseResult->nNumberOfFiles += 1 + result.listEntries.count();
+
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        pCaseResult->nOutputSize += qMax(result.listEntries.at(i).nUncompressedSize, (qint64)0);
+    }
+
+    for (qint32 i = 0; i < UnpackProfiler::__STAGE_SIZE; i++) {
+        pCaseResult->nStageTime[i] += result.profile.stages[i].nWallTime;
+    }
+
+    if (result.status != UnpackEngine::STATUS_OK) {
+        pCaseResult->bIsValid = false;
+    }
+}
+
+QJsonObject caseResultToJson(const QString &sName, const CASE_RESULT &caseResult, qint32 nNumberOfIterations)
+{
+    double dBestSeconds = (double)caseResult.nBestTime / 1e9;
+    double dInputMB = (double)caseResult.nInputSize / nNumberOfIterations / (1024.0 * 1024.0);
+    double dOutputMB = (double)caseResult.nOutputSize / nNumberOfIterations / (1024.0 * 1024.0);
+    double dFiles = (double)caseResult.nNumberOfFiles / nNumberOfIterations;
+
+    QJsonObject jsStages;
+
+    for (qint32 i = 0; i < UnpackProfiler::__STAGE_SIZE; i++) {
+        jsStages.insert(UnpackProfiler::stageToString((UnpackProfiler::STAGE)i), (double)caseResult.nStageTime[i] / nNumberOfIterations / 1e9);
+    }
+
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("name"), sName);
+    jsResult.insert(QStringLiteral("valid"), caseResult.bIsValid);
+    jsResult.insert(QStringLiteral("input_bytes"), dInputMB * 1024.0 * 1024.0);
+    jsResult.insert(QStringLiteral("output_bytes"), dOutputMB * 1024.0 * 1024.0);
+    jsResult.insert(QStringLiteral("files"), dFiles);
+    jsResult.insert(QStringLiteral("seconds_best"), dBestSeconds);
+    jsResult.insert(QStringLiteral("seconds_mean"), (double)caseResult.nTotalTime / nNumberOfIterations / 1e9);
+    jsResult.insert(QStringLiteral("input_mb_per_s"), (dBestSeconds > 0) ? (dInputMB / dBestSeconds) : 0.0);
+    jsResult.insert(QStringLiteral("output_mb_per_s"), (dBestSeconds > 0) ? (dOutputMB / dBestSeconds) : 0.0);
+    jsResult.insert(QStringLiteral("files_per_s"), (dBestSeconds > 0) ? (dFiles / dBestSeconds) : 0.0);
+    jsResult.insert(QStringLiteral("stages"), jsStages);
+    // The OS keeps one high-water mark per process: a case only shows by how much it raised it
+    qint64 nPeakRSS = getPeakRSS();
+    jsResult.insert(QStringLiteral("process_peak_rss"), (double)nPeakRSS);
+    jsResult.insert(QStringLiteral("peak_rss_increase"), (double)qMax(nPeakRSS - caseResult.nPeakRSSBefore, (qint64)0));
+
+    return jsResult;
+}
+
+QJsonObject createReport(const UnpackEngine::OPTIONS &options, qint32 nNumberOfIterations)
+{
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("application"), QStringLiteral(X_APPLICATIONDISPLAYNAME));
+    jsResult.insert(QStringLiteral("version"), QStringLiteral(X_APPLICATIONVERSION));
+    jsResult.insert(QStringLiteral("qt"), QString::fromLatin1(qVersion()));
+    jsResult.insert(QStringLiteral("corpus_version"), BenchCorpus::N_VERSION);
+    jsResult.insert(QStringLiteral("iterations"), nNumberOfIterations);
+    jsResult.insert(QStringLiteral("scan"), options.bScan);
+
+    return jsResult;
+}
+
+bool writeReport(const QJsonObject &jsReport, const QString &sFileName)
+{
+    QByteArray baReport = QJsonDocument(jsReport).toJson(QJsonDocument::Indented);
+
+    if (!sFileName.isEmpty()) {
+        QFile file(sFileName);
+
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "Cannot write %s\n", sFileName.toUtf8().constData());
+            return false;
+        }
+
+        file.write(baReport);
+        file.close();
+    } else {
+        std::fwrite(baReport.constData(), 1, (size_t)baReport.size(), stdout);
+    }
+
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication::setOrganizationName(X_ORGANIZATIONNAME);
+    QCoreApplication::setOrganizationDomain(X_ORGANIZATIONDOMAIN);
+    QCoreApplication::setApplicationName(QStringLiteral("xfileunpacker_bench"));
+    QCoreApplication::setApplicationVersion(X_APPLICATIONVERSION);
+
+    QCoreApplication application(argc, argv);
+
+#ifdef USE_XSIMD
+    xsimd_init();
+#endif
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Throughput benchmark of the %1 unpack pipeline").arg(QStringLiteral(X_APPLICATIONDISPLAYNAME)));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption clCorpus(QStringList() << QStringLiteral("corpus"), QStringLiteral("Add the files of <directory> to the synthetic corpus."), QStringLiteral("directory"));
+    QCommandLineOption clIterations(QStringList() << QStringLiteral("iterations"), QStringLiteral("Runs per case (default: 3)."), QStringLiteral("N"));
+    QCommandLineOption clJobs(QStringList() << QStringLiteral("jobs"), QStringLiteral("Workers of the batch case (default: number of cores)."), QStringLiteral("N"));
+    QCommandLineOption clDepth(QStringList() << QStringLiteral("depth"), QStringLiteral("Nesting depth (default: 0, unlimited)."), QStringLiteral("N"));
+    QCommandLineOption clNoScan(QStringList() << QStringLiteral("noscan"), QStringLiteral("Measure unpacking only."));
+    QCommandLineOption clResult(QStringList() << QStringLiteral("result"), QStringLiteral("Write the JSON report to <file> instead of stdout."), QStringLiteral("file"));
+    QCommandLineOption clVerify(QStringList() << QStringLiteral("verify"),
+                                QStringLiteral("Check that --jobs, memory mapping, --decodethreads and --writers produce the same trees and detections as one "
+                                               "sequential worker, and that triage sends known containers deep; exit code 1 on any difference."));
+    QCommandLineOption clDecodeThreads(QStringList() << QStringLiteral("decodethreads"), QStringLiteral("Decode threads of the verified pipeline (default: 4)."),
+                                       QStringLiteral("N"));
+    QCommandLineOption clWriters(QStringList() << QStringLiteral("writers"), QStringLiteral("Writer threads of the verified pipeline (default: 2)."),
+                                 QStringLiteral("N"));
+
+    parser.addOption(clCorpus);
+    parser.addOption(clIterations);
+    parser.addOption(clJobs);
+    parser.addOption(clDepth);
+    parser.addOption(clNoScan);
+    parser.addOption(clResult);
+    parser.addOption(clVerify);
+    parser.addOption(clDecodeThreads);
+    parser.addOption(clWriters);
+
+    parser.process(application);
+
+    qint32 nNumberOfIterations = parser.isSet(clIterations) ? qMax(1, parser.value(clIterations).toInt()) : 3;
+    qint32 nNumberOfWorkers = parser.isSet(clJobs) ? qMax(1, parser.value(clJobs).toInt()) : BatchScheduler::getDefaultNumberOfWorkers();
+
+    QTemporaryDir tempDir;
+
+    if (!tempDir.isValid()) {
+        std::fprintf(stderr, "Cannot create a temporary directory\n");
+        return 1;
+    }
+
+    QStringList listFileNames = BenchCorpus().create(tempDir.path() + QStringLiteral("/corpus"));
+
+    if (parser.isSet(clCorpus)) {
+        QList<BatchScheduler::ITEM> listItems = BatchScheduler::collectItems(QStringList() << parser.value(clCorpus), true);
+
+        qint32 nNumberOfItems = listItems.count();
+
+        for (qint32 i = 0; i < nNumberOfItems; i++) {
+            listFileNames.append(listItems.at(i).sFileName);
+        }
+    }
+
+    UnpackEngine::OPTIONS options = UnpackEngine::getDefaultOptions();
+    options.bScan = !parser.isSet(clNoScan);
+    options.nMaxDepth = parser.isSet(clDepth) ? parser.value(clDepth).toInt() : 0;
+
+    if (parser.isSet(clVerify)) {
+        QList<BatchScheduler::ITEM> listItems = BatchScheduler::collectItems(listFileNames, false);
+
+        BenchVerifier::PIPELINE pipelineReference = BenchVerifier::getReferencePipeline();
+
+        BenchVerifier::PIPELINE pipelineOptimized = {};
+        pipelineOptimized.nNumberOfWorkers = nNumberOfWorkers;
+        pipelineOptimized.nNumberOfDecodeThreads = parser.isSet(clDecodeThreads) ? qMax(0, parser.value(clDecodeThreads).toInt()) : 4;
+        pipelineOptimized.nNumberOfWriters = parser.isSet(clWriters) ? qMax(0, parser.value(clWriters).toInt()) : 2;
+        pipelineOptimized.bMemoryMap = true;
+
+        BenchVerifier::RUN runReference = BenchVerifier::run(listItems, options, pipelineReference, tempDir.path() + QStringLiteral("/reference"));
+
+        qint64 nReferenceTime = runReference.nTime;
+        qint64 nOptimizedTime = -1;
+        bool bIsValid = runReference.bIsValid;
+        QStringList listDifferences;
+
+        // Every run is compared: a race may show up in one of them only
+        for (qint32 i = 0; (i < nNumberOfIterations) && listDifferences.isEmpty(); i++) {
+            if (i > 0) {
+                BenchVerifier::RUN runNext = BenchVerifier::run(listItems, options, pipelineReference, tempDir.path() + QStringLiteral("/reference"));
+                nReferenceTime = qMin(nReferenceTime, runNext.nTime);
+                bIsValid = bIsValid && runNext.bIsValid;
+            }
+
+            BenchVerifier::RUN runOptimized = BenchVerifier::run(listItems, options, pipelineOptimized, tempDir.path() + QStringLiteral("/optimized"));
+
+            if ((nOptimizedTime == -1) || (runOptimized.nTime < nOptimizedTime)) {
+                nOptimizedTime = runOptimized.nTime;
+            }
+
+            bIsValid = bIsValid && runOptimized.bIsValid;
+            listDifferences = BenchVerifier::compare(runReference, runOptimized, N_MAX_DIFFERENCES);
+        }
+
+        // Containers that must never be triaged away, however text-like their head is
+        QList<BenchCorpus::RECORD> listFixtures = BenchCorpus().createTriageFixtures();
+        qint32 nNumberOfFixtures = listFixtures.count();
+
+        for (qint32 i = 0; i < nNumberOfFixtures; i++) {
+            const QByteArray &baData = listFixtures.at(i).baData;
+            qint64 nHeadSize = qMin((qint64)baData.size(), (qint64)FormatTriage::N_HEAD_SIZE);
+            qint64 nTailSize = qMin((qint64)baData.size(), (qint64)FormatTriage::N_TAIL_SIZE);
+
+            FormatTriage::RESULT triage = FormatTriage::classify(baData.constData(), nHeadSize, baData.constData() + baData.size() - nTailSize, nTailSize,
+                                                                 baData.size(), nullptr);
+
+            if (triage.verdict != FormatTriage::VERDICT_DEEP) {
+                listDifferences.append(QString("Triage does not go deep: %1").arg(listFixtures.at(i).sName));
+            }
+        }
+
+        QJsonObject jsVerify;
+        jsVerify.insert(QStringLiteral("valid"), bIsValid);
+        jsVerify.insert(QStringLiteral("identical"), listDifferences.isEmpty());
+        jsVerify.insert(QStringLiteral("inputs"), runReference.mapResults.count());
+        jsVerify.insert(QStringLiteral("files"), runReference.mapTree.count());
+        jsVerify.insert(QStringLiteral("jobs"), pipelineOptimized.nNumberOfWorkers);
+        jsVerify.insert(QStringLiteral("decodethreads"), pipelineOptimized.nNumberOfDecodeThreads);
+        jsVerify.insert(QStringLiteral("writers"), pipelineOptimized.nNumberOfWriters);
+        jsVerify.insert(QStringLiteral("reference_seconds"), (double)nReferenceTime / 1e9);
+        jsVerify.insert(QStringLiteral("optimized_seconds"), (double)nOptimizedTime / 1e9);
+        jsVerify.insert(QStringLiteral("speedup"), (nOptimizedTime > 0) ? ((double)nReferenceTime / nOptimizedTime) : 0.0);
+        jsVerify.insert(QStringLiteral("differences"), QJsonArray::fromStringList(listDifferences));
+
+        QJsonObject jsRoot = createReport(options, nNumberOfIterations);
+        jsRoot.insert(QStringLiteral("verify"), jsVerify);
+
+        for (qint32 i = 0; i < listDifferences.count(); i++) {
+            std::fprintf(stderr, "%s\n", listDifferences.at(i).toUtf8().constData());
+        }
+
+        if (!bIsValid) {
+            std::fprintf(stderr, "An input failed or a write was lost in one of the runs\n");
+        }
+
+        if (!writeReport(jsRoot, parser.value(clResult))) {
+            return 1;
+        }
+
+        // Two runs that both failed can still be identical
+        return (bIsValid && listDifferences.isEmpty()) ? 0 : 1;
+    }
+
+    QString sOutputDirectory = tempDir.path() + QStringLiteral("/output");
+    qint64 nBaselineRSS = getPeakRSS();
+
+    QJsonArray jsCases;
+    UnpackEngine engine;
+
+    qint32 nNumberOfFiles = listFileNames.count();
+
+    for (qint32 i = 0; i < nNumberOfFiles; i++) {
+        CASE_RESULT caseResult = {};
+        caseResult.nPeakRSSBefore = getPeakRSS();
+        caseResult.bIsValid = true;
+        caseResult.nBestTime = -1;
+
+        for (qint32 j = 0; j < nNumberOfIterations; j++) {
+            QDir(sOutputDirectory).removeRecursively();
+
+            QElapsedTimer timer;
+            timer.start();
+
+            UnpackEngine::RESULT result = engine.processFile(listFileNames.at(i), sOutputDirectory, options);
+
+            qint64 nTime = timer.nsecsElapsed();
+
+            addResult(&caseResult, result);
+            caseResult.nTotalTime += nTime;
+
+            if ((caseResult.nBestTime == -1) || (nTime < caseResult.nBestTime)) {
+                caseResult.nBestTime = nTime;
+            }
+        }
+
+        jsCases.append(caseResultToJson(QFileInfo(listFileNames.at(i)).fileName(), caseResult, nNumberOfIterations));
+    }
+
+    // Whole corpus through the batch scheduler
+    {
+        CASE_RESULT caseResult = {};
+        caseResult.nPeakRSSBefore = getPeakRSS();
+        caseResult.bIsValid = true;
+        caseResult.nBestTime = -1;
+
+        QList<BatchScheduler::ITEM> listItems = BatchScheduler::collectItems(listFileNames, false);
+
+        QVector<UnpackEngine *> listEngines;
+
+        for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+            listEngines.append(new UnpackEngine);
+        }
+
+        QMutex mutex;
+
+        for (qint32 j = 0; j < nNumberOfIterations; j++) {
+            QDir(sOutputDirectory).removeRecursively();
+
+            BatchScheduler scheduler;
+            scheduler.setItems(listItems);
+
+            QElapsedTimer timer;
+            timer.start();
+
+            scheduler.process(nNumberOfWorkers, [&](qint32 nWorker, const BatchScheduler::ITEM &item) {
+                UnpackEngine::RESULT result = listEngines.at(nWorker)->processFile(item.sFileName, sOutputDirectory + QDir::separator() + item.sRelativeName, options);
+
+                QMutexLocker locker(&mutex);
+                addResult(&caseResult, result);
+            });
+
+            qint64 nTime = timer.nsecsElapsed();
+            caseResult.nTotalTime += nTime;
+
+            if ((caseResult.nBestTime == -1) || (nTime < caseResult.nBestTime)) {
+                caseResult.nBestTime = nTime;
+            }
+        }
+
+        qDeleteAll(listEngines);
+
+        QJsonObject jsBatch = caseResultToJson(QStringLiteral("batch"), caseResult, nNumberOfIterations);
+        jsBatch.insert(QStringLiteral("jobs"), nNumberOfWorkers);
+
+        jsCases.append(jsBatch);
+    }
+
+    QJsonObject jsRoot = createReport(options, nNumberOfIterations);
+    jsRoot.insert(QStringLiteral("baseline_rss"), (double)nBaselineRSS);
+    jsRoot.insert(QStringLiteral("process_peak_rss"), (double)getPeakRSS());
+    jsRoot.insert(QStringLiteral("cases"), jsCases);
+
+    if (!writeReport(jsRoot, parser.value(clResult))) {
+        return 1;
+    }
+
+    return 0;
+}
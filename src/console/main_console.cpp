@@ -31,6 +31,7 @@
 #include <QCoreApplication>
 
 #include "../global.h"
+#include "unpackconsole.h"
 #include "xoptions.h"
 #include "xscanengineconsole.h"
 
@@ -66,6 +67,12 @@ int main(int argc, char *argv[])
     xsimd_init();
 #endif
 
+    if (UnpackConsole::isBatchMode(application.arguments())) {
+        UnpackConsole unpackConsole(application, buildDescription());
+
+        return unpackConsole.process();
+    }
+
     XScanEngine scanEngine;
     XScanEngineConsole scanEngineConsole(application, scanEngine, buildDescription());
 
@@ -0,0 +1,907 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackconsole.h"
+
+UnpackConsole::UnpackConsole(QCoreApplication &application, const QString &sDescription, QObject *pParent)
+    : QObject(pParent), m_application(application), m_sDescription(sDescription), m_pTextOutput(stdout), m_nShard(0), m_nNumberOfShards(1)
+{
+}
+
+UnpackConsole::~UnpackConsole()
+{
+    if (!m_sTraceFileName.isEmpty()) {
+        QString sErrorString;
+
+        if (!UnpackTracer::writeChromeTrace(m_sTraceFileName, &sErrorString)) {
+            printString(sErrorString);
+        }
+    }
+}
+
+bool UnpackConsole::isBatchMode(const QStringList &listArguments)
+{
+    bool bResult = false;
+
+    qint32 nNumberOfArguments = listArguments.count();
+
+    for (qint32 i = 1; i < nNumberOfArguments; i++) {
+        const QString sArgument = listArguments.at(i);
+
+        if ((sArgument == QStringLiteral("--batch")) || (sArgument == QStringLiteral("--jobs")) || sArgument.startsWith(QStringLiteral("--jobs=")) ||
+            (sArgument == QStringLiteral("--serve")) || sArgument.startsWith(QStringLiteral("--serve=")) || (sArgument == QStringLiteral("--buildindex")) ||
+            (sArgument == QStringLiteral("--coordinator")) || sArgument.startsWith(QStringLiteral("--coordinator=")) || (sArgument == QStringLiteral("--worker")) ||
+            sArgument.startsWith(QStringLiteral("--worker="))) {
+            bResult = true;
+            break;
+        }
+    }
+
+    return bResult;
+}
+
+int UnpackConsole::process()
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(m_sDescription);
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("target"), tr("The files or directories to process."), QStringLiteral("[target...]"));
+
+    QCommandLineOption clBatch(QStringList() << QStringLiteral("batch"), tr("Batch mode."));
+    QCommandLineOption clJobs(QStringList() << QStringLiteral("jobs"), tr("Number of parallel workers (default: number of cores)."), QStringLiteral("N"));
+    QCommandLineOption clEngines(QStringList() << QStringLiteral("engines"),
+                                 tr("Scan engines shared by the workers; each holds one copy of the signatures (default: one per job)."), QStringLiteral("N"));
+    QCommandLineOption clOutput(QStringList() << QStringLiteral("output"), tr("Extract archive entries to <directory>."), QStringLiteral("directory"));
+    QCommandLineOption clExtract(QStringList() << QStringLiteral("extract"),
+                                 tr("Unpack only entries whose path matches <glob> (e.g. classes*.dex, lib/*/libfoo.so, **/AndroidManifest.xml); repeatable."),
+                                 QStringLiteral("glob"));
+    QCommandLineOption clNoSubdirectories(QStringList() << QStringLiteral("nosubdirs"), tr("Do not walk subdirectories."));
+    QCommandLineOption clDepth(QStringList() << QStringLiteral("depth"), tr("Unpack nested containers up to <N> levels (0: unlimited, default: 1)."), QStringLiteral("N"));
+    QCommandLineOption clMemory(QStringList() << QStringLiteral("memory"), tr("Memory budget for in-flight children in MiB (0: unlimited, default: 512)."),
+                                QStringLiteral("MiB"));
+    QCommandLineOption clSpill(QStringList() << QStringLiteral("spill"),
+                               tr("Decode children that do not fit the --memory budget to files in <directory> and unpack them from there."),
+                               QStringLiteral("directory"));
+    QCommandLineOption clCarve(QStringList() << QStringLiteral("carve"), tr("Extract embedded files from files that are not archives."));
+    QCommandLineOption clNoUnpackPe(QStringList() << QStringLiteral("nounpackpe"), tr("Do not unpack packed executables."));
+    QCommandLineOption clDedup(QStringList() << QStringLiteral("dedup"),
+                               tr("Keep identical children once under <output>/objects and scan them once (manifest.jsonl lists every copy)."));
+    QCommandLineOption clCache(QStringList() << QStringLiteral("cache"), tr("Reuse results stored in <directory>."), QStringLiteral("directory"));
+    QCommandLineOption clCacheSize(QStringList() << QStringLiteral("cachesize"), tr("Cache size limit in MiB (default: 1024)."), QStringLiteral("MiB"));
+    QCommandLineOption clNoMemoryMap(QStringList() << QStringLiteral("nommap"), tr("Read inputs through buffered I/O instead of memory mapping."));
+    QCommandLineOption clNoScan(QStringList() << QStringLiteral("noscan"), tr("Do not run the scan engine."));
+    QCommandLineOption clDecodeThreads(QStringList() << QStringLiteral("decodethreads"),
+                                       tr("Decode archive entries and bzip2 blocks on <N> extra threads (default: 0, sequential)."), QStringLiteral("N"));
+    QCommandLineOption clWriters(QStringList() << QStringLiteral("writers"),
+                                 tr("Write extracted entries on <N> background threads (default: 0, by the workers)."), QStringLiteral("N"));
+    QCommandLineOption clMaxOutput(QStringList() << QStringLiteral("maxoutput"), tr("Stop an input after <MiB> decompressed over all entries (default: unlimited)."),
+                                   QStringLiteral("MiB"));
+    QCommandLineOption clMaxRatio(QStringList() << QStringLiteral("maxratio"), tr("Stop an input when an entry expands more than <N> times (default: unlimited)."),
+                                  QStringLiteral("N"));
+    QCommandLineOption clMaxEntries(QStringList() << QStringLiteral("maxentries"), tr("Stop an input after <N> entries (default: unlimited)."), QStringLiteral("N"));
+    QCommandLineOption clTimeout(QStringList() << QStringLiteral("timeout"), tr("Stop an input after <seconds> (default: unlimited)."), QStringLiteral("seconds"));
+    QCommandLineOption clTriage(QStringList() << QStringLiteral("triage"),
+                                tr("Skip detection, scan and unpacking of files whose head shows plain data (no magic, low entropy)."));
+    QCommandLineOption clPrefilter(QStringList() << QStringLiteral("prefilter"), tr("Skip the scan engine on files where no signature anchor occurs."));
+    QCommandLineOption clSignatures(QStringList() << QStringLiteral("signatures"),
+                                    tr("DiE signature scripts that add prefilter anchors (default: <application>/db)."), QStringLiteral("directory"));
+    QCommandLineOption clSignatureIndex(QStringList() << QStringLiteral("sigindex"),
+                                        tr("Compiled anchor index; rebuilt when the scripts change (default: signatures.idx next to the application)."),
+                                        QStringLiteral("file"));
+    QCommandLineOption clBuildIndex(QStringList() << QStringLiteral("buildindex"), tr("Compile the signature scripts into the anchor index and exit."));
+    QCommandLineOption clRecursiveScan(QStringList() << QStringLiteral("recursivescan"), tr("Recursive scan."));
+    QCommandLineOption clDeepScan(QStringList() << QStringLiteral("deepscan"), tr("Deep scan."));
+    QCommandLineOption clHeuristicScan(QStringList() << QStringLiteral("heuristicscan"), tr("Heuristic scan."));
+    QCommandLineOption clVerbose(QStringList() << QStringLiteral("verbose"), tr("Verbose."));
+    QCommandLineOption clStream(QStringList() << QStringLiteral("stream"), tr("Stream extracted entries as <format> (tar, frames) instead of writing files."),
+                                QStringLiteral("format"));
+    QCommandLineOption clStreamTo(QStringList() << QStringLiteral("streamto"), tr("Stream target: - for stdout (default) or a named pipe."),
+                                  QStringLiteral("target"));
+    QCommandLineOption clRecords(QStringList() << QStringLiteral("records"),
+                                 tr("Write one <format> (jsonl, msgpack) record per entry and per input instead of the text report."), QStringLiteral("format"));
+    QCommandLineOption clRecordsTo(QStringList() << QStringLiteral("recordsto"), tr("Records target: - for stdout (default) or a file."), QStringLiteral("target"));
+    QCommandLineOption clServe(QStringList() << QStringLiteral("serve"), tr("Keep the engines loaded and take jobs on local socket <name> (JSON Lines)."),
+                               QStringLiteral("name"));
+    QCommandLineOption clShard(QStringList() << QStringLiteral("shard"),
+                               tr("Process only shard <i> of <N> (1 <= i <= N); inputs are assigned by a consistent hash of their relative name."),
+                               QStringLiteral("i/N"));
+    QCommandLineOption clCoordinator(QStringList() << QStringLiteral("coordinator"),
+                                     tr("Hand the targets to --worker nodes that connect on TCP <port>, on localhost unless an address is given."),
+                                     QStringLiteral("[address:]port"));
+    QCommandLineOption clWorker(QStringList() << QStringLiteral("worker"), tr("Take jobs from the coordinator at <host:port> with --jobs workers."),
+                                QStringLiteral("host:port"));
+    QCommandLineOption clToken(QStringList() << QStringLiteral("token"), tr("Shared secret a --worker must present to the --coordinator."),
+                               QStringLiteral("secret"));
+    QCommandLineOption clIncremental(QStringList() << QStringLiteral("incremental"),
+                                     tr("Process only files that are new or changed since the last run recorded in <file>."), QStringLiteral("file"));
+    QCommandLineOption clWatch(QStringList() << QStringLiteral("watch"), tr("Keep running and process changes as they appear (needs --incremental)."));
+    QCommandLineOption clJournal(QStringList() << QStringLiteral("journal"),
+                                 tr("Record finished inputs and written entry files in <file> as the batch goes."), QStringLiteral("file"));
+    QCommandLineOption clResume(QStringList() << QStringLiteral("resume"),
+                                tr("Continue the run recorded by --journal: skip finished inputs, read written entries back instead of decoding them."));
+    QCommandLineOption clProfile(QStringList() << QStringLiteral("profile"), tr("Write per-file stage timings and counters to <file> (JSON Lines)."),
+                                 QStringLiteral("file"));
+    QCommandLineOption clTrace(QStringList() << QStringLiteral("trace"),
+                               tr("Write a timeline of every stage on every thread to <file> (Chrome trace JSON; needs a USE_TRACE build)."),
+                               QStringLiteral("file"));
+
+    parser.addOption(clBatch);
+    parser.addOption(clJobs);
+    parser.addOption(clEngines);
+    parser.addOption(clOutput);
+    parser.addOption(clExtract);
+    parser.addOption(clNoSubdirectories);
+    parser.addOption(clDepth);
+    parser.addOption(clMemory);
+    parser.addOption(clSpill);
+    parser.addOption(clCarve);
+    parser.addOption(clNoUnpackPe);
+    parser.addOption(clDedup);
+    parser.addOption(clCache);
+    parser.addOption(clCacheSize);
+    parser.addOption(clNoMemoryMap);
+    parser.addOption(clNoScan);
+    parser.addOption(clDecodeThreads);
+    parser.addOption(clWriters);
+    parser.addOption(clMaxOutput);
+    parser.addOption(clMaxRatio);
+    parser.addOption(clMaxEntries);
+    parser.addOption(clTimeout);
+    parser.addOption(clTriage);
+    parser.addOption(clPrefilter);
+    parser.addOption(clSignatures);
+    parser.addOption(clSignatureIndex);
+    parser.addOption(clBuildIndex);
+    parser.addOption(clRecursiveScan);
+    parser.addOption(clDeepScan);
+    parser.addOption(clHeuristicScan);
+    parser.addOption(clVerbose);
+    parser.addOption(clStream);
+    parser.addOption(clStreamTo);
+    parser.addOption(clRecords);
+    parser.addOption(clRecordsTo);
+    parser.addOption(clServe);
+    parser.addOption(clShard);
+    parser.addOption(clCoordinator);
+    parser.addOption(clWorker);
+    parser.addOption(clToken);
+    parser.addOption(clIncremental);
+    parser.addOption(clWatch);
+    parser.addOption(clJournal);
+    parser.addOption(clResume);
+    parser.addOption(clProfile);
+    parser.addOption(clTrace);
+
+    parser.process(m_application);
+
+    QString sSignatureDirectory = parser.isSet(clSignatures) ? parser.value(clSignatures) : (QCoreApplication::applicationDirPath() + QStringLiteral("/db"));
+    QString sSignatureIndex = parser.isSet(clSignatureIndex) ? parser.value(clSignatureIndex) : getDefaultSignatureIndex();
+
+    if (parser.isSet(clBuildIndex)) {
+        SignatureIndex::STAMP stamp = SignatureIndex::getSourceStamp(sSignatureDirectory);
+        QList<SignaturePrefilter::ANCHOR> listAnchors = SignatureIndex::compileDirectory(sSignatureDirectory);
+
+        if ((stamp.nNumberOfFiles == 0) || (!SignatureIndex::write(sSignatureIndex, stamp, listAnchors))) {
+            printString(tr("Cannot build %1 from %2").arg(sSignatureIndex, sSignatureDirectory));
+            return 1;
+        }
+
+        printString(tr("%1: %2 anchors from %3 scripts").arg(sSignatureIndex, QString::number(listAnchors.count()), QString::number(stamp.nNumberOfFiles)));
+
+        return 0;
+    }
+
+    QStringList listTargets = parser.positionalArguments();
+
+    if (listTargets.isEmpty() && (!parser.isSet(clServe)) && (!parser.isSet(clWorker))) {
+        parser.showHelp(1);
+    }
+
+    if (parser.isSet(clWorker) && (parser.isSet(clCoordinator) || parser.isSet(clServe) || parser.isSet(clRecords) || parser.isSet(clStream) ||
+                                   parser.isSet(clIncremental))) {
+        printString(tr("--worker cannot be combined with --coordinator, --serve, --records, --stream or --incremental"));
+        return 1;
+    }
+
+    if (parser.isSet(clCoordinator) && (parser.isSet(clServe) || parser.isSet(clStream) || parser.isSet(clWatch) || parser.isSet(clProfile))) {
+        printString(tr("--coordinator cannot be combined with --serve, --stream, --watch or --profile"));
+        return 1;
+    }
+
+    if (parser.isSet(clTrace)) {
+#ifdef USE_TRACE
+        // Written when the console goes away, after every mode has returned
+        m_sTraceFileName = parser.value(clTrace);
+        UnpackTracer::start();
+#else
+        printString(tr("--trace needs a build configured with -DUSE_TRACE=ON"));
+        return 1;
+#endif
+    }
+
+    if (parser.isSet(clResume) && (!parser.isSet(clJournal))) {
+        printString(tr("--resume needs --journal"));
+        return 1;
+    }
+
+    if (parser.isSet(clJournal) && (parser.isSet(clServe) || parser.isSet(clStream) || (parser.value(clWriters).toInt() > 0))) {
+        printString(tr("--journal cannot be combined with --serve, --stream or --writers"));
+        return 1;
+    }
+
+    if (parser.isSet(clShard)) {
+        QStringList listParts = parser.value(clShard).split(QLatin1Char('/'));
+        bool bValid = (listParts.count() == 2);
+
+        if (bValid) {
+            bool bValidShard = false;
+            bool bValidNumber = false;
+            m_nShard = listParts.at(0).toInt(&bValidShard) - 1;
+            m_nNumberOfShards = listParts.at(1).toInt(&bValidNumber);
+
+            bValid = bValidShard && bValidNumber && (m_nNumberOfShards >= 1) && (m_nShard >= 0) && (m_nShard < m_nNumberOfShards);
+        }
+
+        if (!bValid) {
+            printString(tr("Invalid shard: %1 (expected i/N with 1 <= i <= N)").arg(parser.value(clShard)));
+            return 1;
+        }
+    }
+
+    qint32 nNumberOfWorkers = BatchScheduler::getDefaultNumberOfWorkers();
+
+    if (parser.isSet(clJobs)) {
+        bool bValid = false;
+        nNumberOfWorkers = parser.value(clJobs).toInt(&bValid);
+
+        if ((!bValid) || (nNumberOfWorkers < 1)) {
+            printString(tr("Invalid number of jobs: %1").arg(parser.value(clJobs)));
+            return 1;
+        }
+    }
+
+    qint32 nNumberOfEngines = nNumberOfWorkers;
+
+    if (parser.isSet(clEngines)) {
+        bool bValid = false;
+        nNumberOfEngines = parser.value(clEngines).toInt(&bValid);
+
+        if ((!bValid) || (nNumberOfEngines < 1)) {
+            printString(tr("Invalid number of engines: %1").arg(parser.value(clEngines)));
+            return 1;
+        }
+    }
+
+    // Created on demand: a run with --noscan or a warm cache loads no signatures at all; --serve and --worker warm it up
+    ScanEnginePool scanEnginePool(qMin(nNumberOfEngines, nNumberOfWorkers));
+
+    MemoryBudget memoryBudget(512 * 1024 * 1024LL);
+
+    if (parser.isSet(clMemory)) {
+        memoryBudget.setLimit(parser.value(clMemory).toLongLong() * 1024 * 1024);
+    }
+
+    // Not the system temp directory by default: that is often tmpfs, which is RAM again
+    QString sSpillDirectory;
+
+    if (parser.isSet(clSpill)) {
+        sSpillDirectory = QFileInfo(parser.value(clSpill)).absoluteFilePath();
+
+        if (!QDir().mkpath(sSpillDirectory)) {
+            printString(tr("Cannot create directory: %1").arg(sSpillDirectory));
+            return 1;
+        }
+    }
+
+    QScopedPointer<ResultCache> pResultCache;
+
+    if (parser.isSet(clCache)) {
+        qint64 nCacheLimit = 1024 * 1024 * 1024LL;
+
+        if (parser.isSet(clCacheSize)) {
+            nCacheLimit = parser.value(clCacheSize).toLongLong() * 1024 * 1024;
+        }
+
+        pResultCache.reset(new ResultCache(QDir(parser.value(clCache)).absolutePath(), nCacheLimit));
+    }
+
+    QScopedPointer<OutputSink> pOutputSink;
+
+    if (parser.isSet(clServe) && parser.isSet(clStream)) {
+        printString(tr("--serve cannot be combined with --stream"));
+        return 1;
+    }
+
+    if (parser.isSet(clStream)) {
+        OutputSink::FORMAT format = OutputSink::stringToFormat(parser.value(clStream));
+
+        if (format == OutputSink::FORMAT_UNKNOWN) {
+            printString(tr("Invalid stream format: %1").arg(parser.value(clStream)));
+            return 1;
+        }
+
+        if (parser.isSet(clOutput) || parser.isSet(clCache)) {
+            printString(tr("--stream cannot be combined with --output or --cache"));
+            return 1;
+        }
+
+        QString sTarget = parser.isSet(clStreamTo) ? parser.value(clStreamTo) : QStringLiteral("-");
+
+        if (sTarget == QStringLiteral("-")) {
+            m_pTextOutput = stderr;
+        }
+
+        QString sErrorString;
+        pOutputSink.reset(OutputSink::create(format, sTarget, &sErrorString));
+
+        if (!pOutputSink) {
+            printString(sErrorString);
+            return 1;
+        }
+    }
+
+    QScopedPointer<ResultWriter> pResultWriter;
+
+    if (parser.isSet(clRecords)) {
+        ResultWriter::FORMAT format = ResultWriter::stringToFormat(parser.value(clRecords));
+
+        if (format == ResultWriter::FORMAT_UNKNOWN) {
+            printString(tr("Invalid record format: %1").arg(parser.value(clRecords)));
+            return 1;
+        }
+
+        QString sTarget = parser.isSet(clRecordsTo) ? parser.value(clRecordsTo) : QStringLiteral("-");
+
+        if ((sTarget == QStringLiteral("-")) && (m_pTextOutput == stderr)) {
+            printString(tr("--records and --stream cannot both write to stdout"));
+            return 1;
+        }
+
+        if (parser.isSet(clServe)) {
+            printString(tr("--serve cannot be combined with --records"));
+            return 1;
+        }
+
+        if (sTarget == QStringLiteral("-")) {
+            m_pTextOutput = stderr;
+        }
+
+        QString sErrorString;
+        // Resumed: the records of the finished inputs are kept
+        pResultWriter.reset(ResultWriter::create(format, sTarget, &sErrorString, parser.isSet(clResume)));
+
+        if (!pResultWriter) {
+            printString(sErrorString);
+            return 1;
+        }
+    }
+
+    if (parser.isSet(clDedup) && (parser.isSet(clStream) || parser.isSet(clCache) || parser.isSet(clServe))) {
+        printString(tr("--dedup cannot be combined with --stream, --cache or --serve"));
+        return 1;
+    }
+
+    QScopedPointer<DedupStore> pDedupStore;
+
+    if (parser.isSet(clDedup)) {
+        pDedupStore.reset(new DedupStore(parser.isSet(clOutput) ? QDir(parser.value(clOutput)).absolutePath() : QString()));
+    }
+
+    SignaturePrefilter prefilter;
+
+    if (parser.isSet(clPrefilter)) {
+        QList<SignaturePrefilter::ANCHOR> listAnchors = SignaturePrefilter::getDefaultAnchors();
+        listAnchors.append(SignatureIndex::load(sSignatureIndex, sSignatureDirectory));
+
+        prefilter.setAnchors(listAnchors);
+    }
+
+    QThreadPool decodePool;
+    qint32 nNumberOfDecodeThreads = parser.value(clDecodeThreads).toInt();
+
+    if (nNumberOfDecodeThreads > 0) {
+        decodePool.setMaxThreadCount(nNumberOfDecodeThreads);
+    }
+
+    QScopedPointer<AsyncWriter> pAsyncWriter;
+    qint32 nNumberOfWriters = parser.value(clWriters).toInt();
+
+    // A worker reports a file as soon as it is processed, so the writes must be done by then
+    if ((nNumberOfWriters > 0) && parser.isSet(clOutput) && (!parser.isSet(clServe)) && (!parser.isSet(clWorker))) {
+        pAsyncWriter.reset(new AsyncWriter(nNumberOfWriters));
+    }
+
+    // One malloc arena per thread that allocates; glibc would otherwise grow up to 8 per core
+    BufferPool::limitHeapArenas(1 + nNumberOfWorkers + qMax(0, nNumberOfDecodeThreads) + qMax(0, nNumberOfWriters));
+
+    BatchJournal journal;
+
+    if (parser.isSet(clJournal)) {
+        if (!journal.open(parser.value(clJournal), parser.isSet(clResume))) {
+            printString(tr("Cannot open journal: %1").arg(parser.value(clJournal)));
+            return 1;
+        }
+
+        if (parser.isSet(clResume)) {
+            printString(tr("Resuming: %1 inputs finished, %2 entry files written")
+                            .arg(QString::number(journal.getNumberOfFinished()), QString::number(journal.getNumberOfOutputs())));
+        }
+    }
+
+    UnpackEngine::OPTIONS options = UnpackEngine::getDefaultOptions();
+    options.bScan = !parser.isSet(clNoScan);
+    options.bExtract = parser.isSet(clOutput) || parser.isSet(clDepth) || parser.isSet(clStream) || parser.isSet(clExtract);
+    options.bCarve = parser.isSet(clCarve);
+    options.bUnpackExecutables = !parser.isSet(clNoUnpackPe);
+    options.bMemoryMap = !parser.isSet(clNoMemoryMap);
+    options.bTriage = parser.isSet(clTriage);
+    options.pMemoryBudget = &memoryBudget;
+    options.sSpillDirectory = sSpillDirectory;
+    options.pResultCache = pResultCache.data();
+    options.pOutputSink = pOutputSink.data();
+    options.pPrefilter = parser.isSet(clPrefilter) ? &prefilter : nullptr;
+    options.pScanEnginePool = &scanEnginePool;
+    options.pDecodePool = (nNumberOfDecodeThreads > 0) ? &decodePool : nullptr;
+    options.pDedupStore = pDedupStore.data();
+    options.pAsyncWriter = pAsyncWriter.data();
+    options.pResultWriter = pResultWriter.data();
+    options.pJournal = parser.isSet(clJournal) ? &journal : nullptr;
+
+    if (pResultCache) {
+        // Cached detections are only as current as the database that made them
+        SignatureIndex::STAMP stamp = SignatureIndex::getSourceStamp(sSignatureDirectory);
+        options.sSignatureStamp =
+            QStringLiteral("%1/%2/%3").arg(QString::number(stamp.nNumberOfFiles), QString::number(stamp.nTotalSize), QString::number(stamp.nLatestModified));
+    }
+
+    EntryFilter entryFilter;
+
+    if (parser.isSet(clExtract)) {
+        entryFilter.setPatterns(parser.values(clExtract));
+
+        // The patterns decide how deep to go
+        options.pEntryFilter = &entryFilter;
+        options.nMaxDepth = 0;
+    }
+
+    if (parser.isSet(clDepth)) {
+        options.nMaxDepth = parser.value(clDepth).toInt();
+    }
+
+    options.limits.nMaxOutputSize = qMax(0LL, parser.value(clMaxOutput).toLongLong()) * 1024 * 1024;
+    options.limits.nMaxRatio = qMax(0LL, parser.value(clMaxRatio).toLongLong());
+    options.limits.nMaxEntries = qMax(0, parser.value(clMaxEntries).toInt());
+    options.limits.nMaxTime = qMax(0LL, parser.value(clTimeout).toLongLong()) * 1000;
+
+    options.scanOptions.bIsRecursiveScan = parser.isSet(clRecursiveScan);
+    options.scanOptions.bIsDeepScan = parser.isSet(clDeepScan);
+    options.scanOptions.bIsHeuristicScan = parser.isSet(clHeuristicScan);
+    options.scanOptions.bIsVerbose = parser.isSet(clVerbose);
+
+    QString sOutputDirectory;
+
+    if (parser.isSet(clOutput)) {
+        sOutputDirectory = QDir(parser.value(clOutput)).absolutePath();
+    }
+
+    if ((parser.isSet(clServe) || parser.isSet(clWorker)) && options.bScan) {
+        // Long-lived: the databases are loaded before the first job arrives, not on it
+        scanEnginePool.warmUp();
+    }
+
+    if (parser.isSet(clServe)) {
+        UnpackServer server(options, nNumberOfWorkers);
+
+        if (!server.listen(parser.value(clServe))) {
+            printString(tr("Cannot listen on %1: %2").arg(parser.value(clServe), server.getErrorString()));
+            return 1;
+        }
+
+        connect(&server, SIGNAL(shutdownRequested()), &m_application, SLOT(quit()), Qt::QueuedConnection);
+
+        printString(tr("Listening on %1").arg(parser.value(clServe)));
+
+        return m_application.exec();
+    }
+
+    if (parser.isSet(clProfile)) {
+        m_fileProfile.setFileName(parser.value(clProfile));
+
+        if (!m_fileProfile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            printString(tr("Cannot create file: %1").arg(parser.value(clProfile)));
+            return 1;
+        }
+    }
+
+    bool bRecursive = !parser.isSet(clNoSubdirectories);
+
+    if (parser.isSet(clWatch) && ((!parser.isSet(clIncremental)) || parser.isSet(clStream))) {
+        printString(tr("--watch needs --incremental and cannot be combined with --stream"));
+        return 1;
+    }
+
+    FileStateIndex fileStateIndex;
+
+    if (parser.isSet(clIncremental)) {
+        fileStateIndex.setFileName(parser.value(clIncremental));
+
+        if (!fileStateIndex.load()) {
+            printString(tr("Cannot read index: %1").arg(parser.value(clIncremental)));
+            return 1;
+        }
+    }
+
+    FileStateIndex *pFileStateIndex = parser.isSet(clIncremental) ? &fileStateIndex : nullptr;
+
+    if (parser.isSet(clCoordinator)) {
+        // Results are taken from whoever connects, so other hosts are only let in on request
+        QString sCoordinator = parser.value(clCoordinator);
+        qint32 nSeparator = sCoordinator.lastIndexOf(QLatin1Char(':'));
+        QHostAddress address(QHostAddress::LocalHost);
+        bool bValid = false;
+        quint16 nPort = sCoordinator.mid(nSeparator + 1).toUShort(&bValid);
+
+        if ((nSeparator != -1) && (!address.setAddress(sCoordinator.left(nSeparator)))) {
+            bValid = false;
+        }
+
+        if ((!bValid) || (nPort == 0)) {
+            printString(tr("Invalid coordinator: %1 (expected [address:]port)").arg(sCoordinator));
+            return 1;
+        }
+
+        qint32 nNumberOfErrors = 0;
+
+        UnpackCoordinator coordinator(collectTargets(listTargets, bRecursive, options.pJournal, pFileStateIndex),
+                                      [&](const BatchScheduler::ITEM &item, const UnpackEngine::RESULT &result) {
+                                          if (!finishTarget(item, result, options, pFileStateIndex)) {
+                                              nNumberOfErrors++;
+                                          }
+                                      });
+
+        coordinator.setToken(parser.value(clToken));
+
+        if (!coordinator.listen(address, nPort)) {
+            printString(tr("Cannot listen on %1:%2: %3").arg(address.toString(), QString::number(nPort), coordinator.getErrorString()));
+            return 1;
+        }
+
+        if (!coordinator.isFinished()) {
+            connect(&coordinator, SIGNAL(finished()), &m_application, SLOT(quit()), Qt::QueuedConnection);
+
+            printString(tr("Waiting for workers on %1:%2").arg(address.toString(), QString::number(nPort)));
+
+            m_application.exec();
+        }
+
+        if (coordinator.getNumberOfRequeued() > 0) {
+            printString(tr("%1 jobs of lost workers were run again").arg(coordinator.getNumberOfRequeued()));
+        }
+
+        if (pFileStateIndex && (!pFileStateIndex->save())) {
+            printString(tr("Cannot write index: %1").arg(pFileStateIndex->getFileName()));
+            nNumberOfErrors++;
+        }
+
+        return (nNumberOfErrors == 0) ? 0 : 1;
+    }
+
+    if (parser.isSet(clWorker)) {
+        QString sCoordinator = parser.value(clWorker);
+        qint32 nSeparator = sCoordinator.lastIndexOf(QLatin1Char(':'));
+        bool bValid = false;
+        quint16 nPort = sCoordinator.mid(nSeparator + 1).toUShort(&bValid);
+
+        if ((nSeparator <= 0) || (!bValid) || (nPort == 0)) {
+            printString(tr("Invalid coordinator: %1 (expected host:port)").arg(sCoordinator));
+            return 1;
+        }
+
+        UnpackWorker worker(options, nNumberOfWorkers, sOutputDirectory, [&](const UnpackEngine::RESULT &result) {
+            if (m_fileProfile.isOpen()) {
+                writeProfile(result, options.pResultCache != nullptr);
+            }
+        });
+
+        connect(&worker, SIGNAL(finished()), &m_application, SLOT(quit()), Qt::QueuedConnection);
+
+        worker.setToken(parser.value(clToken));
+        worker.connectToCoordinator(sCoordinator.left(nSeparator), nPort);
+
+        m_application.exec();
+
+        if (options.pDedupStore) {
+            options.pDedupStore->flush();
+        }
+
+        printString(tr("%1 jobs done").arg(worker.getNumberOfJobs()));
+
+        if (!worker.isDone()) {
+            printString(tr("Coordinator %1 not reachable").arg(sCoordinator));
+        }
+
+        return worker.isDone() ? 0 : 1;
+    }
+
+    QVector<UnpackEngine *> listEngines;
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        listEngines.append(new UnpackEngine);
+    }
+
+    qint32 nNumberOfErrors = processTargets(listTargets, bRecursive, sOutputDirectory, options, listEngines, pFileStateIndex);
+
+    if (parser.isSet(clWatch)) {
+        // Runs until killed; every settled change is one more incremental pass
+        DirectoryWatcher directoryWatcher;
+        directoryWatcher.setPaths(listTargets, bRecursive);
+
+        connect(&directoryWatcher, &DirectoryWatcher::changed, this,
+                [&]() { processTargets(listTargets, bRecursive, sOutputDirectory, options, listEngines, pFileStateIndex); });
+
+        printString(tr("Watching %1").arg(listTargets.join(QStringLiteral(", "))));
+
+        m_application.exec();
+    }
+
+    qDeleteAll(listEngines);
+
+    if (pOutputSink && (!pOutputSink->finish())) {
+        nNumberOfErrors++;
+    }
+
+    if (m_fileProfile.isOpen()) {
+        m_fileProfile.close();
+    }
+
+    return (nNumberOfErrors == 0) ? 0 : 1;
+}
+
+QList<BatchScheduler::ITEM> UnpackConsole::collectTargets(const QStringList &listTargets, bool bRecursive, BatchJournal *pJournal,
+                                                          FileStateIndex *pFileStateIndex)
+{
+    QList<BatchScheduler::ITEM> listResult = BatchScheduler::collectItems(listTargets, bRecursive);
+
+    if (m_nNumberOfShards > 1) {
+        qint32 nNumberOfItems = listResult.count();
+        listResult = BatchScheduler::selectShard(listResult, m_nShard, m_nNumberOfShards);
+
+        printString(tr("Shard %1/%2: %3 of %4 files")
+                        .arg(QString::number(m_nShard + 1), QString::number(m_nNumberOfShards), QString::number(listResult.count()),
+                             QString::number(nNumberOfItems)));
+    }
+
+    if (pJournal) {
+        qint32 nNumberOfItems = listResult.count();
+        listResult = pJournal->getUnfinishedItems(listResult);
+
+        if (listResult.count() < nNumberOfItems) {
+            printString(tr("%1 of %2 files already finished").arg(QString::number(nNumberOfItems - listResult.count()), QString::number(nNumberOfItems)));
+        }
+    }
+
+    if (pFileStateIndex) {
+        qint32 nNumberOfItems = listResult.count();
+        listResult = pFileStateIndex->getChangedItems(listResult);
+
+        printString(tr("%1 of %2 files new or changed").arg(QString::number(listResult.count()), QString::number(nNumberOfItems)));
+    }
+
+    return listResult;
+}
+
+qint32 UnpackConsole::processTargets(const QStringList &listTargets, bool bRecursive, const QString &sOutputDirectory, const UnpackEngine::OPTIONS &options,
+                                     const QVector<UnpackEngine *> &listEngines, FileStateIndex *pFileStateIndex)
+{
+    BatchScheduler scheduler;
+    scheduler.setItems(collectTargets(listTargets, bRecursive, options.pJournal, pFileStateIndex));
+
+    QAtomicInt nNumberOfErrors(0);
+
+    scheduler.process(listEngines.count(), [&](qint32 nWorker, const BatchScheduler::ITEM &item) {
+        QString sItemOutputDirectory;
+
+        if (options.pOutputSink) {
+            // Entry names inside the stream
+            sItemOutputDirectory = item.sRelativeName;
+        } else if (!sOutputDirectory.isEmpty()) {
+            sItemOutputDirectory = sOutputDirectory + QDir::separator() + item.sRelativeName;
+        }
+
+        UnpackEngine::RESULT result = listEngines.at(nWorker)->processFile(item.sFileName, sItemOutputDirectory, options);
+
+        if (!finishTarget(item, result, options, pFileStateIndex)) {
+            nNumberOfErrors.ref();
+        }
+    });
+
+    if (options.pAsyncWriter) {
+        options.pAsyncWriter->waitForDone();
+
+        QStringList listFailedFiles = options.pAsyncWriter->takeFailedFiles();
+        qint32 nNumberOfFailedFiles = listFailedFiles.count();
+
+        for (qint32 i = 0; i < nNumberOfFailedFiles; i++) {
+            printString(tr("Cannot write: %1").arg(listFailedFiles.at(i)));
+            nNumberOfErrors.ref();
+        }
+    }
+
+    if (options.pDedupStore) {
+        options.pDedupStore->flush();
+
+        printString(tr("%1 distinct children, %2 duplicates skipped (%3 bytes)")
+                        .arg(QString::number(options.pDedupStore->getNumberOfObjects()), QString::number(options.pDedupStore->getNumberOfDuplicates()),
+                             QString::number(options.pDedupStore->getDuplicateSize())));
+    }
+
+    if (pFileStateIndex && (!pFileStateIndex->save())) {
+        printString(tr("Cannot write index: %1").arg(pFileStateIndex->getFileName()));
+        nNumberOfErrors.ref();
+    }
+
+    return nNumberOfErrors.loadAcquire();
+}
+
+QString UnpackConsole::getDefaultSignatureIndex()
+{
+    QString sResult = QCoreApplication::applicationDirPath() + QStringLiteral("/signatures.idx");
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+    // Installed layout: bin/xfileunpackerc, share/xfileunpacker/signatures.idx
+    QString sShared = QCoreApplication::applicationDirPath() + QStringLiteral("/../share/xfileunpacker/signatures.idx");
+
+    if ((!QFileInfo::exists(sResult)) && QFileInfo::exists(sShared)) {
+        sResult = QFileInfo(sShared).absoluteFilePath();
+    }
+#endif
+
+    return sResult;
+}
+
+bool UnpackConsole::finishTarget(const BatchScheduler::ITEM &item, const UnpackEngine::RESULT &result, const UnpackEngine::OPTIONS &options,
+                                 FileStateIndex *pFileStateIndex)
+{
+    bool bResult = (result.status == UnpackEngine::STATUS_OK);
+
+    if (bResult && pFileStateIndex) {
+        pFileStateIndex->setProcessed(item);
+    }
+
+    reportResult(result, options);
+
+    // After the report, so a resumed run never lacks the record of a skipped input; failed inputs are retried
+    if (options.pJournal && (result.status != UnpackEngine::STATUS_ERROR)) {
+        options.pJournal->setFinished(item);
+    }
+
+    return bResult;
+}
+
+void UnpackConsole::reportResult(const UnpackEngine::RESULT &result, const UnpackEngine::OPTIONS &options)
+{
+    if (options.pResultWriter) {
+        options.pResultWriter->writeResult(result);
+    } else {
+        printResult(result);
+    }
+
+    if (m_fileProfile.isOpen()) {
+        writeProfile(result, options.pResultCache != nullptr);
+    }
+}
+
+void UnpackConsole::printResult(const UnpackEngine::RESULT &result)
+{
+    QString sString = QStringLiteral("%1: %2 [%3] %4 ms").arg(result.sFileName, UnpackEngine::statusToString(result.status), result.sFileType, QString::number(result.nElapsed));
+
+    if (result.bIsCached) {
+        sString.append(QStringLiteral(" (cached)"));
+    }
+
+    if (!result.listEntries.isEmpty()) {
+        sString.append(QStringLiteral(" entries: %1").arg(result.nNumberOfEntries));
+    }
+
+    if (!result.sErrorString.isEmpty()) {
+        sString.append(QStringLiteral("\n    %1").arg(result.sErrorString));
+    }
+
+    appendScanResult(&sString, result.scanResult, 1);
+
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        const UnpackEngine::ENTRY &entry = result.listEntries.at(i);
+
+        QString sIndent(entry.nLevel * 4, QLatin1Char(' '));
+
+        sString.append(QStringLiteral("\n%1%2 [%3]").arg(sIndent, entry.sName, entry.sFileType));
+
+        if (entry.bIsDuplicate) {
+            sString.append(QStringLiteral(" duplicate of %1").arg(entry.sHash));
+        }
+
+        if (!entry.sErrorString.isEmpty()) {
+            sString.append(QStringLiteral(" %1").arg(entry.sErrorString));
+        }
+
+        appendScanResult(&sString, entry.scanResult, entry.nLevel + 1);
+    }
+
+    printString(sString);
+}
+
+void UnpackConsole::appendScanResult(QString *pString, const XScanEngine::SCAN_RESULT &scanResult, qint32 nLevel)
+{
+    QString sIndent(nLevel * 4, QLatin1Char(' '));
+
+    qint32 nNumberOfRecords = scanResult.listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const XScanEngine::SCANSTRUCT &scanStruct = scanResult.listRecords.at(i);
+
+        QString sRecord = QStringLiteral("%1: %2").arg(scanStruct.sType, scanStruct.sName);
+
+        if (!scanStruct.sVersion.isEmpty()) {
+            sRecord.append(QStringLiteral("(%1)").arg(scanStruct.sVersion));
+        }
+
+        if (!scanStruct.sInfo.isEmpty()) {
+            sRecord.append(QStringLiteral("[%1]").arg(scanStruct.sInfo));
+        }
+
+        pString->append(QStringLiteral("\n%1%2").arg(sIndent, sRecord));
+    }
+}
+
+void UnpackConsole::printString(const QString &sString)
+{
+    QMutexLocker locker(&m_mutexOutput);
+
+    std::fprintf(m_pTextOutput, "%s\n", sString.toUtf8().constData());
+    std::fflush(m_pTextOutput);
+}
+
+void UnpackConsole::writeProfile(const UnpackEngine::RESULT &result, bool bIsCacheEnabled)
+{
+    QJsonObject jsRecord = UnpackProfiler::profileToJson(result.profile);
+    jsRecord.insert(QStringLiteral("file"), result.sFileName);
+    jsRecord.insert(QStringLiteral("status"), UnpackEngine::statusToString(result.status));
+    jsRecord.insert(QStringLiteral("size"), (double)result.nSize);
+    jsRecord.insert(QStringLiteral("wall_ms"), (double)result.nElapsed);
+    jsRecord.insert(QStringLiteral("mmap"), result.bIsMemoryMapped);
+
+    QString sCache = QStringLiteral("off");
+
+    if (bIsCacheEnabled) {
+        sCache = result.bIsCached ? QStringLiteral("hit") : QStringLiteral("miss");
+    }
+
+    jsRecord.insert(QStringLiteral("cache"), sCache);
+
+    QByteArray baLine = QJsonDocument(jsRecord).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    QMutexLocker locker(&m_mutexProfile);
+
+    m_fileProfile.write(baLine);
+}
@@ -0,0 +1,85 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKCONSOLE_H
+#define UNPACKCONSOLE_H
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutex>
+
+#include <cstdio>
+
+#include "batchjournal.h"
+#include "batchscheduler.h"
+#include "directorywatcher.h"
+#include "entryfilter.h"
+#include "filestateindex.h"
+#include "outputsink.h"
+#include "resultcache.h"
+#include "resultwriter.h"
+#include "signatureindex.h"
+#include "unpackcoordinator.h"
+#include "unpackengine.h"
+#include "unpackserver.h"
+#include "unpacktracer.h"
+#include "unpackworker.h"
+
+// Batch front-end of xfileunpackerc. Single-file runs still go to XScanEngineConsole.
+class UnpackConsole : public QObject {
+    Q_OBJECT
+
+public:
+    explicit UnpackConsole(QCoreApplication &application, const QString &sDescription, QObject *pParent = nullptr);
+    ~UnpackConsole() override;
+
+    static bool isBatchMode(const QStringList &listArguments);
+
+    int process();
+
+private:
+    static QString getDefaultSignatureIndex();
+    // Walked, cut to the --shard, the inputs the journal has not finished and, with an index, the new or changed files
+    QList<BatchScheduler::ITEM> collectTargets(const QStringList &listTargets, bool bRecursive, BatchJournal *pJournal, FileStateIndex *pFileStateIndex);
+    qint32 processTargets(const QStringList &listTargets, bool bRecursive, const QString &sOutputDirectory, const UnpackEngine::OPTIONS &options,
+                          const QVector<UnpackEngine *> &listEngines, FileStateIndex *pFileStateIndex);
+    // Reports the result, then marks the input done in the index and the journal; false: not STATUS_OK
+    bool finishTarget(const BatchScheduler::ITEM &item, const UnpackEngine::RESULT &result, const UnpackEngine::OPTIONS &options,
+                      FileStateIndex *pFileStateIndex);
+    void reportResult(const UnpackEngine::RESULT &result, const UnpackEngine::OPTIONS &options);
+    void printResult(const UnpackEngine::RESULT &result);
+    static void appendScanResult(QString *pString, const XScanEngine::SCAN_RESULT &scanResult, qint32 nLevel);
+    void printString(const QString &sString);
+    void writeProfile(const UnpackEngine::RESULT &result, bool bIsCacheEnabled);
+
+    QCoreApplication &m_application;
+    QString m_sDescription;
+    QMutex m_mutexOutput;
+    FILE *m_pTextOutput;  // stderr while stdout carries the stream
+    QFile m_fileProfile;
+    QMutex m_mutexProfile;
+    qint32 m_nShard;  // In [0, m_nNumberOfShards)
+    qint32 m_nNumberOfShards;
+    QString m_sTraceFileName;  // --trace; empty: not recording
+};
+
+#endif  // UNPACKCONSOLE_H
@@ -0,0 +1,296 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackcoordinator.h"
+
+#include <algorithm>
+
+#include "unpackserver.h"
+
+UnpackCoordinator::UnpackCoordinator(const QList<BatchScheduler::ITEM> &listItems, const HANDLER &handler, QObject *pParent)
+    : QObject(pParent),
+      m_listItems(listItems),
+      m_listFinished(listItems.count(), false),
+      m_listLostLeases(listItems.count(), 0),
+      m_nNumberOfFinished(0),
+      m_nNumberOfRequeued(0),
+      m_handler(handler)
+{
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; i < nNumberOfItems; i++) {
+        m_listQueue.append(i);
+    }
+
+    m_timer.start();
+    m_timerLeases.setInterval(N_CHECK_INTERVAL);
+
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+    connect(&m_timerLeases, SIGNAL(timeout()), this, SLOT(onCheckLeases()));
+}
+
+UnpackCoordinator::~UnpackCoordinator()
+{
+    m_server.close();
+}
+
+void UnpackCoordinator::setToken(const QString &sToken)
+{
+    m_sToken = sToken;
+}
+
+bool UnpackCoordinator::listen(const QHostAddress &address, quint16 nPort)
+{
+    bool bResult = m_server.listen(address, nPort);
+
+    if (bResult) {
+        m_timerLeases.start();
+    }
+
+    return bResult;
+}
+
+QString UnpackCoordinator::getErrorString() const
+{
+    return m_server.errorString();
+}
+
+bool UnpackCoordinator::isFinished() const
+{
+    return m_nNumberOfFinished == m_listItems.count();
+}
+
+qint32 UnpackCoordinator::getNumberOfRequeued() const
+{
+    return m_nNumberOfRequeued;
+}
+
+void UnpackCoordinator::onNewConnection()
+{
+    while (m_server.hasPendingConnections()) {
+        QTcpSocket *pSocket = m_server.nextPendingConnection();
+
+        CONNECTION connection = {};
+        connection.nLastSeen = m_timer.elapsed();
+        connection.bIsAuthorized = m_sToken.isEmpty();
+
+        m_mapConnections.insert(pSocket, connection);
+
+        connect(pSocket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(pSocket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    }
+}
+
+void UnpackCoordinator::onReadyRead()
+{
+    QTcpSocket *pSocket = qobject_cast<QTcpSocket *>(sender());
+
+    if (pSocket) {
+        while (pSocket->canReadLine()) {
+            QByteArray baLine = pSocket->readLine().trimmed();
+
+            if (!baLine.isEmpty()) {
+                processMessage(pSocket, baLine);
+            }
+        }
+    }
+}
+
+void UnpackCoordinator::onDisconnected()
+{
+    QTcpSocket *pSocket = qobject_cast<QTcpSocket *>(sender());
+
+    if (pSocket) {
+        if (m_mapConnections.contains(pSocket)) {
+            requeue(&m_mapConnections[pSocket]);
+            m_mapConnections.remove(pSocket);
+        }
+
+        pSocket->deleteLater();
+
+        dispatch();
+    }
+}
+
+void UnpackCoordinator::onCheckLeases()
+{
+    qint64 nNow = m_timer.elapsed();
+
+    QList<QTcpSocket *> listSilent;
+
+    for (QHash<QTcpSocket *, CONNECTION>::const_iterator it = m_mapConnections.constBegin(); it != m_mapConnections.constEnd(); ++it) {
+        if ((nNow - it.value().nLastSeen) > N_LEASE_TIMEOUT) {
+            listSilent.append(it.key());
+        }
+    }
+
+    qint32 nNumberOfSilent = listSilent.count();
+
+    // A hung or unplugged node does not always close its connection
+    for (qint32 i = 0; i < nNumberOfSilent; i++) {
+        listSilent.at(i)->abort();
+    }
+}
+
+void UnpackCoordinator::processMessage(QTcpSocket *pSocket, const QByteArray &baLine)
+{
+    if (!m_mapConnections.contains(pSocket)) {
+        return;
+    }
+
+    CONNECTION *pConnection = &m_mapConnections[pSocket];
+    pConnection->nLastSeen = m_timer.elapsed();
+
+    QJsonObject jsMessage = QJsonDocument::fromJson(baLine).object();
+    QString sCommand = jsMessage.value(QStringLiteral("command")).toString();
+
+    if (!pConnection->bIsAuthorized) {
+        // Anyone who reaches the port could otherwise post results
+        if ((sCommand == QStringLiteral("pull")) && (jsMessage.value(QStringLiteral("token")).toString() == m_sToken)) {
+            pConnection->bIsAuthorized = true;
+        } else {
+            pSocket->abort();
+            return;
+        }
+    }
+
+    if (sCommand == QStringLiteral("pull")) {
+        pConnection->nCredit += qMax(0, jsMessage.value(QStringLiteral("count")).toInt());
+
+        if (isFinished()) {
+            QJsonObject jsDone;
+            jsDone.insert(QStringLiteral("command"), QStringLiteral("done"));
+            sendMessage(pSocket, jsDone);
+        } else {
+            dispatch();
+        }
+    } else if (sCommand == QStringLiteral("result")) {
+        qint32 nId = jsMessage.value(QStringLiteral("id")).toInt(-1);
+
+        pConnection->setLeases.remove(nId);
+
+        // A requeued job may come back twice; the first result counts
+        if ((nId >= 0) && (nId < m_listItems.count()) && (!m_listFinished.at(nId))) {
+            m_listFinished[nId] = true;
+            m_nNumberOfFinished++;
+            m_listQueue.removeOne(nId);
+
+            m_handler(m_listItems.at(nId), UnpackServer::resultFromJson(jsMessage.value(QStringLiteral("result")).toObject()));
+
+            checkFinished();
+        }
+    }
+}
+
+void UnpackCoordinator::dispatch()
+{
+    for (QHash<QTcpSocket *, CONNECTION>::iterator it = m_mapConnections.begin(); (it != m_mapConnections.end()) && (!m_listQueue.isEmpty()); ++it) {
+        while ((it.value().nCredit > 0) && (!m_listQueue.isEmpty())) {
+            qint32 nId = m_listQueue.takeFirst();
+
+            if (!m_listFinished.at(nId)) {
+                const BatchScheduler::ITEM &item = m_listItems.at(nId);
+
+                QJsonObject jsJob;
+                jsJob.insert(QStringLiteral("command"), QStringLiteral("job"));
+                jsJob.insert(QStringLiteral("id"), nId);
+                jsJob.insert(QStringLiteral("file"), item.sFileName);
+                jsJob.insert(QStringLiteral("name"), item.sRelativeName);
+
+                sendMessage(it.key(), jsJob);
+
+                it.value().nCredit--;
+                it.value().setLeases.insert(nId);
+            }
+        }
+    }
+}
+
+void UnpackCoordinator::requeue(CONNECTION *pConnection)
+{
+    QList<qint32> listLeases = pConnection->setLeases.values();
+    std::sort(listLeases.begin(), listLeases.end());
+
+    qint32 nNumberOfLeases = listLeases.count();
+    bool bIsAbandoned = false;
+
+    // In front: these are the oldest jobs of the run
+    for (qint32 i = nNumberOfLeases - 1; i >= 0; i--) {
+        qint32 nId = listLeases.at(i);
+
+        if (!m_listFinished.at(nId)) {
+            m_listLostLeases[nId]++;
+
+            if (m_listLostLeases.at(nId) >= N_MAX_LOST_LEASES) {
+                // Every node that takes it goes down; the run has to end without it
+                abandon(nId);
+                bIsAbandoned = true;
+            } else {
+                m_listQueue.prepend(nId);
+                m_nNumberOfRequeued++;
+            }
+        }
+    }
+
+    pConnection->setLeases.clear();
+    pConnection->nCredit = 0;
+
+    if (bIsAbandoned) {
+        checkFinished();
+    }
+}
+
+void UnpackCoordinator::abandon(qint32 nId)
+{
+    m_listFinished[nId] = true;
+    m_nNumberOfFinished++;
+
+    UnpackEngine::RESULT result = {};
+    result.sFileName = m_listItems.at(nId).sFileName;
+    result.status = UnpackEngine::STATUS_ERROR;
+    result.sErrorString = tr("Worker lost %1 times").arg(m_listLostLeases.at(nId));
+
+    m_handler(m_listItems.at(nId), result);
+}
+
+void UnpackCoordinator::checkFinished()
+{
+    if (isFinished()) {
+        QJsonObject jsDone;
+        jsDone.insert(QStringLiteral("command"), QStringLiteral("done"));
+
+        for (QHash<QTcpSocket *, CONNECTION>::const_iterator it = m_mapConnections.constBegin(); it != m_mapConnections.constEnd(); ++it) {
+            sendMessage(it.key(), jsDone);
+            it.key()->flush();
+        }
+
+        m_timerLeases.stop();
+
+        emit finished();
+    }
+}
+
+void UnpackCoordinator::sendMessage(QTcpSocket *pSocket, const QJsonObject &jsMessage)
+{
+    QByteArray baLine = QJsonDocument(jsMessage).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    pSocket->write(baLine);
+}
@@ -0,0 +1,107 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKCOORDINATOR_H
+#define UNPACKCOORDINATOR_H
+
+#include <QElapsedTimer>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <functional>
+
+#include "batchscheduler.h"
+#include "unpackengine.h"
+
+// Hands batch items to remote workers (xfileunpackerc --worker host:port) over TCP. The
+// protocol is JSON Lines in both directions:
+//   worker:      {"command": "pull", "count": 4} | {"command": "result", "id": 7, "result": {...}} | {"command": "ping"}
+//   coordinator: {"command": "job", "id": 7, "file": "/data/a.zip", "name": "data/a.zip"} | {"command": "done"}
+// Workers pull as many jobs as they have free slots. Jobs of a worker that disconnects or
+// stays silent for N_LEASE_TIMEOUT go back to the front of the queue, so a node that dies
+// costs only its jobs in flight. A job whose lease is lost N_MAX_LOST_LEASES times, most
+// likely an input that crashes or hangs the worker, is reported as an error instead. A job
+// is reported once, by the first result that arrives. With a token, a connection is taken
+// only once its first pull carries it ({"command": "pull", "count": 4, "token": "..."}).
+// File names are sent as they are: every node has to see the inputs under the same path.
+class UnpackCoordinator : public QObject {
+    Q_OBJECT
+
+public:
+    // On the coordinator thread
+    typedef std::function<void(const BatchScheduler::ITEM &item, const UnpackEngine::RESULT &result)> HANDLER;
+
+    UnpackCoordinator(const QList<BatchScheduler::ITEM> &listItems, const HANDLER &handler, QObject *pParent = nullptr);
+    ~UnpackCoordinator() override;
+
+    // Empty: no token needed
+    void setToken(const QString &sToken);
+    bool listen(const QHostAddress &address, quint16 nPort);
+    QString getErrorString() const;
+    bool isFinished() const;
+    qint32 getNumberOfRequeued() const;
+
+signals:
+    void finished();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+    void onCheckLeases();
+
+private:
+    struct CONNECTION {
+        qint32 nCredit;          // Jobs asked for and not sent yet
+        QSet<qint32> setLeases;  // Jobs sent and not reported
+        qint64 nLastSeen;        // ms, m_timer
+        bool bIsAuthorized;      // Sent the token
+    };
+
+    void processMessage(QTcpSocket *pSocket, const QByteArray &baLine);
+    void dispatch();
+    void requeue(CONNECTION *pConnection);
+    void checkFinished();
+    void abandon(qint32 nId);
+    static void sendMessage(QTcpSocket *pSocket, const QJsonObject &jsMessage);
+
+    static const qint64 N_LEASE_TIMEOUT = 60000;  // ms without a line from the worker; workers ping every 10 s
+    static const qint32 N_CHECK_INTERVAL = 5000;  // ms
+    static const qint32 N_MAX_LOST_LEASES = 3;
+
+    QTcpServer m_server;
+    QList<BatchScheduler::ITEM> m_listItems;  // Job id -> item
+    QList<qint32> m_listQueue;                // Job ids not leased
+    QVector<bool> m_listFinished;
+    QVector<qint32> m_listLostLeases;
+    qint32 m_nNumberOfFinished;
+    qint32 m_nNumberOfRequeued;
+    HANDLER m_handler;
+    QString m_sToken;
+    QHash<QTcpSocket *, CONNECTION> m_mapConnections;
+    QElapsedTimer m_timer;
+    QTimer m_timerLeases;
+};
+
+#endif  // UNPACKCOORDINATOR_H
@@ -0,0 +1,320 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackserver.h"
+
+UnpackServer::UnpackServer(const UnpackEngine::OPTIONS &options, qint32 nNumberOfWorkers, QObject *pParent) : QObject(pParent), m_options(options)
+{
+    nNumberOfWorkers = qMax(1, nNumberOfWorkers);
+
+    m_threadPool.setMaxThreadCount(nNumberOfWorkers);
+
+    // Constructed up front; their scan engines come from OPTIONS::pScanEnginePool, which the caller warms up
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        UnpackEngine *pEngine = new UnpackEngine;
+        m_listEngines.append(pEngine);
+        m_listFreeEngines.append(pEngine);
+    }
+
+    m_server.setSocketOptions(QLocalServer::UserAccessOption);
+
+    connect(&m_server, SIGNAL(newConnection()), this, SLOT(onNewConnection()));
+}
+
+UnpackServer::~UnpackServer()
+{
+    m_server.close();
+
+    QHashIterator<QLocalSocket *, QSharedPointer<XBinary::PDSTRUCT>> it(m_mapConnections);
+
+    while (it.hasNext()) {
+        it.next();
+        it.value()->bIsStop = true;
+    }
+
+    m_threadPool.waitForDone();
+
+    qDeleteAll(m_listEngines);
+}
+
+bool UnpackServer::listen(const QString &sName)
+{
+    // A stale socket file of a crashed server would make listen() fail
+    QLocalServer::removeServer(sName);
+
+    return m_server.listen(sName);
+}
+
+QString UnpackServer::getErrorString() const
+{
+    return m_server.errorString();
+}
+
+QJsonObject UnpackServer::resultToJson(const UnpackEngine::RESULT &result)
+{
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("file"), result.sFileName);
+    jsResult.insert(QStringLiteral("status"), UnpackEngine::statusToString(result.status));
+    jsResult.insert(QStringLiteral("filetype"), result.sFileType);
+    jsResult.insert(QStringLiteral("size"), (double)result.nSize);
+    jsResult.insert(QStringLiteral("elapsed_ms"), (double)result.nElapsed);
+    jsResult.insert(QStringLiteral("cached"), result.bIsCached);
+    jsResult.insert(QStringLiteral("scan"), ResultCache::scanResultToJson(result.scanResult));
+
+    if (!result.sErrorString.isEmpty()) {
+        jsResult.insert(QStringLiteral("error"), result.sErrorString);
+    }
+
+    if (!result.sLimit.isEmpty()) {
+        jsResult.insert(QStringLiteral("limit"), result.sLimit);
+    }
+
+    QJsonArray jsEntries;
+
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        const UnpackEngine::ENTRY &entry = result.listEntries.at(i);
+
+        QJsonObject jsEntry;
+        jsEntry.insert(QStringLiteral("name"), entry.sName);
+        jsEntry.insert(QStringLiteral("path"), entry.sPath);
+        jsEntry.insert(QStringLiteral("level"), entry.nLevel);
+        jsEntry.insert(QStringLiteral("csize"), (double)entry.nCompressedSize);
+        jsEntry.insert(QStringLiteral("usize"), (double)entry.nUncompressedSize);
+        jsEntry.insert(QStringLiteral("filetype"), entry.sFileType);
+        jsEntry.insert(QStringLiteral("valid"), entry.bIsValid);
+        jsEntry.insert(QStringLiteral("scan"), ResultCache::scanResultToJson(entry.scanResult));
+
+        if (!entry.sOutputFileName.isEmpty()) {
+            jsEntry.insert(QStringLiteral("output"), entry.sOutputFileName);
+        }
+
+        if (!entry.sErrorString.isEmpty()) {
+            jsEntry.insert(QStringLiteral("error"), entry.sErrorString);
+        }
+
+        jsEntries.append(jsEntry);
+    }
+
+    jsResult.insert(QStringLiteral("entries"), jsEntries);
+
+    return jsResult;
+}
+
+UnpackEngine::RESULT UnpackServer::resultFromJson(const QJsonObject &jsResult)
+{
+    UnpackEngine::RESULT result = {};
+    result.sFileName = jsResult.value(QStringLiteral("file")).toString();
+    result.sFileType = jsResult.value(QStringLiteral("filetype")).toString();
+    result.nSize = (qint64)jsResult.value(QStringLiteral("size")).toDouble();
+    result.nElapsed = (qint64)jsResult.value(QStringLiteral("elapsed_ms")).toDouble();
+    result.bIsCached = jsResult.value(QStringLiteral("cached")).toBool();
+    result.scanResult = ResultCache::scanResultFromJson(jsResult.value(QStringLiteral("scan")).toArray());
+    result.sErrorString = jsResult.value(QStringLiteral("error")).toString();
+    result.sLimit = jsResult.value(QStringLiteral("limit")).toString();
+
+    QString sStatus = jsResult.value(QStringLiteral("status")).toString();
+
+    if (sStatus == UnpackEngine::statusToString(UnpackEngine::STATUS_OK)) {
+        result.status = UnpackEngine::STATUS_OK;
+    } else if (sStatus == UnpackEngine::statusToString(UnpackEngine::STATUS_LIMIT)) {
+        result.status = UnpackEngine::STATUS_LIMIT;
+    } else {
+        result.status = UnpackEngine::STATUS_ERROR;
+    }
+
+    QJsonArray jsEntries = jsResult.value(QStringLiteral("entries")).toArray();
+
+    qint32 nNumberOfEntries = jsEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        QJsonObject jsEntry = jsEntries.at(i).toObject();
+
+        UnpackEngine::ENTRY entry = {};
+        entry.sName = jsEntry.value(QStringLiteral("name")).toString();
+        entry.sPath = jsEntry.value(QStringLiteral("path")).toString();
+        entry.nLevel = jsEntry.value(QStringLiteral("level")).toInt();
+        entry.nCompressedSize = (qint64)jsEntry.value(QStringLiteral("csize")).toDouble();
+        entry.nUncompressedSize = (qint64)jsEntry.value(QStringLiteral("usize")).toDouble();
+        entry.sFileType = jsEntry.value(QStringLiteral("filetype")).toString();
+        entry.bIsValid = jsEntry.value(QStringLiteral("valid")).toBool();
+        entry.scanResult = ResultCache::scanResultFromJson(jsEntry.value(QStringLiteral("scan")).toArray());
+        entry.sOutputFileName = jsEntry.value(QStringLiteral("output")).toString();
+        entry.sErrorString = jsEntry.value(QStringLiteral("error")).toString();
+
+        result.listEntries.append(entry);
+    }
+
+    result.nNumberOfEntries = nNumberOfEntries;
+
+    return result;
+}
+
+void UnpackServer::onNewConnection()
+{
+    while (m_server.hasPendingConnections()) {
+        QLocalSocket *pSocket = m_server.nextPendingConnection();
+
+        QSharedPointer<XBinary::PDSTRUCT> pPdStruct(new XBinary::PDSTRUCT(XBinary::createPdStruct()));
+
+        m_mapConnections.insert(pSocket, pPdStruct);
+
+        connect(pSocket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+        connect(pSocket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+    }
+}
+
+void UnpackServer::onReadyRead()
+{
+    QLocalSocket *pSocket = qobject_cast<QLocalSocket *>(sender());
+
+    if (pSocket) {
+        while (pSocket->canReadLine()) {
+            QByteArray baLine = pSocket->readLine().trimmed();
+
+            if (!baLine.isEmpty()) {
+                processRequest(pSocket, baLine);
+            }
+        }
+    }
+}
+
+void UnpackServer::onDisconnected()
+{
+    QLocalSocket *pSocket = qobject_cast<QLocalSocket *>(sender());
+
+    if (pSocket) {
+        QSharedPointer<XBinary::PDSTRUCT> pPdStruct = m_mapConnections.take(pSocket);
+
+        if (pPdStruct) {
+            pPdStruct->bIsStop = true;
+        }
+
+        pSocket->deleteLater();
+    }
+}
+
+void UnpackServer::processRequest(QLocalSocket *pSocket, const QByteArray &baLine)
+{
+    QJsonParseError jsError = {};
+    QJsonObject jsRequest = QJsonDocument::fromJson(baLine, &jsError).object();
+
+    QJsonObject jsResponse;
+    QJsonValue jsId = jsRequest.value(QStringLiteral("id"));
+
+    if (!jsId.isUndefined()) {
+        jsResponse.insert(QStringLiteral("id"), jsId);
+    }
+
+    if (jsError.error != QJsonParseError::NoError) {
+        jsResponse.insert(QStringLiteral("status"), QStringLiteral("error"));
+        jsResponse.insert(QStringLiteral("error"), tr("Invalid request: %1").arg(jsError.errorString()));
+        sendResponse(pSocket, jsResponse);
+
+        return;
+    }
+
+    QString sCommand = jsRequest.value(QStringLiteral("command")).toString();
+    QString sFileName = jsRequest.value(QStringLiteral("file")).toString();
+
+    if (sCommand == QStringLiteral("ping")) {
+        jsResponse.insert(QStringLiteral("status"), QStringLiteral("ok"));
+        jsResponse.insert(QStringLiteral("workers"), m_threadPool.maxThreadCount());
+        jsResponse.insert(QStringLiteral("active"), m_threadPool.activeThreadCount());
+        sendResponse(pSocket, jsResponse);
+    } else if (sCommand == QStringLiteral("shutdown")) {
+        jsResponse.insert(QStringLiteral("status"), QStringLiteral("ok"));
+        sendResponse(pSocket, jsResponse);
+        pSocket->flush();
+
+        emit shutdownRequested();
+    } else if ((!sCommand.isEmpty()) || sFileName.isEmpty()) {
+        jsResponse.insert(QStringLiteral("status"), QStringLiteral("error"));
+        jsResponse.insert(QStringLiteral("error"), sCommand.isEmpty() ? tr("No file") : tr("Unknown command: %1").arg(sCommand));
+        sendResponse(pSocket, jsResponse);
+    } else {
+        QSharedPointer<XBinary::PDSTRUCT> pPdStruct = m_mapConnections.value(pSocket);
+
+        if (!pPdStruct) {
+            return;
+        }
+
+        UnpackEngine::OPTIONS options = m_options;
+        QString sOutputDirectory;
+
+        if (jsRequest.contains(QStringLiteral("output"))) {
+            sOutputDirectory = QDir(jsRequest.value(QStringLiteral("output")).toString()).absolutePath();
+            options.bExtract = true;
+        }
+
+        if (jsRequest.contains(QStringLiteral("depth"))) {
+            options.nMaxDepth = jsRequest.value(QStringLiteral("depth")).toInt();
+            options.bExtract = true;
+        }
+
+        QPointer<QLocalSocket> pSocketGuard(pSocket);
+
+        QtConcurrent::run(&m_threadPool, [this, pSocketGuard, pPdStruct, jsId, sFileName, sOutputDirectory, options]() {
+            UnpackEngine *pEngine = takeEngine();
+            UnpackEngine::RESULT result = pEngine->processFile(sFileName, sOutputDirectory, options, pPdStruct.data());
+            returnEngine(pEngine);
+
+            QJsonObject jsResult = resultToJson(result);
+
+            if (!jsId.isUndefined()) {
+                jsResult.insert(QStringLiteral("id"), jsId);
+            }
+
+            // Sockets live on the server thread
+            QMetaObject::invokeMethod(
+                this,
+                [pSocketGuard, jsResult]() {
+                    if (pSocketGuard) {
+                        sendResponse(pSocketGuard, jsResult);
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+    }
+}
+
+void UnpackServer::sendResponse(QLocalSocket *pSocket, const QJsonObject &jsResponse)
+{
+    QByteArray baLine = QJsonDocument(jsResponse).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    pSocket->write(baLine);
+}
+
+UnpackEngine *UnpackServer::takeEngine()
+{
+    QMutexLocker locker(&m_mutexEngines);
+
+    // The pool never runs more jobs than there are engines
+    return m_listFreeEngines.takeLast();
+}
+
+void UnpackServer::returnEngine(UnpackEngine *pEngine)
+{
+    QMutexLocker locker(&m_mutexEngines);
+
+    m_listFreeEngines.append(pEngine);
+}
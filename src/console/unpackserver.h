@@ -0,0 +1,83 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKSERVER_H
+#define UNPACKSERVER_H
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutex>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "resultcache.h"
+#include "unpackengine.h"
+
+// Long-running front-end: engines and signatures are loaded once and jobs arrive over a
+// local socket (a Unix domain socket, a named pipe on Windows). The protocol is JSON Lines
+// in both directions:
+//   request:  {"id": 1, "file": "/path/sample.bin", "output": "/path/out", "depth": 1}
+//             {"command": "ping"} | {"command": "shutdown"}
+//   response: {"id": 1, "file": ..., "status": "ok", "filetype": ..., "elapsed_ms": ..., "scan": [...], "entries": [...]}
+// Jobs of all connections share the worker pool and finish in any order; responses carry the
+// request id. A client that disconnects cancels its jobs.
+class UnpackServer : public QObject {
+    Q_OBJECT
+
+public:
+    UnpackServer(const UnpackEngine::OPTIONS &options, qint32 nNumberOfWorkers, QObject *pParent = nullptr);
+    ~UnpackServer() override;
+
+    bool listen(const QString &sName);
+    QString getErrorString() const;
+
+    static QJsonObject resultToJson(const UnpackEngine::RESULT &result);
+    // Inverse of resultToJson, for results that come back from remote workers
+    static UnpackEngine::RESULT resultFromJson(const QJsonObject &jsResult);
+
+signals:
+    void shutdownRequested();
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    void processRequest(QLocalSocket *pSocket, const QByteArray &baLine);
+    static void sendResponse(QLocalSocket *pSocket, const QJsonObject &jsResponse);
+    UnpackEngine *takeEngine();
+    void returnEngine(UnpackEngine *pEngine);
+
+    QLocalServer m_server;
+    UnpackEngine::OPTIONS m_options;
+    QThreadPool m_threadPool;
+    QMutex m_mutexEngines;
+    QList<UnpackEngine *> m_listEngines;
+    QList<UnpackEngine *> m_listFreeEngines;
+    QHash<QLocalSocket *, QSharedPointer<XBinary::PDSTRUCT>> m_mapConnections;  // Stopped when the client goes away
+};
+
+#endif  // UNPACKSERVER_H
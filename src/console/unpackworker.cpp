@@ -0,0 +1,248 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackworker.h"
+
+#include "unpackserver.h"
+
+UnpackWorker::UnpackWorker(const UnpackEngine::OPTIONS &options, qint32 nNumberOfWorkers, const QString &sOutputDirectory, const HANDLER &handler,
+                           QObject *pParent)
+    : QObject(pParent),
+      m_options(options),
+      m_nNumberOfWorkers(qMax(1, nNumberOfWorkers)),
+      m_sOutputDirectory(sOutputDirectory),
+      m_handler(handler),
+      m_nPort(0),
+      m_nSession(0),
+      m_nNumberOfJobs(0),
+      m_bIsDone(false),
+      m_bIsRetryPending(false)
+{
+    m_threadPool.setMaxThreadCount(m_nNumberOfWorkers);
+
+    for (qint32 i = 0; i < m_nNumberOfWorkers; i++) {
+        UnpackEngine *pEngine = new UnpackEngine;
+        m_listEngines.append(pEngine);
+        m_listFreeEngines.append(pEngine);
+    }
+
+    m_timerPing.setInterval(N_PING_INTERVAL);
+
+    connect(&m_socket, SIGNAL(connected()), this, SLOT(onConnected()));
+    connect(&m_socket, SIGNAL(readyRead()), this, SLOT(onReadyRead()));
+    connect(&m_socket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), this, SLOT(onStateChanged(QAbstractSocket::SocketState)));
+    connect(&m_timerPing, SIGNAL(timeout()), this, SLOT(onPing()));
+}
+
+UnpackWorker::~UnpackWorker()
+{
+    m_bIsDone = true;
+
+    if (m_pSession) {
+        m_pSession->bIsStop = true;
+    }
+
+    m_threadPool.waitForDone();
+
+    qDeleteAll(m_listEngines);
+}
+
+void UnpackWorker::setToken(const QString &sToken)
+{
+    m_sToken = sToken;
+}
+
+void UnpackWorker::connectToCoordinator(const QString &sHostName, quint16 nPort)
+{
+    m_sHostName = sHostName;
+    m_nPort = nPort;
+
+    reconnect();
+}
+
+qint32 UnpackWorker::getNumberOfJobs() const
+{
+    return m_nNumberOfJobs;
+}
+
+bool UnpackWorker::isDone() const
+{
+    return m_bIsDone;
+}
+
+void UnpackWorker::onConnected()
+{
+    m_timerUnconnected.invalidate();
+
+    m_nSession++;
+    m_pSession.reset(new XBinary::PDSTRUCT(XBinary::createPdStruct()));
+
+    m_timerPing.start();
+
+    sendPull(m_nNumberOfWorkers);
+}
+
+void UnpackWorker::onReadyRead()
+{
+    while (m_socket.canReadLine()) {
+        QByteArray baLine = m_socket.readLine().trimmed();
+
+        if (!baLine.isEmpty()) {
+            processMessage(baLine);
+        }
+    }
+}
+
+void UnpackWorker::onStateChanged(QAbstractSocket::SocketState state)
+{
+    // Reached after a lost connection and after a failed attempt alike
+    if (state == QAbstractSocket::UnconnectedState) {
+        m_timerPing.stop();
+
+        if (m_pSession) {
+            m_pSession->bIsStop = true;
+            m_pSession.reset();
+        }
+
+        m_nSession++;
+
+        if (!m_bIsDone) {
+            if (!m_timerUnconnected.isValid()) {
+                m_timerUnconnected.start();
+            }
+
+            if (m_timerUnconnected.elapsed() > N_RETRY_TIME) {
+                emit finished();
+            } else if (!m_bIsRetryPending) {
+                m_bIsRetryPending = true;
+
+                QTimer::singleShot(N_RETRY_INTERVAL, this, SLOT(reconnect()));
+            }
+        }
+    }
+}
+
+void UnpackWorker::onPing()
+{
+    QJsonObject jsPing;
+    jsPing.insert(QStringLiteral("command"), QStringLiteral("ping"));
+
+    sendMessage(jsPing);
+}
+
+void UnpackWorker::reconnect()
+{
+    m_bIsRetryPending = false;
+
+    if ((!m_bIsDone) && (m_socket.state() == QAbstractSocket::UnconnectedState)) {
+        m_socket.connectToHost(m_sHostName, m_nPort);
+    }
+}
+
+void UnpackWorker::processMessage(const QByteArray &baLine)
+{
+    QJsonObject jsMessage = QJsonDocument::fromJson(baLine).object();
+    QString sCommand = jsMessage.value(QStringLiteral("command")).toString();
+
+    if (sCommand == QStringLiteral("job") && m_pSession) {
+        qint32 nId = jsMessage.value(QStringLiteral("id")).toInt();
+        QString sFileName = jsMessage.value(QStringLiteral("file")).toString();
+        QString sItemOutputDirectory;
+
+        if (!m_sOutputDirectory.isEmpty()) {
+            sItemOutputDirectory = m_sOutputDirectory + QDir::separator() + jsMessage.value(QStringLiteral("name")).toString();
+        }
+
+        QSharedPointer<XBinary::PDSTRUCT> pSession = m_pSession;
+        quint32 nSession = m_nSession;
+
+        QtConcurrent::run(&m_threadPool, [this, pSession, nSession, nId, sFileName, sItemOutputDirectory]() {
+            UnpackEngine *pEngine = takeEngine();
+            UnpackEngine::RESULT result = pEngine->processFile(sFileName, sItemOutputDirectory, m_options, pSession.data());
+            returnEngine(pEngine);
+
+            // A canceled job is not reported; the coordinator has requeued it
+            if (XBinary::isPdStructNotCanceled(pSession.data())) {
+                if (m_handler) {
+                    m_handler(result);
+                }
+
+                QJsonObject jsResult;
+                jsResult.insert(QStringLiteral("command"), QStringLiteral("result"));
+                jsResult.insert(QStringLiteral("id"), nId);
+                jsResult.insert(QStringLiteral("result"), UnpackServer::resultToJson(result));
+
+                // The socket lives on the worker's thread
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, nSession, jsResult]() {
+                        if (nSession == m_nSession) {
+                            sendMessage(jsResult);
+                            sendPull(1);
+
+                            m_nNumberOfJobs++;
+                        }
+                    },
+                    Qt::QueuedConnection);
+            }
+        });
+    } else if (sCommand == QStringLiteral("done")) {
+        m_bIsDone = true;
+        m_socket.disconnectFromHost();
+
+        emit finished();
+    }
+}
+
+void UnpackWorker::sendMessage(const QJsonObject &jsMessage)
+{
+    QByteArray baLine = QJsonDocument(jsMessage).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    m_socket.write(baLine);
+}
+
+void UnpackWorker::sendPull(qint32 nCount)
+{
+    QJsonObject jsPull;
+    jsPull.insert(QStringLiteral("command"), QStringLiteral("pull"));
+    jsPull.insert(QStringLiteral("count"), nCount);
+
+    if (!m_sToken.isEmpty()) {
+        jsPull.insert(QStringLiteral("token"), m_sToken);
+    }
+
+    sendMessage(jsPull);
+}
+
+UnpackEngine *UnpackWorker::takeEngine()
+{
+    QMutexLocker locker(&m_mutexEngines);
+
+    // The pool never runs more jobs than there are engines
+    return m_listFreeEngines.takeLast();
+}
+
+void UnpackWorker::returnEngine(UnpackEngine *pEngine)
+{
+    QMutexLocker locker(&m_mutexEngines);
+
+    m_listFreeEngines.append(pEngine);
+}
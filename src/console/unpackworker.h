@@ -0,0 +1,101 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKWORKER_H
+#define UNPACKWORKER_H
+
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QTcpSocket>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <functional>
+
+#include "unpackengine.h"
+
+// Remote side of UnpackCoordinator: runs up to nNumberOfWorkers jobs at a time, pulls one more
+// for every job that finishes and sends each result back. Jobs still running when the
+// connection drops are canceled; the coordinator hands them out again. It reconnects every
+// N_RETRY_INTERVAL and gives up after N_RETRY_TIME without a coordinator.
+class UnpackWorker : public QObject {
+    Q_OBJECT
+
+public:
+    // On the job's thread, before the result is sent
+    typedef std::function<void(const UnpackEngine::RESULT &result)> HANDLER;
+
+    UnpackWorker(const UnpackEngine::OPTIONS &options, qint32 nNumberOfWorkers, const QString &sOutputDirectory, const HANDLER &handler,
+                 QObject *pParent = nullptr);
+    ~UnpackWorker() override;
+
+    // Sent with every pull; the coordinator's --token
+    void setToken(const QString &sToken);
+    void connectToCoordinator(const QString &sHostName, quint16 nPort);
+    qint32 getNumberOfJobs() const;
+    bool isDone() const;  // false: gave up
+
+signals:
+    void finished();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onStateChanged(QAbstractSocket::SocketState state);
+    void onPing();
+    void reconnect();
+
+private:
+    void processMessage(const QByteArray &baLine);
+    void sendMessage(const QJsonObject &jsMessage);
+    void sendPull(qint32 nCount);
+    UnpackEngine *takeEngine();
+    void returnEngine(UnpackEngine *pEngine);
+
+    static const qint32 N_PING_INTERVAL = 10000;  // ms
+    static const qint32 N_RETRY_INTERVAL = 5000;  // ms
+    static const qint64 N_RETRY_TIME = 600000;    // ms
+
+    UnpackEngine::OPTIONS m_options;
+    qint32 m_nNumberOfWorkers;
+    QString m_sOutputDirectory;
+    HANDLER m_handler;
+    QString m_sHostName;
+    quint16 m_nPort;
+    QString m_sToken;
+    QTcpSocket m_socket;
+    QTimer m_timerPing;
+    QElapsedTimer m_timerUnconnected;  // Since the last connection was lost
+    QThreadPool m_threadPool;
+    QMutex m_mutexEngines;
+    QList<UnpackEngine *> m_listEngines;
+    QList<UnpackEngine *> m_listFreeEngines;
+    QSharedPointer<XBinary::PDSTRUCT> m_pSession;  // Stopped when the connection drops
+    quint32 m_nSession;                            // Results of an earlier connection are dropped
+    qint32 m_nNumberOfJobs;
+    bool m_bIsDone;
+    bool m_bIsRetryPending;
+};
+
+#endif  // UNPACKWORKER_H
@@ -0,0 +1,271 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "asyncwriter.h"
+
+#include "unpacktracer.h"
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#endif
+
+AsyncWriter::AsyncWriter(qint32 nNumberOfThreads, qint64 nMaxQueueSize)
+    : m_nMaxQueueSize(nMaxQueueSize), m_nQueueSize(0), m_nNumberOfBusy(0), m_bIsFinished(false), m_nNumberOfFiles(0)
+{
+    nNumberOfThreads = qMax(1, nNumberOfThreads);
+
+    m_threadPool.setMaxThreadCount(nNumberOfThreads);
+
+    for (qint32 i = 0; i < nNumberOfThreads; i++) {
+        m_listFutures.append(QtConcurrent::run(&m_threadPool, [this]() { worker(); }));
+    }
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    finish();
+}
+
+bool AsyncWriter::write(const QString &sFileName, const QByteArray &baData, MemoryBudget *pMemoryBudget, GROUP *pGroup)
+{
+    if (baData.size() > m_nMaxQueueSize) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    while ((!m_bIsFinished) && ((m_nQueueSize + baData.size()) > m_nMaxQueueSize)) {
+        m_waitConditionNotFull.wait(&m_mutex);
+    }
+
+    if (m_bIsFinished) {
+        return false;
+    }
+
+    // The producer's own reservation ends when it moves on; from here the queue holds the bytes
+    if (pMemoryBudget && (!pMemoryBudget->tryAcquire(baData.size()))) {
+        return false;
+    }
+
+    ITEM item = {};
+    item.sFileName = sFileName;
+    item.baData = baData;
+    item.pMemoryBudget = pMemoryBudget;
+    item.pGroup = pGroup;
+
+    m_queue.enqueue(item);
+    m_nQueueSize += baData.size();
+
+    if (pGroup) {
+        pGroup->nNumberOfPending++;
+    }
+
+    m_waitConditionNotEmpty.wakeOne();
+
+    return true;
+}
+
+void AsyncWriter::waitForDone()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while ((!m_queue.isEmpty()) || (m_nNumberOfBusy > 0)) {
+        m_waitConditionIdle.wait(&m_mutex);
+    }
+}
+
+QStringList AsyncWriter::waitForGroup(GROUP *pGroup)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (pGroup->nNumberOfPending > 0) {
+        m_waitConditionIdle.wait(&m_mutex);
+    }
+
+    QStringList listResult = pGroup->listFailedFiles;
+    pGroup->listFailedFiles.clear();
+
+    return listResult;
+}
+
+void AsyncWriter::finish()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_bIsFinished) {
+            return;
+        }
+
+        m_bIsFinished = true;
+
+        m_waitConditionNotEmpty.wakeAll();
+        m_waitConditionNotFull.wakeAll();
+    }
+
+    // Workers drain the queue before they return
+    qint32 nNumberOfFutures = m_listFutures.count();
+
+    for (qint32 i = 0; i < nNumberOfFutures; i++) {
+        m_listFutures[i].waitForFinished();
+    }
+}
+
+qint64 AsyncWriter::getNumberOfFiles() const
+{
+    return m_nNumberOfFiles.loadAcquire();
+}
+
+QStringList AsyncWriter::takeFailedFiles()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QStringList listResult = m_listFailedFiles;
+    m_listFailedFiles.clear();
+
+    return listResult;
+}
+
+void AsyncWriter::worker()
+{
+    QList<ITEM> listBatch;
+
+    while (true) {
+        {
+            QMutexLocker locker(&m_mutex);
+
+            while (m_queue.isEmpty() && (!m_bIsFinished)) {
+                m_waitConditionNotEmpty.wait(&m_mutex);
+            }
+
+            if (m_queue.isEmpty()) {
+                break;
+            }
+
+            while ((!m_queue.isEmpty()) && (listBatch.count() < N_BATCH_SIZE)) {
+                listBatch.append(m_queue.dequeue());
+            }
+
+            m_nNumberOfBusy++;
+        }
+
+        QStringList listFailed;
+        QVector<bool> listIsWritten;
+        qint64 nBatchSize = 0;
+
+        qint32 nNumberOfItems = listBatch.count();
+
+        for (qint32 i = 0; i < nNumberOfItems; i++) {
+            ITEM &item = listBatch[i];
+
+            bool bIsWritten = writeFile(item);
+            listIsWritten.append(bIsWritten);
+
+            if ((!bIsWritten) && (!item.pGroup)) {
+                listFailed.append(item.sFileName);
+            }
+
+            nBatchSize += item.baData.size();
+
+            if (item.pMemoryBudget) {
+                item.pMemoryBudget->release(item.baData.size());
+            }
+
+            // The data goes before the queue admits more
+            item.baData = QByteArray();
+        }
+
+        m_nNumberOfFiles.fetchAndAddOrdered(listIsWritten.count(true));
+
+        {
+            QMutexLocker locker(&m_mutex);
+
+            for (qint32 i = 0; i < nNumberOfItems; i++) {
+                GROUP *pGroup = listBatch.at(i).pGroup;
+
+                if (pGroup) {
+                    pGroup->nNumberOfPending--;
+
+                    if (!listIsWritten.at(i)) {
+                        pGroup->listFailedFiles.append(listBatch.at(i).sFileName);
+                    }
+                }
+            }
+
+            m_listFailedFiles.append(listFailed);
+            m_nQueueSize -= nBatchSize;
+            m_nNumberOfBusy--;
+
+            m_waitConditionNotFull.wakeAll();
+            // Both the batch and single inputs wait here
+            m_waitConditionIdle.wakeAll();
+        }
+
+        listBatch.clear();
+    }
+}
+
+bool AsyncWriter::writeFile(const ITEM &item)
+{
+    XFU_TRACE_ZONE("async write");
+
+    bool bResult = false;
+
+    if (createDirectory(QFileInfo(item.sFileName).absolutePath())) {
+        QFile file(item.sFileName);
+
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+            qint64 nSize = item.baData.size();
+
+#ifdef Q_OS_LINUX
+            // Extents are reserved in one go instead of growing with every block
+            if (nSize >= N_PREALLOCATE_SIZE) {
+                posix_fallocate(file.handle(), 0, nSize);
+            }
+#endif
+            bResult = (file.write(item.baData.constData(), nSize) == nSize);
+
+            file.close();
+        }
+    }
+
+    return bResult;
+}
+
+bool AsyncWriter::createDirectory(const QString &sDirectory)
+{
+    bool bResult = false;
+
+    {
+        QMutexLocker locker(&m_mutexDirectories);
+        bResult = m_setDirectories.contains(sDirectory);
+    }
+
+    if (!bResult) {
+        bResult = QDir().mkpath(sDirectory);
+
+        if (bResult) {
+            QMutexLocker locker(&m_mutexDirectories);
+            m_setDirectories.insert(sDirectory);
+        }
+    }
+
+    return bResult;
+}
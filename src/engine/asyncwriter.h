@@ -0,0 +1,96 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef ASYNCWRITER_H
+#define ASYNCWRITER_H
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QQueue>
+#include <QSet>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent>
+
+#include "memorybudget.h"
+
+// Writes finished in-memory entries on its own threads, so decoder workers go on with the
+// next entry instead of waiting in open/write/close. The queue is bounded in bytes; a full
+// queue blocks the producer. Queued bytes are also held in the shared MemoryBudget until
+// they are on disk. Writer threads take queued files in batches, create each directory
+// once and preallocate large files before the single write.
+class AsyncWriter {
+public:
+    explicit AsyncWriter(qint32 nNumberOfThreads = 2, qint64 nMaxQueueSize = 64 * 1024 * 1024);
+    ~AsyncWriter();
+
+    // The files queued for one input; their failures stay with it instead of takeFailedFiles()
+    struct GROUP {
+        qint32 nNumberOfPending;
+        QStringList listFailedFiles;
+    };
+
+    // Thread-safe; baData is shared, not copied. false: not taken (after finish(), larger than the
+    // queue or over pMemoryBudget), the caller writes the file itself
+    bool write(const QString &sFileName, const QByteArray &baData, MemoryBudget *pMemoryBudget = nullptr, GROUP *pGroup = nullptr);
+    // Blocks until everything queued so far is on disk
+    void waitForDone();
+    // Blocks until the files of pGroup are written; returns those that failed
+    QStringList waitForGroup(GROUP *pGroup);
+    void finish();
+
+    qint64 getNumberOfFiles() const;
+    QStringList takeFailedFiles();
+
+private:
+    struct ITEM {
+        QString sFileName;
+        QByteArray baData;
+        MemoryBudget *pMemoryBudget;  // Released once the file is written
+        GROUP *pGroup;
+    };
+
+    void worker();
+    bool writeFile(const ITEM &item);
+    bool createDirectory(const QString &sDirectory);
+
+    static const qint32 N_BATCH_SIZE = 32;                    // Files per queue visit
+    static const qint64 N_PREALLOCATE_SIZE = 4 * 1024 * 1024;  // Bytes
+
+    qint64 m_nMaxQueueSize;
+    QMutex m_mutex;
+    QWaitCondition m_waitConditionNotEmpty;
+    QWaitCondition m_waitConditionNotFull;
+    QWaitCondition m_waitConditionIdle;
+    QQueue<ITEM> m_queue;
+    qint64 m_nQueueSize;  // Queued and being written
+    qint32 m_nNumberOfBusy;
+    bool m_bIsFinished;
+    QStringList m_listFailedFiles;
+    QMutex m_mutexDirectories;
+    QSet<QString> m_setDirectories;
+    QAtomicInteger<qint64> m_nNumberOfFiles;
+    QThreadPool m_threadPool;
+    QList<QFuture<void>> m_listFutures;
+};
+
+#endif  // ASYNCWRITER_H
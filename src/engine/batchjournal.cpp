@@ -0,0 +1,182 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "batchjournal.h"
+
+BatchJournal::BatchJournal()
+{
+}
+
+BatchJournal::~BatchJournal()
+{
+    m_file.close();
+}
+
+bool BatchJournal::open(const QString &sFileName, bool bResume)
+{
+    m_file.setFileName(sFileName);
+    m_mapInputs.clear();
+    m_mapOutputs.clear();
+
+    bool bResult = false;
+
+    if (bResume) {
+        load();
+
+        bResult = m_file.open(QIODevice::ReadWrite | QIODevice::Append);
+
+        // A record cut short by the crash must not swallow the next one
+        if (bResult && (m_file.size() > 0) && m_file.seek(m_file.size() - 1) && (m_file.read(1) != QByteArray("\n"))) {
+            m_file.write("\n");
+            m_file.flush();
+        }
+    } else {
+        bResult = m_file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+
+    return bResult;
+}
+
+QString BatchJournal::getFileName() const
+{
+    return m_file.fileName();
+}
+
+QList<BatchScheduler::ITEM> BatchJournal::getUnfinishedItems(const QList<BatchScheduler::ITEM> &listItems) const
+{
+    QList<BatchScheduler::ITEM> listResult;
+
+    QMutexLocker locker(&m_mutex);
+
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; i < nNumberOfItems; i++) {
+        const BatchScheduler::ITEM &item = listItems.at(i);
+
+        QHash<QString, STATE>::const_iterator it = m_mapInputs.constFind(item.sFileName);
+
+        if ((it == m_mapInputs.constEnd()) || (it.value().nSize != item.nSize) || (it.value().nModified != item.nModified)) {
+            listResult.append(item);
+        }
+    }
+
+    return listResult;
+}
+
+qint32 BatchJournal::getNumberOfFinished() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapInputs.count();
+}
+
+qint32 BatchJournal::getNumberOfOutputs() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapOutputs.count();
+}
+
+void BatchJournal::setFinished(const BatchScheduler::ITEM &item)
+{
+    QJsonObject jsRecord;
+    jsRecord.insert(QStringLiteral("record"), QStringLiteral("input"));
+    jsRecord.insert(QStringLiteral("file"), item.sFileName);
+    jsRecord.insert(QStringLiteral("size"), (double)item.nSize);
+    jsRecord.insert(QStringLiteral("mtime"), (double)item.nModified);
+
+    QMutexLocker locker(&m_mutex);
+
+    STATE state = {};
+    state.nSize = item.nSize;
+    state.nModified = item.nModified;
+
+    m_mapInputs.insert(item.sFileName, state);
+
+    writeRecord(jsRecord);
+}
+
+void BatchJournal::addOutput(const QString &sFileName, qint64 nSize)
+{
+    QJsonObject jsRecord;
+    jsRecord.insert(QStringLiteral("record"), QStringLiteral("output"));
+    jsRecord.insert(QStringLiteral("file"), sFileName);
+    jsRecord.insert(QStringLiteral("size"), (double)nSize);
+
+    QMutexLocker locker(&m_mutex);
+
+    m_mapOutputs.insert(sFileName, nSize);
+
+    writeRecord(jsRecord);
+}
+
+bool BatchJournal::isOutputCommitted(const QString &sFileName) const
+{
+    qint64 nSize = -1;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        nSize = m_mapOutputs.value(sFileName, -1);
+    }
+
+    // Deleted or rewritten since: decoded again
+    return (nSize != -1) && (QFileInfo(sFileName).size() == nSize);
+}
+
+void BatchJournal::load()
+{
+    QFile file(m_file.fileName());
+
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            QJsonObject jsRecord = QJsonDocument::fromJson(file.readLine()).object();
+
+            QString sRecord = jsRecord.value(QStringLiteral("record")).toString();
+            QString sFileName = jsRecord.value(QStringLiteral("file")).toString();
+
+            if (sFileName.isEmpty()) {
+                // The record the crash cut short
+                continue;
+            }
+
+            if (sRecord == QStringLiteral("input")) {
+                STATE state = {};
+                state.nSize = (qint64)jsRecord.value(QStringLiteral("size")).toDouble();
+                state.nModified = (qint64)jsRecord.value(QStringLiteral("mtime")).toDouble();
+
+                m_mapInputs.insert(sFileName, state);
+            } else if (sRecord == QStringLiteral("output")) {
+                m_mapOutputs.insert(sFileName, (qint64)jsRecord.value(QStringLiteral("size")).toDouble());
+            }
+        }
+
+        file.close();
+    }
+}
+
+void BatchJournal::writeRecord(const QJsonObject &jsRecord)
+{
+    QByteArray baLine = QJsonDocument(jsRecord).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    // Flushed per record: what reached the OS survives a crash of the process
+    m_file.write(baLine);
+    m_file.flush();
+}
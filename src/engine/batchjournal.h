@@ -0,0 +1,72 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BATCHJOURNAL_H
+#define BATCHJOURNAL_H
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+
+#include "batchscheduler.h"
+
+// Progress of a batch run as JSON Lines, appended and flushed record by record, so a crash
+// loses at most the work in flight:
+//   {"record": "input", "file": ..., "size": ..., "mtime": ...}   input finished
+//   {"record": "output", "file": ..., "size": ...}                entry file completely written
+// A resumed run skips finished inputs whose size and mtime still match. Inputs it redoes
+// read committed entries back from their files instead of decoding and writing them again;
+// a committed file is trusted if its size matches, nothing is hashed.
+class BatchJournal {
+public:
+    BatchJournal();
+    ~BatchJournal();
+
+    // bResume false: starts a new journal
+    bool open(const QString &sFileName, bool bResume);
+    QString getFileName() const;
+
+    QList<BatchScheduler::ITEM> getUnfinishedItems(const QList<BatchScheduler::ITEM> &listItems) const;
+    qint32 getNumberOfFinished() const;
+    qint32 getNumberOfOutputs() const;
+
+    // Thread-safe
+    void setFinished(const BatchScheduler::ITEM &item);
+    void addOutput(const QString &sFileName, qint64 nSize);
+    bool isOutputCommitted(const QString &sFileName) const;
+
+private:
+    struct STATE {
+        qint64 nSize;
+        qint64 nModified;  // ms since epoch
+    };
+
+    void load();
+    void writeRecord(const QJsonObject &jsRecord);
+
+    QFile m_file;
+    mutable QMutex m_mutex;
+    QHash<QString, STATE> m_mapInputs;
+    QHash<QString, qint64> m_mapOutputs;  // File name -> size
+};
+
+#endif  // BATCHJOURNAL_H
@@ -0,0 +1,260 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "batchscheduler.h"
+
+#include <algorithm>
+
+BatchScheduler::BatchScheduler(QObject *pParent) : QObject(pParent), m_nNumberOfSteals(0)
+{
+}
+
+QList<BatchScheduler::ITEM> BatchScheduler::collectItems(const QStringList &listPaths, bool bRecursive, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<ITEM> listResult;
+
+    qint32 nNumberOfPaths = listPaths.count();
+
+    for (qint32 i = 0; (i < nNumberOfPaths) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        QFileInfo fi(listPaths.at(i));
+
+        if (fi.isFile()) {
+            ITEM item = {};
+            item.sFileName = fi.absoluteFilePath();
+            item.sRelativeName = fi.fileName();
+            item.nSize = fi.size();
+            item.nModified = fi.lastModified().toMSecsSinceEpoch();
+
+            listResult.append(item);
+        } else if (fi.isDir()) {
+            QDir dirRoot(fi.absoluteFilePath());
+            QDirIterator::IteratorFlags flags = bRecursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags;
+            QDirIterator it(fi.absoluteFilePath(), QDir::Files | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, flags);
+
+            while (it.hasNext() && XBinary::isPdStructNotCanceled(pPdStruct)) {
+                it.next();
+
+                QFileInfo fiFile = it.fileInfo();
+
+                ITEM item = {};
+                item.sFileName = fiFile.absoluteFilePath();
+                item.sRelativeName = fi.fileName() + QLatin1Char('/') + dirRoot.relativeFilePath(fiFile.absoluteFilePath());
+                item.nSize = fiFile.size();
+                item.nModified = fiFile.lastModified().toMSecsSinceEpoch();
+
+                listResult.append(item);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+qint32 BatchScheduler::getDefaultNumberOfWorkers()
+{
+    return qMax(1, QThread::idealThreadCount());
+}
+
+qint32 BatchScheduler::getShard(const QString &sRelativeName, qint32 nNumberOfShards)
+{
+    // FNV-1a: qHash is seeded per process and would differ between nodes
+    QByteArray baName = sRelativeName.toUtf8();
+    quint64 nKey = 14695981039346656037ULL;
+
+    qint32 nSize = baName.size();
+
+    for (qint32 i = 0; i < nSize; i++) {
+        nKey ^= (quint8)baName.at(i);
+        nKey *= 1099511628211ULL;
+    }
+
+    // Lamping, Veach: A Fast, Minimal Memory, Consistent Hash Algorithm
+    qint64 nBucket = -1;
+    qint64 nJump = 0;
+
+    while (nJump < nNumberOfShards) {
+        nBucket = nJump;
+        nKey = nKey * 2862933555777941757ULL + 1;
+        nJump = (qint64)((double)(nBucket + 1) * ((double)(1LL << 31) / (double)((nKey >> 33) + 1)));
+    }
+
+    return (qint32)nBucket;
+}
+
+QList<BatchScheduler::ITEM> BatchScheduler::selectShard(const QList<ITEM> &listItems, qint32 nShard, qint32 nNumberOfShards)
+{
+    QList<ITEM> listResult;
+
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; i < nNumberOfItems; i++) {
+        if (getShard(listItems.at(i).sRelativeName, nNumberOfShards) == nShard) {
+            listResult.append(listItems.at(i));
+        }
+    }
+
+    return listResult;
+}
+
+void BatchScheduler::setItems(const QList<ITEM> &listItems)
+{
+    m_listItems = listItems;
+}
+
+void BatchScheduler::process(qint32 nNumberOfWorkers, const HANDLER &handler, XBinary::PDSTRUCT *pPdStruct)
+{
+    nNumberOfWorkers = qMax(1, nNumberOfWorkers);
+
+    // Largest first, dealt round-robin: every worker starts with a similar share of bytes
+    QList<ITEM> listItems = m_listItems;
+    std::stable_sort(listItems.begin(), listItems.end(), [](const ITEM &a, const ITEM &b) { return a.nSize > b.nSize; });
+
+    m_listQueues.clear();
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        WORKQUEUE *pQueue = new WORKQUEUE;
+        pQueue->nTotalSize = 0;
+        m_listQueues.append(pQueue);
+    }
+
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; i < nNumberOfItems; i++) {
+        WORKQUEUE *pQueue = m_listQueues.at(i % nNumberOfWorkers);
+        pQueue->listItems.append(listItems.at(i));
+        pQueue->nTotalSize += listItems.at(i).nSize;
+    }
+
+    m_nNumberOfSteals.storeRelease(0);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(nNumberOfWorkers);
+
+    QList<QFuture<void>> listFutures;
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        listFutures.append(QtConcurrent::run(&threadPool, [this, i, &handler, pPdStruct]() { worker(i, handler, pPdStruct); }));
+    }
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        listFutures[i].waitForFinished();
+    }
+
+    qDeleteAll(m_listQueues);
+    m_listQueues.clear();
+}
+
+qint64 BatchScheduler::getNumberOfSteals() const
+{
+    return m_nNumberOfSteals.loadAcquire();
+}
+
+void BatchScheduler::worker(qint32 nWorker, const HANDLER &handler, XBinary::PDSTRUCT *pPdStruct)
+{
+    ITEM item = {};
+
+    while (XBinary::isPdStructNotCanceled(pPdStruct)) {
+        if (!takeItem(nWorker, &item)) {
+            if (!stealItems(nWorker)) {
+                break;
+            }
+
+            continue;
+        }
+
+        handler(nWorker, item);
+    }
+}
+
+bool BatchScheduler::takeItem(qint32 nWorker, ITEM *pItem)
+{
+    bool bResult = false;
+
+    WORKQUEUE *pQueue = m_listQueues.at(nWorker);
+
+    QMutexLocker locker(&pQueue->mutex);
+
+    if (!pQueue->listItems.isEmpty()) {
+        *pItem = pQueue->listItems.takeFirst();
+        pQueue->nTotalSize -= pItem->nSize;
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+bool BatchScheduler::stealItems(qint32 nWorker)
+{
+    QList<ITEM> listStolen;
+
+    qint32 nNumberOfQueues = m_listQueues.count();
+
+    // Victim is the queue with the most bytes left; a retry follows if it drained in between
+    while (listStolen.isEmpty()) {
+        qint32 nVictim = -1;
+        qint64 nVictimSize = -1;
+
+        for (qint32 i = 0; i < nNumberOfQueues; i++) {
+            if (i == nWorker) {
+                continue;
+            }
+
+            WORKQUEUE *pQueue = m_listQueues.at(i);
+            QMutexLocker locker(&pQueue->mutex);
+
+            if ((!pQueue->listItems.isEmpty()) && (pQueue->nTotalSize > nVictimSize)) {
+                nVictim = i;
+                nVictimSize = pQueue->nTotalSize;
+            }
+        }
+
+        if (nVictim == -1) {
+            break;
+        }
+
+        WORKQUEUE *pVictim = m_listQueues.at(nVictim);
+        QMutexLocker locker(&pVictim->mutex);
+
+        qint32 nNumberOfItems = pVictim->listItems.count();
+        qint32 nSteal = (nNumberOfItems + 1) / 2;
+
+        for (qint32 i = 0; i < nSteal; i++) {
+            ITEM item = pVictim->listItems.takeLast();
+            pVictim->nTotalSize -= item.nSize;
+            listStolen.prepend(item);
+        }
+    }
+
+    if (!listStolen.isEmpty()) {
+        WORKQUEUE *pQueue = m_listQueues.at(nWorker);
+        QMutexLocker locker(&pQueue->mutex);
+
+        qint32 nNumberOfStolen = listStolen.count();
+
+        for (qint32 i = 0; i < nNumberOfStolen; i++) {
+            pQueue->listItems.append(listStolen.at(i));
+            pQueue->nTotalSize += listStolen.at(i).nSize;
+        }
+
+        m_nNumberOfSteals.ref();
+    }
+
+    return !listStolen.isEmpty();
+}
@@ -0,0 +1,82 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BATCHSCHEDULER_H
+#define BATCHSCHEDULER_H
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFuture>
+#include <QMutex>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <functional>
+
+#include "xbinary.h"
+
+// Runs batch items on N workers. Every worker owns a deque of items; an idle
+// worker steals the smaller half of the busiest deque, so a few huge inputs do
+// not leave the other workers without work.
+class BatchScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    struct ITEM {
+        QString sFileName;
+        QString sRelativeName;
+        qint64 nSize;
+        qint64 nModified;  // ms since epoch
+    };
+
+    // nWorker is in [0, nNumberOfWorkers)
+    typedef std::function<void(qint32 nWorker, const ITEM &item)> HANDLER;
+
+    explicit BatchScheduler(QObject *pParent = nullptr);
+
+    static QList<ITEM> collectItems(const QStringList &listPaths, bool bRecursive, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static qint32 getDefaultNumberOfWorkers();
+    // Jump consistent hash of the relative name: with one more shard only 1/N of the items move
+    static qint32 getShard(const QString &sRelativeName, qint32 nNumberOfShards);
+    // nShard is in [0, nNumberOfShards)
+    static QList<ITEM> selectShard(const QList<ITEM> &listItems, qint32 nShard, qint32 nNumberOfShards);
+
+    void setItems(const QList<ITEM> &listItems);
+    void process(qint32 nNumberOfWorkers, const HANDLER &handler, XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+    qint64 getNumberOfSteals() const;
+
+private:
+    struct WORKQUEUE {
+        QMutex mutex;
+        QList<ITEM> listItems;
+        qint64 nTotalSize;
+    };
+
+    void worker(qint32 nWorker, const HANDLER &handler, XBinary::PDSTRUCT *pPdStruct);
+    bool takeItem(qint32 nWorker, ITEM *pItem);
+    bool stealItems(qint32 nWorker);
+
+    QList<ITEM> m_listItems;
+    QVector<WORKQUEUE *> m_listQueues;
+    QAtomicInteger<qint64> m_nNumberOfSteals;
+};
+
+#endif  // BATCHSCHEDULER_H
@@ -0,0 +1,97 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "bufferpool.h"
+
+#if defined(__GLIBC__) || defined(Q_OS_WIN)
+#include <malloc.h>
+#endif
+
+BufferPool::BufferPool(qint32 nMaxBuffers, qint64 nMaxBytes)
+    : m_nMaxBuffers(nMaxBuffers), m_nMaxBytes(nMaxBytes), m_nBytes(0), m_nNumberOfHits(0), m_nNumberOfMisses(0)
+{
+}
+
+QByteArray BufferPool::acquire(qint32 nSize)
+{
+    QByteArray baResult;
+
+    qint32 nNumberOfBuffers = m_listBuffers.count();
+
+    for (qint32 i = 0; i < nNumberOfBuffers; i++) {
+        if (m_listBuffers.at(i).capacity() >= nSize) {
+            baResult = m_listBuffers.takeAt(i);
+            m_nBytes -= baResult.capacity();
+            break;
+        }
+    }
+
+    if (baResult.capacity() >= nSize) {
+        m_nNumberOfHits++;
+    } else {
+        m_nNumberOfMisses++;
+        baResult.reserve(nSize);
+    }
+
+    // Within capacity: no reallocation
+    baResult.resize(nSize);
+
+    return baResult;
+}
+
+void BufferPool::release(QByteArray &baBuffer)
+{
+    qint64 nCapacity = baBuffer.capacity();
+
+    if (baBuffer.isDetached() && (m_listBuffers.count() < m_nMaxBuffers) && ((m_nBytes + nCapacity) <= m_nMaxBytes)) {
+        m_nBytes += nCapacity;
+        m_listBuffers.append(baBuffer);
+    }
+
+    baBuffer = QByteArray();
+}
+
+qint64 BufferPool::getNumberOfHits() const
+{
+    return m_nNumberOfHits;
+}
+
+qint64 BufferPool::getNumberOfMisses() const
+{
+    return m_nNumberOfMisses;
+}
+
+void BufferPool::limitHeapArenas(qint32 nNumberOfArenas)
+{
+#ifdef __GLIBC__
+    mallopt(M_ARENA_MAX, qMax(1, nNumberOfArenas));
+#else
+    Q_UNUSED(nNumberOfArenas)
+#endif
+}
+
+void BufferPool::trimHeap()
+{
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#elif defined(Q_OS_WIN)
+    _heapmin();
+#endif
+}
@@ -0,0 +1,52 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <QByteArray>
+#include <QList>
+
+// Scratch buffers of one worker. Capacity is kept between files, so copy and read loops
+// stop going through malloc once the pool is warm. Not thread-safe.
+class BufferPool {
+public:
+    explicit BufferPool(qint32 nMaxBuffers = 8, qint64 nMaxBytes = 64 * 1024 * 1024);
+
+    QByteArray acquire(qint32 nSize);  // nSize bytes, contents undefined
+    void release(QByteArray &baBuffer);
+    qint64 getNumberOfHits() const;
+    qint64 getNumberOfMisses() const;
+
+    // glibc: caps the number of malloc arenas; per-thread arenas are what grows RSS in long batches
+    static void limitHeapArenas(qint32 nNumberOfArenas);
+    // Returns freed heap pages to the OS
+    static void trimHeap();
+
+private:
+    QList<QByteArray> m_listBuffers;
+    qint32 m_nMaxBuffers;
+    qint64 m_nMaxBytes;
+    qint64 m_nBytes;
+    qint64 m_nNumberOfHits;
+    qint64 m_nNumberOfMisses;
+};
+
+#endif  // BUFFERPOOL_H
@@ -0,0 +1,144 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "dedupstore.h"
+
+#include <QCoreApplication>
+
+DedupStore::DedupStore(const QString &sDirectory) : m_sDirectory(sDirectory), m_nNextTemp(0), m_nNumberOfDuplicates(0), m_nDuplicateSize(0)
+{
+    if (!m_sDirectory.isEmpty()) {
+        QDir().mkpath(m_sDirectory + QStringLiteral("/objects/tmp"));
+
+        // Objects of earlier runs stay valid, so the manifest grows with them
+        m_fileManifest.setFileName(m_sDirectory + QStringLiteral("/manifest.jsonl"));
+        m_fileManifest.open(QIODevice::WriteOnly | QIODevice::Append);
+    }
+}
+
+DedupStore::~DedupStore()
+{
+    if (m_fileManifest.isOpen()) {
+        m_fileManifest.close();
+    }
+
+    if (!m_sDirectory.isEmpty()) {
+        QDir().rmdir(m_sDirectory + QStringLiteral("/objects/tmp"));
+    }
+}
+
+QString DedupStore::getDirectory() const
+{
+    return m_sDirectory;
+}
+
+QString DedupStore::createTempFileName()
+{
+    QString sResult;
+
+    if (!m_sDirectory.isEmpty()) {
+        sResult = QStringLiteral("%1/objects/tmp/%2-%3.part")
+                      .arg(m_sDirectory, QString::number(QCoreApplication::applicationPid()), QString::number(m_nNextTemp.fetchAndAddOrdered(1)));
+    }
+
+    return sResult;
+}
+
+bool DedupStore::addObject(const QString &sTempFileName, const QByteArray &baHash, qint64 nSize)
+{
+    bool bResult = false;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (!m_setHashes.contains(baHash)) {
+            m_setHashes.insert(baHash);
+            bResult = true;
+        }
+    }
+
+    if (!bResult) {
+        m_nNumberOfDuplicates.ref();
+        m_nDuplicateSize.fetchAndAddOrdered(nSize);
+    }
+
+    if (!sTempFileName.isEmpty()) {
+        QString sObjectFileName = getObjectFileName(baHash);
+
+        // Rename is atomic: a reader of the store never sees a partial object
+        if ((!bResult) || QFileInfo::exists(sObjectFileName) || (!QDir().mkpath(QFileInfo(sObjectFileName).absolutePath())) ||
+            (!QFile::rename(sTempFileName, sObjectFileName))) {
+            QFile::remove(sTempFileName);
+        }
+    }
+
+    return bResult;
+}
+
+QString DedupStore::getObjectFileName(const QByteArray &baHash) const
+{
+    QString sHash = QString::fromLatin1(baHash.toHex());
+
+    return QStringLiteral("%1/objects/%2/%3").arg(m_sDirectory, sHash.left(2), sHash);
+}
+
+void DedupStore::addReference(const QString &sInputFileName, const QString &sPath, const QByteArray &baHash, qint64 nSize)
+{
+    QJsonObject jsRecord;
+    jsRecord.insert(QStringLiteral("input"), sInputFileName);
+    jsRecord.insert(QStringLiteral("path"), sPath);
+    jsRecord.insert(QStringLiteral("sha1"), QString::fromLatin1(baHash.toHex()));
+    jsRecord.insert(QStringLiteral("size"), (double)nSize);
+
+    QByteArray baLine = QJsonDocument(jsRecord).toJson(QJsonDocument::Compact);
+    baLine.append('\n');
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_fileManifest.isOpen()) {
+        m_fileManifest.write(baLine);
+    }
+}
+
+void DedupStore::flush()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_fileManifest.isOpen()) {
+        m_fileManifest.flush();
+    }
+}
+
+qint64 DedupStore::getNumberOfObjects() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_setHashes.count();
+}
+
+qint64 DedupStore::getNumberOfDuplicates() const
+{
+    return m_nNumberOfDuplicates.loadAcquire();
+}
+
+qint64 DedupStore::getDuplicateSize() const
+{
+    return m_nDuplicateSize.loadAcquire();
+}
@@ -0,0 +1,65 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef DEDUPSTORE_H
+#define DEDUPSTORE_H
+
+#include <QAtomicInteger>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+
+// Content-addressed output shared by all workers. Every distinct child is kept once as
+// objects/<2 hex>/<sha1>; manifest.jsonl maps each occurrence (input and entry path) to
+// its hash. Without a directory only the hashes are tracked, so duplicates are still
+// recognized and skipped by the scan.
+class DedupStore {
+public:
+    explicit DedupStore(const QString &sDirectory = QString());
+    ~DedupStore();
+
+    QString getDirectory() const;
+    // Unique name inside the store for a child that is being written; empty without a directory
+    QString createTempFileName();
+    // Moves sTempFileName to its object, or drops it if the object already exists; true: first copy in this run
+    bool addObject(const QString &sTempFileName, const QByteArray &baHash, qint64 nSize);
+    QString getObjectFileName(const QByteArray &baHash) const;
+    void addReference(const QString &sInputFileName, const QString &sPath, const QByteArray &baHash, qint64 nSize);
+    void flush();
+
+    qint64 getNumberOfObjects() const;
+    qint64 getNumberOfDuplicates() const;
+    qint64 getDuplicateSize() const;  // Bytes not written and not scanned again
+
+private:
+    QString m_sDirectory;
+    mutable QMutex m_mutex;
+    QSet<QByteArray> m_setHashes;
+    QFile m_fileManifest;
+    QAtomicInteger<qint64> m_nNextTemp;
+    QAtomicInteger<qint64> m_nNumberOfDuplicates;
+    QAtomicInteger<qint64> m_nDuplicateSize;
+};
+
+#endif  // DEDUPSTORE_H
@@ -0,0 +1,116 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "directorywatcher.h"
+
+DirectoryWatcher::DirectoryWatcher(QObject *pParent) : QObject(pParent), m_bIsRecursive(true)
+{
+    m_timerSettle.setSingleShot(true);
+    m_timerSettle.setInterval(2000);
+
+    connect(&m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(onDirectoryChanged(QString)));
+    connect(&m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(onFileChanged(QString)));
+    connect(&m_timerSettle, SIGNAL(timeout()), this, SIGNAL(changed()));
+}
+
+void DirectoryWatcher::setPaths(const QStringList &listPaths, bool bRecursive)
+{
+    m_bIsRecursive = bRecursive;
+
+    if (!m_watcher.directories().isEmpty()) {
+        m_watcher.removePaths(m_watcher.directories());
+    }
+
+    if (!m_watcher.files().isEmpty()) {
+        m_watcher.removePaths(m_watcher.files());
+    }
+
+    m_setDirectories.clear();
+
+    qint32 nNumberOfPaths = listPaths.count();
+
+    for (qint32 i = 0; i < nNumberOfPaths; i++) {
+        QFileInfo fi(listPaths.at(i));
+
+        if (fi.isDir()) {
+            addDirectory(fi.absoluteFilePath());
+        } else if (fi.isFile()) {
+            m_watcher.addPath(fi.absoluteFilePath());
+        }
+    }
+}
+
+void DirectoryWatcher::setSettleTime(qint32 nMilliseconds)
+{
+    m_timerSettle.setInterval(nMilliseconds);
+}
+
+void DirectoryWatcher::onDirectoryChanged(const QString &sPath)
+{
+    // New subdirectories have to be watched too
+    if (!QFileInfo(sPath).isDir()) {
+        // Removed; the watcher dropped it, so a directory created under the same name is new
+        m_setDirectories.remove(sPath);
+    } else if (m_bIsRecursive) {
+        addDirectory(sPath);
+    }
+
+    m_timerSettle.start();
+}
+
+void DirectoryWatcher::onFileChanged(const QString &sPath)
+{
+    // Editors and copy tools replace files; the watch is dropped with the old inode
+    if (QFileInfo::exists(sPath) && (!m_watcher.files().contains(sPath))) {
+        m_watcher.addPath(sPath);
+    }
+
+    m_timerSettle.start();
+}
+
+void DirectoryWatcher::addDirectory(const QString &sDirectory)
+{
+    QStringList listDirectories(sDirectory);
+
+    if (m_bIsRecursive) {
+        QDirIterator it(sDirectory, QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+        while (it.hasNext()) {
+            listDirectories.append(it.next());
+        }
+    }
+
+    QStringList listNew;
+
+    qint32 nNumberOfDirectories = listDirectories.count();
+
+    for (qint32 i = 0; i < nNumberOfDirectories; i++) {
+        const QString &sPath = listDirectories.at(i);
+
+        if (!m_setDirectories.contains(sPath)) {
+            m_setDirectories.insert(sPath);
+            listNew.append(sPath);
+        }
+    }
+
+    if (!listNew.isEmpty()) {
+        m_watcher.addPaths(listNew);
+    }
+}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QSet>
+#include <QTimer>
+
+// Watches input directories and their subdirectories. Bursts of changes (a copy in
+// progress, an archive being extracted into the share) end in one changed() signal
+// after the directory has been quiet for the settle time.
+class DirectoryWatcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit DirectoryWatcher(QObject *pParent = nullptr);
+
+    void setPaths(const QStringList &listPaths, bool bRecursive);
+    void setSettleTime(qint32 nMilliseconds);
+
+signals:
+    void changed();
+
+private slots:
+    void onDirectoryChanged(const QString &sPath);
+    void onFileChanged(const QString &sPath);
+
+private:
+    void addDirectory(const QString &sDirectory);
+
+    QFileSystemWatcher m_watcher;
+    QSet<QString> m_setDirectories;  // Watched; QFileSystemWatcher only has lists
+    QTimer m_timerSettle;
+    bool m_bIsRecursive;
+};
+
+#endif  // DIRECTORYWATCHER_H
@@ -0,0 +1,49 @@
+include_directories(${CMAKE_CURRENT_LIST_DIR})
+include_directories(${CMAKE_CURRENT_LIST_DIR}/../../dep/XArchive/3rdparty/bzip2/src)
+
+set(XFILEUNPACKER_ENGINE_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/asyncwriter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/asyncwriter.h
+    ${CMAKE_CURRENT_LIST_DIR}/batchjournal.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/batchjournal.h
+    ${CMAKE_CURRENT_LIST_DIR}/batchscheduler.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/batchscheduler.h
+    ${CMAKE_CURRENT_LIST_DIR}/bufferpool.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/bufferpool.h
+    ${CMAKE_CURRENT_LIST_DIR}/dedupstore.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/dedupstore.h
+    ${CMAKE_CURRENT_LIST_DIR}/directorywatcher.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/directorywatcher.h
+    ${CMAKE_CURRENT_LIST_DIR}/entryfilter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/entryfilter.h
+    ${CMAKE_CURRENT_LIST_DIR}/filestateindex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/filestateindex.h
+    ${CMAKE_CURRENT_LIST_DIR}/formattriage.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/formattriage.h
+    ${CMAKE_CURRENT_LIST_DIR}/limitwatchdog.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/limitwatchdog.h
+    ${CMAKE_CURRENT_LIST_DIR}/mappeddevice.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/mappeddevice.h
+    ${CMAKE_CURRENT_LIST_DIR}/memorybudget.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/memorybudget.h
+    ${CMAKE_CURRENT_LIST_DIR}/outputsink.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/outputsink.h
+    ${CMAKE_CURRENT_LIST_DIR}/paralleldecoder.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/paralleldecoder.h
+    ${CMAKE_CURRENT_LIST_DIR}/resultcache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/resultcache.h
+    ${CMAKE_CURRENT_LIST_DIR}/resultwriter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/resultwriter.h
+    ${CMAKE_CURRENT_LIST_DIR}/scanenginepool.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/scanenginepool.h
+    ${CMAKE_CURRENT_LIST_DIR}/signatureindex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/signatureindex.h
+    ${CMAKE_CURRENT_LIST_DIR}/signatureprefilter.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/signatureprefilter.h
+    ${CMAKE_CURRENT_LIST_DIR}/unpackengine.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/unpackengine.h
+    ${CMAKE_CURRENT_LIST_DIR}/unpackprofiler.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/unpackprofiler.h
+    ${CMAKE_CURRENT_LIST_DIR}/unpacktracer.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/unpacktracer.h
+)
@@ -0,0 +1,115 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "entryfilter.h"
+
+EntryFilter::EntryFilter()
+{
+}
+
+void EntryFilter::setPatterns(const QStringList &listPatterns)
+{
+    m_listPatterns = listPatterns;
+    m_listCompiled.clear();
+
+    qint32 nNumberOfPatterns = listPatterns.count();
+
+    for (qint32 i = 0; i < nNumberOfPatterns; i++) {
+        QStringList listParts = QString(listPatterns.at(i)).replace(QLatin1Char('\\'), QLatin1Char('/')).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        QVector<COMPONENT> listComponents;
+
+        qint32 nNumberOfParts = listParts.count();
+
+        for (qint32 j = 0; j < nNumberOfParts; j++) {
+            COMPONENT component = {};
+            component.bIsAnyLevels = (listParts.at(j) == QStringLiteral("**"));
+
+            if (!component.bIsAnyLevels) {
+                component.regExp = QRegularExpression(QRegularExpression::wildcardToRegularExpression(listParts.at(j)));
+                component.regExp.optimize();
+            }
+
+            listComponents.append(component);
+        }
+
+        if (!listComponents.isEmpty()) {
+            m_listCompiled.append(listComponents);
+        }
+    }
+}
+
+QStringList EntryFilter::getPatterns() const
+{
+    return m_listPatterns;
+}
+
+bool EntryFilter::isEmpty() const
+{
+    return m_listCompiled.isEmpty();
+}
+
+qint32 EntryFilter::match(const QString &sPath) const
+{
+    qint32 nResult = MATCH_NONE;
+
+    QStringList listPath = QString(sPath).replace(QLatin1Char('\\'), QLatin1Char('/')).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+
+    qint32 nNumberOfPatterns = m_listCompiled.count();
+
+    for (qint32 i = 0; (i < nNumberOfPatterns) && (nResult != (MATCH_TARGET | MATCH_PARENT)); i++) {
+        nResult |= matchComponents(m_listCompiled.at(i), 0, listPath, 0);
+    }
+
+    return nResult;
+}
+
+qint32 EntryFilter::matchComponents(const QVector<COMPONENT> &listPattern, qint32 nPattern, const QStringList &listPath, qint32 nPath)
+{
+    qint32 nResult = MATCH_NONE;
+
+    qint32 nPatternSize = listPattern.count();
+
+    if (nPath == listPath.count()) {
+        // The path ends here: a target if nothing but "**" is left, a parent if more is to come
+        bool bIsRestAny = true;
+
+        for (qint32 i = nPattern; (i < nPatternSize) && bIsRestAny; i++) {
+            bIsRestAny = listPattern.at(i).bIsAnyLevels;
+        }
+
+        if (bIsRestAny) {
+            nResult |= MATCH_TARGET;
+        }
+
+        if (nPattern < nPatternSize) {
+            nResult |= MATCH_PARENT;
+        }
+    } else if (nPattern < nPatternSize) {
+        const COMPONENT &component = listPattern.at(nPattern);
+
+        if (component.bIsAnyLevels) {
+            nResult = matchComponents(listPattern, nPattern + 1, listPath, nPath) | matchComponents(listPattern, nPattern, listPath, nPath + 1);
+        } else if (component.regExp.match(listPath.at(nPath)).hasMatch()) {
+            nResult = matchComponents(listPattern, nPattern + 1, listPath, nPath + 1);
+        }
+    }
+
+    return nResult;
+}
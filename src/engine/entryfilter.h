@@ -0,0 +1,60 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef ENTRYFILTER_H
+#define ENTRYFILTER_H
+
+#include <QRegularExpression>
+#include <QStringList>
+#include <QVector>
+
+// Entry selection by path from the input, one glob per level: "classes*.dex" matches
+// entries of the input, "lib/*/libfoo.so" and "inner.zip/payload.bin" go down the chain,
+// "**" spans any number of levels. An entry that can only contain a match is a parent:
+// it is decoded to get at its children but neither written nor reported as a target.
+class EntryFilter {
+public:
+    enum MATCH {
+        MATCH_NONE = 0,
+        MATCH_TARGET = 1,
+        MATCH_PARENT = 2  // Combined with MATCH_TARGET where a pattern ends here and another goes on
+    };
+
+    EntryFilter();
+
+    void setPatterns(const QStringList &listPatterns);
+    QStringList getPatterns() const;
+    bool isEmpty() const;
+
+    qint32 match(const QString &sPath) const;  // MATCH flags
+
+private:
+    struct COMPONENT {
+        bool bIsAnyLevels;  // "**"
+        QRegularExpression regExp;
+    };
+
+    static qint32 matchComponents(const QVector<COMPONENT> &listPattern, qint32 nPattern, const QStringList &listPath, qint32 nPath);
+
+    QStringList m_listPatterns;
+    QVector<QVector<COMPONENT>> m_listCompiled;
+};
+
+#endif  // ENTRYFILTER_H
@@ -0,0 +1,230 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "filestateindex.h"
+
+FileStateIndex::FileStateIndex(const QString &sFileName) : m_sFileName(sFileName), m_bIsModified(false)
+{
+}
+
+void FileStateIndex::setFileName(const QString &sFileName)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_sFileName = sFileName;
+}
+
+QString FileStateIndex::getFileName() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_sFileName;
+}
+
+bool FileStateIndex::load()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_mapStates.clear();
+    m_mapPendingHashes.clear();
+    m_bIsModified = false;
+
+    QFile file(m_sFileName);
+
+    // A missing index is an empty one: the first run processes everything
+    if (!file.exists()) {
+        return true;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonObject jsRoot = QJsonDocument::fromJson(file.readAll()).object();
+
+    file.close();
+
+    if (jsRoot.value(QStringLiteral("version")).toInt() != N_VERSION) {
+        return false;
+    }
+
+    QJsonObject jsFiles = jsRoot.value(QStringLiteral("files")).toObject();
+
+    for (QJsonObject::const_iterator it = jsFiles.constBegin(); it != jsFiles.constEnd(); ++it) {
+        QJsonObject jsState = it.value().toObject();
+
+        STATE state = {};
+        state.nSize = (qint64)jsState.value(QStringLiteral("size")).toDouble();
+        state.nModified = (qint64)jsState.value(QStringLiteral("mtime")).toDouble();
+        state.baHash = QByteArray::fromHex(jsState.value(QStringLiteral("hash")).toString().toLatin1());
+
+        m_mapStates.insert(it.key(), state);
+    }
+
+    return true;
+}
+
+bool FileStateIndex::save()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_bIsModified) {
+        return true;
+    }
+
+    QJsonObject jsFiles;
+
+    for (QHash<QString, STATE>::const_iterator it = m_mapStates.constBegin(); it != m_mapStates.constEnd(); ++it) {
+        QJsonObject jsState;
+        jsState.insert(QStringLiteral("size"), (double)it.value().nSize);
+        jsState.insert(QStringLiteral("mtime"), (double)it.value().nModified);
+        jsState.insert(QStringLiteral("hash"), QString::fromLatin1(it.value().baHash.toHex()));
+
+        jsFiles.insert(it.key(), jsState);
+    }
+
+    QJsonObject jsRoot;
+    jsRoot.insert(QStringLiteral("version"), N_VERSION);
+    jsRoot.insert(QStringLiteral("files"), jsFiles);
+
+    QDir().mkpath(QFileInfo(m_sFileName).absolutePath());
+
+    // An interrupted run keeps the previous index intact
+    QSaveFile file(m_sFileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    file.write(QJsonDocument(jsRoot).toJson(QJsonDocument::Compact));
+
+    bool bResult = file.commit();
+
+    if (bResult) {
+        m_bIsModified = false;
+    }
+
+    return bResult;
+}
+
+QList<BatchScheduler::ITEM> FileStateIndex::getChangedItems(const QList<BatchScheduler::ITEM> &listItems, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<BatchScheduler::ITEM> listResult;
+
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; (i < nNumberOfItems) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        const BatchScheduler::ITEM &item = listItems.at(i);
+
+        STATE state = {};
+        bool bIsKnown = false;
+
+        {
+            QMutexLocker locker(&m_mutex);
+
+            if (m_mapStates.contains(item.sFileName)) {
+                state = m_mapStates.value(item.sFileName);
+                bIsKnown = true;
+            }
+        }
+
+        if (bIsKnown && (state.nSize == item.nSize) && (state.nModified == item.nModified)) {
+            continue;
+        }
+
+        if (bIsKnown && (state.nSize == item.nSize)) {
+            // Touched, copied with a new mtime, restored from backup: the content decides.
+            // An entry without a hash cannot decide; the file is processed and its hash kept
+            QByteArray baHash = getFileHash(item.sFileName, pPdStruct);
+
+            QMutexLocker locker(&m_mutex);
+
+            if ((!baHash.isEmpty()) && (!state.baHash.isEmpty()) && (baHash == state.baHash)) {
+                m_mapStates[item.sFileName].nModified = item.nModified;
+                m_bIsModified = true;
+
+                continue;
+            }
+
+            m_mapPendingHashes.insert(item.sFileName, baHash);
+        }
+
+        listResult.append(item);
+    }
+
+    return listResult;
+}
+
+void FileStateIndex::setProcessed(const BatchScheduler::ITEM &item)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // New and resized files are not read again: size and mtime are compared first, and the hash
+    // is only taken once a later scan finds the size equal and the mtime moved
+    STATE state = {};
+    state.nSize = item.nSize;
+    state.nModified = item.nModified;
+    state.baHash = m_mapPendingHashes.take(item.sFileName);
+
+    m_mapStates.insert(item.sFileName, state);
+    m_bIsModified = true;
+}
+
+qint32 FileStateIndex::getNumberOfFiles() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapStates.count();
+}
+
+QByteArray FileStateIndex::getFileHash(const QString &sFileName, XBinary::PDSTRUCT *pPdStruct)
+{
+    QByteArray baResult;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+
+        const qint64 nBufferSize = 0x100000;
+        QByteArray baBuffer(nBufferSize, Qt::Uninitialized);
+
+        bool bIsValid = true;
+
+        while (XBinary::isPdStructNotCanceled(pPdStruct)) {
+            qint64 nRead = file.read(baBuffer.data(), nBufferSize);
+
+            if (nRead <= 0) {
+                bIsValid = (nRead == 0);
+                break;
+            }
+
+            hash.addData(baBuffer.constData(), (int)nRead);
+        }
+
+        if (bIsValid && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            baResult = hash.result();
+        }
+
+        file.close();
+    }
+
+    return baResult;
+}
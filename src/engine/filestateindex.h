@@ -0,0 +1,68 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FILESTATEINDEX_H
+#define FILESTATEINDEX_H
+
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+
+#include "batchscheduler.h"
+
+// Size, mtime and content hash of every input that was processed successfully. A file
+// with the same size and mtime is skipped without being read; if only the mtime moved,
+// the hash decides and an equal hash just refreshes the entry. The hash is taken then,
+// not when a file is first seen. Failed files stay out of the index, so the next run
+// retries them.
+class FileStateIndex {
+public:
+    struct STATE {
+        qint64 nSize;
+        qint64 nModified;   // ms since epoch
+        QByteArray baHash;  // Empty until the mtime moved once at the same size
+    };
+
+    explicit FileStateIndex(const QString &sFileName = QString());
+
+    void setFileName(const QString &sFileName);
+    QString getFileName() const;
+    bool load();
+    bool save();
+
+    QList<BatchScheduler::ITEM> getChangedItems(const QList<BatchScheduler::ITEM> &listItems, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    void setProcessed(const BatchScheduler::ITEM &item);  // Thread-safe; keeps the hash getChangedItems took, if any
+    qint32 getNumberOfFiles() const;
+
+    static QByteArray getFileHash(const QString &sFileName, XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+private:
+    static const qint32 N_VERSION = 1;
+
+    QString m_sFileName;
+    mutable QMutex m_mutex;
+    QHash<QString, STATE> m_mapStates;
+    QHash<QString, QByteArray> m_mapPendingHashes;  // Computed while filtering, stored once processed
+    bool m_bIsModified;
+};
+
+#endif  // FILESTATEINDEX_H
@@ -0,0 +1,236 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "formattriage.h"
+
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+const double FormatTriage::D_ENTROPY_PACKED = 7.2;
+
+FormatTriage::RESULT FormatTriage::classify(QIODevice *pDevice)
+{
+    qint64 nFileSize = pDevice->size();
+    qint64 nHeadSize = qMin(nFileSize, N_HEAD_SIZE);
+    qint64 nTailSize = qMin(qMax(nFileSize - nHeadSize, (qint64)0), N_TAIL_SIZE);
+
+    MappedDevice *pMappedDevice = qobject_cast<MappedDevice *>(pDevice);
+
+    if (pMappedDevice && pMappedDevice->data()) {
+        const char *pData = pMappedDevice->data();
+
+        return classify(pData, nHeadSize, pData + nFileSize - nTailSize, nTailSize, nFileSize, pDevice);
+    }
+
+    QByteArray baHead;
+    QByteArray baTail;
+
+    if (pDevice->seek(0)) {
+        baHead = pDevice->read(nHeadSize);
+    }
+
+    if ((nTailSize > 0) && pDevice->seek(nFileSize - nTailSize)) {
+        baTail = pDevice->read(nTailSize);
+    }
+
+    pDevice->seek(0);
+
+    return classify(baHead.constData(), baHead.size(), baTail.constData(), baTail.size(), nFileSize, pDevice);
+}
+
+FormatTriage::RESULT FormatTriage::classify(const char *pHead, qint64 nHeadSize, const char *pTail, qint64 nTailSize, qint64 nFileSize, QIODevice *pDevice)
+{
+    RESULT result = {};
+    result.verdict = VERDICT_SKIP;
+    result.dEntropy = -1;
+
+    // Fixed-offset anchors of the prefilter, plus formats it does not need because the scan follows anyway
+    static const MAGIC magicsDeep[] = {
+        {"\xED\xAB\xEE\xDB", 4, 0, "RPM"},
+        {"xar!", 4, 0, "XAR"},
+        {"MSWIM\x00\x00\x00", 8, 0, "WIM"},
+        {"FWS", 3, 0, "SWF"},
+        {"CWS", 3, 0, "SWF"},
+        {"ZWS", 3, 0, "SWF"},
+        {"\x28\xB5\x2F\xFD", 4, 0, "ZSTD"},
+        {"\x04\x22\x4D\x18", 4, 0, "LZ4"},
+        {"LZIP", 4, 0, "LZIP"},
+        {"\x5D\x00\x00", 3, 0, "LZMA"},
+        {"{\\rtf", 5, 0, "RTF"},
+        {"\x4C\x00\x00\x00\x01\x14\x02\x00", 8, 0, "LNK"},
+    };
+
+    // Media without embedded code; an appended archive is still caught by the tail check
+    static const MAGIC magicsSkip[] = {
+        {"\x89PNG\r\n\x1A\n", 8, 0, "PNG"},
+        {"\xFF\xD8\xFF", 3, 0, "JPEG"},
+        {"GIF87a", 6, 0, "GIF"},
+        {"GIF89a", 6, 0, "GIF"},
+        {"RIFF", 4, 0, "RIFF"},
+        {"ID3", 3, 0, "MP3"},
+        {"OggS", 4, 0, "OGG"},
+        {"fLaC", 4, 0, "FLAC"},
+        {"ftyp", 4, 4, "MP4"},
+        {"\x1A\x45\xDF\xA3", 4, 0, "Matroska"},
+    };
+
+    static const QList<SignaturePrefilter::ANCHOR> listAnchors = SignaturePrefilter::getDefaultAnchors();
+    qint32 nNumberOfAnchors = listAnchors.count();
+
+    // Floating anchors (ZIP, RAR, 7-Zip, OLE, PDF, packer sections, ...) are searched over the whole head:
+    // they are at offset 0 of a plain container and a few KB in behind a stub or a PDF preamble
+    QByteArray baHead = QByteArray::fromRawData(pHead, (int)nHeadSize);
+
+    for (qint32 i = 0; (i < nNumberOfAnchors) && result.sName.isEmpty(); i++) {
+        const SignaturePrefilter::ANCHOR &anchor = listAnchors.at(i);
+
+        bool bIsFound = false;
+
+        if (anchor.nOffset >= 0) {
+            bIsFound = compareAt(pHead, nHeadSize, anchor.nOffset, anchor.baPattern.constData(), anchor.baPattern.size(), pDevice);
+        } else {
+            bIsFound = (baHead.indexOf(anchor.baPattern) != -1);
+        }
+
+        if (bIsFound && isHeaderSane(anchor.baPattern, pHead, nHeadSize, nFileSize)) {
+            result.sName = anchor.sName;
+            result.verdict = VERDICT_DEEP;
+        }
+    }
+
+    qint32 nNumberOfMagics = sizeof(magicsDeep) / sizeof(magicsDeep[0]);
+
+    for (qint32 i = 0; (i < nNumberOfMagics) && result.sName.isEmpty(); i++) {
+        if (compareAt(pHead, nHeadSize, magicsDeep[i].nOffset, magicsDeep[i].pPattern, magicsDeep[i].nSize, pDevice)) {
+            result.sName = QString::fromLatin1(magicsDeep[i].pName);
+            result.verdict = VERDICT_DEEP;
+        }
+    }
+
+    if (result.sName.isEmpty()) {
+        // ZIP end of central directory; self-extractors and polyglots keep their archive at the end
+        const char *pSearch = (nTailSize > 0) ? pTail : pHead;
+        qint64 nSearchSize = (nTailSize > 0) ? nTailSize : nHeadSize;
+
+        for (qint64 i = nSearchSize - 22; i >= 0; i--) {
+            if (std::memcmp(pSearch + i, "PK\x05\x06", 4) == 0) {
+                result.sName = QStringLiteral("ZIP");
+                result.verdict = VERDICT_DEEP;
+                break;
+            }
+        }
+    }
+
+    nNumberOfMagics = sizeof(magicsSkip) / sizeof(magicsSkip[0]);
+
+    for (qint32 i = 0; (i < nNumberOfMagics) && result.sName.isEmpty(); i++) {
+        if (compareAt(pHead, nHeadSize, magicsSkip[i].nOffset, magicsSkip[i].pPattern, magicsSkip[i].nSize, pDevice)) {
+            result.sName = QString::fromLatin1(magicsSkip[i].pName);
+        }
+    }
+
+    if (result.sName.isEmpty()) {
+        result.dEntropy = getEntropy(pHead, nHeadSize);
+
+        if (result.dEntropy >= D_ENTROPY_PACKED) {
+            // Headerless compressed streams and custom packers
+            result.sName = QStringLiteral("Compressed");
+            result.verdict = VERDICT_DEEP;
+        } else {
+            bool bIsText = true;
+
+            for (qint64 i = 0; (i < nHeadSize) && bIsText; i++) {
+                quint8 nByte = (quint8)pHead[i];
+                bIsText = (nByte >= 0x20) || (nByte == '\t') || (nByte == '\n') || (nByte == '\r');
+            }
+
+            result.sName = bIsText ? QStringLiteral("Text") : QStringLiteral("Data");
+        }
+    }
+
+    return result;
+}
+
+double FormatTriage::getEntropy(const char *pData, qint64 nSize)
+{
+    double dResult = 0;
+
+    if (nSize > 0) {
+        quint32 counts[256] = {};
+
+        for (qint64 i = 0; i < nSize; i++) {
+            counts[(quint8)pData[i]]++;
+        }
+
+        for (qint32 i = 0; i < 256; i++) {
+            if (counts[i]) {
+                double dProbability = (double)counts[i] / nSize;
+                dResult -= dProbability * std::log2(dProbability);
+            }
+        }
+    }
+
+    return dResult;
+}
+
+bool FormatTriage::isHeaderSane(const QByteArray &baPattern, const char *pHead, qint64 nHeadSize, qint64 nFileSize)
+{
+    bool bResult = true;
+
+    // Two-byte magics also start plenty of text and data files
+    if (baPattern == QByteArrayLiteral("MZ")) {
+        if (nHeadSize >= 0x40) {
+            quint32 nLfanew = qFromLittleEndian<quint32>(pHead + 0x3C);
+            quint16 nPages = qFromLittleEndian<quint16>(pHead + 0x04);
+
+            bResult = ((nLfanew >= 0x40) && (nLfanew < (quint64)nFileSize)) || ((nPages > 0) && ((qint64)(nPages - 1) * 512 < nFileSize));
+        } else {
+            bResult = false;
+        }
+    } else if (baPattern == QByteArrayLiteral("#!")) {
+        bResult = (nHeadSize > 2) && ((pHead[2] == '/') || (pHead[2] == ' '));
+    } else if (baPattern == QByteArrayLiteral("\x1F\x8B")) {
+        bResult = (nHeadSize > 2) && (pHead[2] == 8);
+    }
+
+    return bResult;
+}
+
+bool FormatTriage::compareAt(const char *pHead, qint64 nHeadSize, qint64 nOffset, const char *pPattern, qint32 nSize, QIODevice *pDevice)
+{
+    bool bResult = false;
+
+    if ((nOffset + nSize) <= nHeadSize) {
+        bResult = (std::memcmp(pHead + nOffset, pPattern, nSize) == 0);
+    } else if (pDevice && ((nOffset + nSize) <= pDevice->size())) {
+        // Magics past the head (ISO 9660) cost a small read
+        char buffer[16];
+
+        if ((nSize <= (qint32)sizeof(buffer)) && pDevice->seek(nOffset)) {
+            bResult = (pDevice->read(buffer, nSize) == nSize) && (std::memcmp(buffer, pPattern, nSize) == 0);
+        }
+
+        pDevice->seek(0);
+    }
+
+    return bResult;
+}
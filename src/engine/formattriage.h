@@ -0,0 +1,69 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FORMATTRIAGE_H
+#define FORMATTRIAGE_H
+
+#include <QIODevice>
+
+#include "mappeddevice.h"
+#include "signatureprefilter.h"
+
+// Cheap first look at an input, from a few KB at the head and the tail. Tiers, first
+// match wins: a container/executable magic at its offset, or anywhere in the head for the
+// prefilter anchors that float, that passes its header sanity check, an
+// archive directory at the end (appended archives), a media format that carries nothing
+// to unpack, then the byte entropy of the head: compressed or encrypted data goes on,
+// plain data stops here.
+class FormatTriage {
+public:
+    enum VERDICT {
+        VERDICT_DEEP = 0,  // Detect, scan and unpack
+        VERDICT_SKIP
+    };
+
+    struct RESULT {
+        VERDICT verdict;
+        QString sName;    // Magic that decided, or "Data"/"Text"
+        double dEntropy;  // Bits per byte of the head; -1: not needed
+    };
+
+    static RESULT classify(QIODevice *pDevice);
+    static RESULT classify(const char *pHead, qint64 nHeadSize, const char *pTail, qint64 nTailSize, qint64 nFileSize, QIODevice *pDevice);
+    static double getEntropy(const char *pData, qint64 nSize);
+
+    static const qint64 N_HEAD_SIZE = 8 * 1024;
+    static const qint64 N_TAIL_SIZE = 4 * 1024;
+
+private:
+    struct MAGIC {
+        const char *pPattern;
+        qint32 nSize;
+        qint64 nOffset;
+        const char *pName;
+    };
+
+    static bool isHeaderSane(const QByteArray &baPattern, const char *pHead, qint64 nHeadSize, qint64 nFileSize);
+    static bool compareAt(const char *pHead, qint64 nHeadSize, qint64 nOffset, const char *pPattern, qint32 nSize, QIODevice *pDevice);
+
+    static const double D_ENTROPY_PACKED;  // Bits per byte at which the head counts as compressed
+};
+
+#endif  // FORMATTRIAGE_H
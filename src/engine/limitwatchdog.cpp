@@ -0,0 +1,137 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "limitwatchdog.h"
+
+LimitWatchdog *LimitWatchdog::getInstance()
+{
+    static LimitWatchdog watchdog;
+
+    return &watchdog;
+}
+
+LimitWatchdog::LimitWatchdog(QObject *pParent) : QThread(pParent), m_nNextId(0), m_bIsStopped(false)
+{
+    m_timer.start();
+}
+
+LimitWatchdog::~LimitWatchdog()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_bIsStopped = true;
+        m_waitCondition.wakeAll();
+    }
+
+    wait();
+}
+
+qint32 LimitWatchdog::add(XBinary::PDSTRUCT *pPdStruct, XBinary::PDSTRUCT *pParentPdStruct, qint64 nTimeout)
+{
+    QMutexLocker locker(&m_mutex);
+
+    WATCH watch = {};
+    watch.pPdStruct = pPdStruct;
+    watch.pParentPdStruct = pParentPdStruct;
+    watch.nDeadline = (nTimeout > 0) ? (m_timer.elapsed() + nTimeout) : -1;
+    watch.nMaxFileSize = -1;
+
+    qint32 nResult = m_nNextId++;
+    m_mapWatches.insert(nResult, watch);
+
+    // Started with the first input, so processes that never set a limit do not carry the thread
+    if (!isRunning()) {
+        start(QThread::LowPriority);
+    }
+
+    m_waitCondition.wakeAll();
+
+    return nResult;
+}
+
+void LimitWatchdog::watchFile(qint32 nId, const QString &sFileName, qint64 nMaxSize)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_mapWatches.contains(nId)) {
+        m_mapWatches[nId].sFileName = sFileName;
+        m_mapWatches[nId].nMaxFileSize = nMaxSize;
+    }
+}
+
+void LimitWatchdog::unwatchFile(qint32 nId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_mapWatches.contains(nId)) {
+        m_mapWatches[nId].sFileName.clear();
+        m_mapWatches[nId].nMaxFileSize = -1;
+    }
+}
+
+LimitWatchdog::REASON LimitWatchdog::getReason(qint32 nId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapWatches.value(nId).reason;
+}
+
+LimitWatchdog::REASON LimitWatchdog::remove(qint32 nId)
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapWatches.take(nId).reason;
+}
+
+void LimitWatchdog::run()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_bIsStopped) {
+        if (m_mapWatches.isEmpty()) {
+            m_waitCondition.wait(&m_mutex);
+            continue;
+        }
+
+        qint64 nCurrent = m_timer.elapsed();
+
+        for (QHash<qint32, WATCH>::iterator it = m_mapWatches.begin(); it != m_mapWatches.end(); ++it) {
+            WATCH &watch = it.value();
+
+            if (watch.reason != REASON_NONE) {
+                continue;
+            }
+
+            if ((watch.nDeadline != -1) && (nCurrent >= watch.nDeadline)) {
+                watch.reason = REASON_TIME;
+            } else if (watch.pParentPdStruct && (!XBinary::isPdStructNotCanceled(watch.pParentPdStruct))) {
+                watch.reason = REASON_CANCELED;
+            } else if ((watch.nMaxFileSize != -1) && (QFileInfo(watch.sFileName).size() > watch.nMaxFileSize)) {
+                watch.reason = REASON_OUTPUT;
+            }
+
+            if (watch.reason != REASON_NONE) {
+                watch.pPdStruct->bIsStop = true;
+            }
+        }
+
+        m_waitCondition.wait(&m_mutex, N_POLL_INTERVAL);
+    }
+}
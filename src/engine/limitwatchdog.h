@@ -0,0 +1,84 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef LIMITWATCHDOG_H
+#define LIMITWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "xbinary.h"
+
+// One thread for all workers. It stops the PDSTRUCT of an input when the input's deadline
+// passes, when its parent PDSTRUCT is stopped, or when a file being decompressed for it
+// grows past its limit. Decompressor loops poll the PDSTRUCT, so a hostile input is
+// abandoned within one poll interval instead of after the fact.
+class LimitWatchdog : public QThread {
+    Q_OBJECT
+
+public:
+    enum REASON {
+        REASON_NONE = 0,
+        REASON_TIME,
+        REASON_OUTPUT,
+        REASON_CANCELED
+    };
+
+    static LimitWatchdog *getInstance();
+
+    ~LimitWatchdog() override;
+
+    // nTimeout in ms, 0: none; returns the watch id
+    qint32 add(XBinary::PDSTRUCT *pPdStruct, XBinary::PDSTRUCT *pParentPdStruct, qint64 nTimeout);
+    void watchFile(qint32 nId, const QString &sFileName, qint64 nMaxSize);
+    void unwatchFile(qint32 nId);
+    REASON getReason(qint32 nId);
+    REASON remove(qint32 nId);
+
+protected:
+    void run() override;
+
+private:
+    struct WATCH {
+        XBinary::PDSTRUCT *pPdStruct;
+        XBinary::PDSTRUCT *pParentPdStruct;
+        qint64 nDeadline;  // On m_timer, ms; -1: none
+        QString sFileName;
+        qint64 nMaxFileSize;
+        REASON reason;
+    };
+
+    explicit LimitWatchdog(QObject *pParent = nullptr);
+
+    static const qint32 N_POLL_INTERVAL = 50;  // ms
+
+    QMutex m_mutex;
+    QWaitCondition m_waitCondition;
+    QHash<qint32, WATCH> m_mapWatches;
+    QElapsedTimer m_timer;
+    qint32 m_nNextId;
+    bool m_bIsStopped;
+};
+
+#endif  // LIMITWATCHDOG_H
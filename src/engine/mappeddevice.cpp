@@ -0,0 +1,179 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "mappeddevice.h"
+
+#include <cstring>
+
+MappedDevice::MappedDevice(const QString &sFileName, QObject *pParent) : QIODevice(pParent), m_file(sFileName), m_pData(nullptr), m_nSize(0)
+{
+}
+
+MappedDevice::~MappedDevice()
+{
+    close();
+}
+
+bool MappedDevice::open(OpenMode mode)
+{
+    bool bResult = false;
+
+    if (((mode & QIODevice::ReadWrite) == QIODevice::ReadOnly) && m_file.open(QIODevice::ReadOnly)) {
+        m_nSize = m_file.size();
+
+        if (m_nSize > 0) {
+            if ((sizeof(void *) > 4) || (m_nSize < 0x7FFFFFFF)) {
+                m_pData = m_file.map(0, m_nSize);
+            }
+
+            bResult = (m_pData != nullptr);
+        } else {
+            bResult = true;
+        }
+
+        if (bResult) {
+            bResult = QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+        }
+
+        if (!bResult) {
+            m_file.close();
+            m_pData = nullptr;
+            m_nSize = 0;
+        }
+    }
+
+    return bResult;
+}
+
+void MappedDevice::close()
+{
+    if (isOpen()) {
+        QIODevice::close();
+    }
+
+    if (m_pData) {
+        m_file.unmap(m_pData);
+        m_pData = nullptr;
+    }
+
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_nSize = 0;
+}
+
+bool MappedDevice::isSequential() const
+{
+    return false;
+}
+
+qint64 MappedDevice::size() const
+{
+    return m_nSize;
+}
+
+bool MappedDevice::seek(qint64 nPos)
+{
+    bool bResult = false;
+
+    if ((nPos >= 0) && (nPos <= m_nSize)) {
+        bResult = QIODevice::seek(nPos);
+    }
+
+    return bResult;
+}
+
+const char *MappedDevice::data() const
+{
+    return (const char *)m_pData;
+}
+
+QString MappedDevice::fileName() const
+{
+    return m_file.fileName();
+}
+
+bool MappedDevice::isMappable(const QString &sFileName)
+{
+    bool bResult = false;
+
+    if ((!sFileName.startsWith(QStringLiteral("//"))) && (!sFileName.startsWith(QStringLiteral("\\\\")))) {
+        QStorageInfo storageInfo(sFileName);
+
+        if (storageInfo.isValid()) {
+            const QString sFileSystemType = QString::fromLatin1(storageInfo.fileSystemType()).toLower();
+
+            bResult = !(sFileSystemType.startsWith(QStringLiteral("nfs")) || (sFileSystemType == QStringLiteral("cifs")) || sFileSystemType.startsWith(QStringLiteral("smb")) ||
+                        (sFileSystemType == QStringLiteral("9p")) || (sFileSystemType == QStringLiteral("afs")) || (sFileSystemType == QStringLiteral("davfs")) ||
+                        (sFileSystemType == QStringLiteral("webdav")) || sFileSystemType.startsWith(QStringLiteral("fuse.sshfs")));
+        }
+    }
+
+    return bResult;
+}
+
+QIODevice *MappedDevice::createInputDevice(const QString &sFileName, bool bMemoryMap, QObject *pParent)
+{
+    QIODevice *pResult = nullptr;
+
+    if (bMemoryMap && isMappable(sFileName)) {
+        MappedDevice *pMappedDevice = new MappedDevice(sFileName, pParent);
+
+        if (pMappedDevice->open(QIODevice::ReadOnly)) {
+            pResult = pMappedDevice;
+        } else {
+            delete pMappedDevice;
+        }
+    }
+
+    if (!pResult) {
+        QFile *pFile = new QFile(sFileName, pParent);
+
+        if (pFile->open(QIODevice::ReadOnly)) {
+            pResult = pFile;
+        } else {
+            delete pFile;
+        }
+    }
+
+    return pResult;
+}
+
+qint64 MappedDevice::readData(char *pData, qint64 nMaxSize)
+{
+    qint64 nResult = qMin(nMaxSize, m_nSize - pos());
+
+    if (nResult > 0) {
+        std::memcpy(pData, m_pData + pos(), (size_t)nResult);
+    } else {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+qint64 MappedDevice::writeData(const char *pData, qint64 nMaxSize)
+{
+    Q_UNUSED(pData)
+    Q_UNUSED(nMaxSize)
+
+    return -1;
+}
@@ -0,0 +1,60 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MAPPEDDEVICE_H
+#define MAPPEDDEVICE_H
+
+#include <QFile>
+#include <QStorageInfo>
+
+// Read-only QIODevice over a memory-mapped file. Reads are served straight from the
+// mapping (the device is unbuffered), and data() gives parsers the bytes without a copy.
+class MappedDevice : public QIODevice {
+    Q_OBJECT
+
+public:
+    explicit MappedDevice(const QString &sFileName, QObject *pParent = nullptr);
+    ~MappedDevice() override;
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 size() const override;
+    bool seek(qint64 nPos) override;
+
+    const char *data() const;
+    QString fileName() const;
+
+    // False for network filesystems, where a mapping can fault on a dropped connection
+    static bool isMappable(const QString &sFileName);
+    // Opened MappedDevice if possible, otherwise an opened QFile; nullptr on error
+    static QIODevice *createInputDevice(const QString &sFileName, bool bMemoryMap, QObject *pParent = nullptr);
+
+protected:
+    qint64 readData(char *pData, qint64 nMaxSize) override;
+    qint64 writeData(const char *pData, qint64 nMaxSize) override;
+
+private:
+    QFile m_file;
+    uchar *m_pData;
+    qint64 m_nSize;
+};
+
+#endif  // MAPPEDDEVICE_H
@@ -0,0 +1,78 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "memorybudget.h"
+
+MemoryBudget::MemoryBudget(qint64 nLimit) : m_nLimit(nLimit), m_nUsed(0), m_nPeak(0)
+{
+}
+
+void MemoryBudget::setLimit(qint64 nLimit)
+{
+    m_nLimit.storeRelease(nLimit);
+}
+
+qint64 MemoryBudget::getLimit() const
+{
+    return m_nLimit.loadAcquire();
+}
+
+bool MemoryBudget::tryAcquire(qint64 nSize)
+{
+    bool bResult = false;
+
+    qint64 nLimit = m_nLimit.loadAcquire();
+    qint64 nUsed = m_nUsed.loadAcquire();
+
+    while (true) {
+        qint64 nNewUsed = nUsed + nSize;
+
+        if ((nLimit > 0) && (nNewUsed > nLimit)) {
+            break;
+        }
+
+        if (m_nUsed.testAndSetOrdered(nUsed, nNewUsed, nUsed)) {
+            qint64 nPeak = m_nPeak.loadAcquire();
+
+            while ((nNewUsed > nPeak) && (!m_nPeak.testAndSetOrdered(nPeak, nNewUsed, nPeak))) {
+            }
+
+            bResult = true;
+            break;
+        }
+    }
+
+    return bResult;
+}
+
+void MemoryBudget::release(qint64 nSize)
+{
+    m_nUsed.fetchAndAddOrdered(-nSize);
+}
+
+qint64 MemoryBudget::getUsed() const
+{
+    return m_nUsed.loadAcquire();
+}
+
+qint64 MemoryBudget::getPeak() const
+{
+    return m_nPeak.loadAcquire();
+}
@@ -0,0 +1,45 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QAtomicInteger>
+
+// Bytes held by in-flight buffers of all pipelines. Reservations are made before a
+// buffer is filled, so the limit holds across workers and nesting levels.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(qint64 nLimit = 0);
+
+    void setLimit(qint64 nLimit);  // 0: unlimited
+    qint64 getLimit() const;
+    bool tryAcquire(qint64 nSize);
+    void release(qint64 nSize);
+    qint64 getUsed() const;
+    qint64 getPeak() const;
+
+private:
+    QAtomicInteger<qint64> m_nLimit;
+    QAtomicInteger<qint64> m_nUsed;
+    QAtomicInteger<qint64> m_nPeak;
+};
+
+#endif  // MEMORYBUDGET_H
@@ -0,0 +1,317 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "outputsink.h"
+
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+static void _writeOctal(char *pDest, qint32 nWidth, quint64 nValue)
+{
+    // nWidth - 1 digits and a terminating NUL
+    for (qint32 i = nWidth - 2; i >= 0; i--) {
+        pDest[i] = (char)('0' + (nValue & 7));
+        nValue >>= 3;
+    }
+
+    pDest[nWidth - 1] = 0;
+}
+
+OutputSink::OutputSink(QIODevice *pDevice) : m_pDevice(pDevice), m_bIsFinished(false)
+{
+}
+
+OutputSink::~OutputSink()
+{
+    delete m_pDevice;
+}
+
+OutputSink::FORMAT OutputSink::stringToFormat(const QString &sString)
+{
+    FORMAT result = FORMAT_UNKNOWN;
+
+    QString _sString = sString.toLower();
+
+    if (_sString == QStringLiteral("tar")) {
+        result = FORMAT_TAR;
+    } else if (_sString == QStringLiteral("frames")) {
+        result = FORMAT_FRAMES;
+    }
+
+    return result;
+}
+
+OutputSink *OutputSink::create(FORMAT format, const QString &sTarget, QString *pErrorString)
+{
+    OutputSink *pResult = nullptr;
+
+    QFile *pFile = new QFile;
+    bool bIsOpened = false;
+
+    if (sTarget == QStringLiteral("-")) {
+#ifdef Q_OS_WIN
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        std::fflush(stdout);
+        bIsOpened = pFile->open(fileno(stdout), QIODevice::WriteOnly | QIODevice::Unbuffered, QFileDevice::DontCloseHandle);
+    } else {
+#ifdef Q_OS_UNIX
+        if (!QFileInfo::exists(sTarget)) {
+            mkfifo(QFile::encodeName(sTarget).constData(), 0600);
+        }
+#endif
+        // Opening a FIFO blocks until the reader connects
+        pFile->setFileName(sTarget);
+        bIsOpened = pFile->open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+    }
+
+    if (!bIsOpened) {
+        if (pErrorString) {
+            *pErrorString = QStringLiteral("Cannot open: %1").arg(sTarget);
+        }
+
+        delete pFile;
+    } else if (format == FORMAT_TAR) {
+        pResult = new TarOutputSink(pFile);
+    } else if (format == FORMAT_FRAMES) {
+        pResult = new FramedOutputSink(pFile);
+    } else {
+        if (pErrorString) {
+            *pErrorString = QStringLiteral("Unknown stream format");
+        }
+
+        delete pFile;
+    }
+
+    return pResult;
+}
+
+bool OutputSink::writeEntry(const QString &sName, QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_bIsFinished) {
+        return false;
+    }
+
+    QByteArray baName = QDir::fromNativeSeparators(sName).toUtf8();
+    qint64 nSize = pDevice->size();
+
+    pDevice->seek(0);
+
+    bool bResult = writeHeader(baName, nSize);
+
+    if (bResult) {
+        const qint64 nBufferSize = 0x100000;
+
+        // One block for the life of the sink; writers are serialized anyway
+        if (m_baBuffer.size() != nBufferSize) {
+            m_baBuffer.resize(nBufferSize);
+        }
+
+        QByteArray &baBuffer = m_baBuffer;
+
+        qint64 nWritten = 0;
+
+        while (bResult && (nWritten < nSize) && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            qint64 nRead = pDevice->read(baBuffer.data(), qMin(nBufferSize, nSize - nWritten));
+
+            if (nRead <= 0) {
+                break;
+            }
+
+            bResult = writeBuffer(baBuffer.constData(), nRead);
+            nWritten += nRead;
+        }
+
+        if (bResult && (nWritten < nSize)) {
+            // The header already promised nSize bytes; zeros keep the stream parseable
+            baBuffer.fill(0);
+
+            while (bResult && (nWritten < nSize)) {
+                qint64 nZeros = qMin(nBufferSize, nSize - nWritten);
+                bResult = writeBuffer(baBuffer.constData(), nZeros);
+                nWritten += nZeros;
+            }
+
+            bResult = false;
+        }
+
+        if (nWritten == nSize) {
+            if (!writeTrailer(nSize)) {
+                bResult = false;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+bool OutputSink::finish()
+{
+    QMutexLocker locker(&m_mutex);
+
+    bool bResult = false;
+
+    if (!m_bIsFinished) {
+        m_bIsFinished = true;
+        bResult = writeEnd();
+    }
+
+    return bResult;
+}
+
+bool OutputSink::writeBuffer(const char *pData, qint64 nSize)
+{
+    return (m_pDevice->write(pData, nSize) == nSize);
+}
+
+TarOutputSink::TarOutputSink(QIODevice *pDevice) : OutputSink(pDevice)
+{
+}
+
+bool TarOutputSink::writeHeader(const QByteArray &baName, qint64 nSize)
+{
+    bool bResult = true;
+
+    if (baName.size() > 100) {
+        QByteArray baLongName = baName;
+        baLongName.append('\0');
+
+        bResult = writeBlock(QByteArrayLiteral("././@LongLink"), 'L', baLongName.size()) && writeBuffer(baLongName.constData(), baLongName.size()) &&
+                  writePadding(baLongName.size());
+    }
+
+    if (bResult) {
+        bResult = writeBlock(baName.left(100), '0', nSize);
+    }
+
+    return bResult;
+}
+
+bool TarOutputSink::writeTrailer(qint64 nSize)
+{
+    return writePadding(nSize);
+}
+
+bool TarOutputSink::writeEnd()
+{
+    char zeros[1024] = {};
+
+    return writeBuffer(zeros, sizeof(zeros));
+}
+
+bool TarOutputSink::writeBlock(const QByteArray &baName, char cType, qint64 nSize)
+{
+    char header[512] = {};
+
+    std::memcpy(header, baName.constData(), qMin(baName.size(), 100));
+    _writeOctal(header + 100, 8, 0644);
+    _writeOctal(header + 108, 8, 0);
+    _writeOctal(header + 116, 8, 0);
+
+    if ((quint64)nSize < 077777777777ULL) {
+        _writeOctal(header + 124, 12, (quint64)nSize);
+    } else {
+        // GNU base-256 for entries of 8 GiB and more
+        header[124] = (char)0x80;
+
+        quint64 nValue = (quint64)nSize;
+
+        for (qint32 i = 135; i > 124; i--) {
+            header[i] = (char)(nValue & 0xFF);
+            nValue >>= 8;
+        }
+    }
+
+    _writeOctal(header + 136, 12, (quint64)QDateTime::currentSecsSinceEpoch());
+    std::memset(header + 148, ' ', 8);
+    header[156] = cType;
+    std::memcpy(header + 257, "ustar", 6);
+    std::memcpy(header + 263, "00", 2);
+
+    quint32 nChecksum = 0;
+
+    for (qint32 i = 0; i < 512; i++) {
+        nChecksum += (quint8)header[i];
+    }
+
+    _writeOctal(header + 148, 7, nChecksum);
+    header[155] = ' ';
+
+    return writeBuffer(header, sizeof(header));
+}
+
+bool TarOutputSink::writePadding(qint64 nSize)
+{
+    bool bResult = true;
+
+    qint64 nPadding = (512 - (nSize % 512)) % 512;
+
+    if (nPadding) {
+        char zeros[512] = {};
+        bResult = writeBuffer(zeros, nPadding);
+    }
+
+    return bResult;
+}
+
+FramedOutputSink::FramedOutputSink(QIODevice *pDevice) : OutputSink(pDevice)
+{
+}
+
+bool FramedOutputSink::writeHeader(const QByteArray &baName, qint64 nSize)
+{
+    char nameSize[4];
+    char dataSize[8];
+
+    qToLittleEndian<quint32>((quint32)baName.size(), nameSize);
+    qToLittleEndian<quint64>((quint64)nSize, dataSize);
+
+    return writeBuffer(nameSize, sizeof(nameSize)) && writeBuffer(baName.constData(), baName.size()) && writeBuffer(dataSize, sizeof(dataSize));
+}
+
+bool FramedOutputSink::writeTrailer(qint64 nSize)
+{
+    Q_UNUSED(nSize)
+
+    return true;
+}
+
+bool FramedOutputSink::writeEnd()
+{
+    // A frame with an empty name ends the stream
+    char nameSize[4] = {};
+
+    return writeBuffer(nameSize, sizeof(nameSize));
+}
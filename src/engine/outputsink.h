@@ -0,0 +1,91 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <QDir>
+#include <QFile>
+#include <QMutex>
+
+#include "xbinary.h"
+
+// Receives extracted entries instead of the output directory. Entries are copied from the
+// child device in blocks as they arrive; a full pipe blocks the writing worker, and the
+// other workers wait on the sink lock, so a slow reader throttles the whole batch.
+class OutputSink {
+public:
+    enum FORMAT {
+        FORMAT_UNKNOWN = 0,
+        FORMAT_TAR,    // POSIX ustar, GNU long names
+        FORMAT_FRAMES  // Per entry: u32 LE name size, UTF-8 name, u64 LE data size, data
+    };
+
+    explicit OutputSink(QIODevice *pDevice);  // Takes ownership of pDevice
+    virtual ~OutputSink();
+
+    static FORMAT stringToFormat(const QString &sString);
+    // sTarget: "-" for stdout, otherwise a named pipe (created on Unix if missing) or a file
+    static OutputSink *create(FORMAT format, const QString &sTarget, QString *pErrorString);
+
+    // Thread-safe; entries never interleave
+    bool writeEntry(const QString &sName, QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct);
+    bool finish();
+
+protected:
+    virtual bool writeHeader(const QByteArray &baName, qint64 nSize) = 0;
+    virtual bool writeTrailer(qint64 nSize) = 0;
+    virtual bool writeEnd() = 0;
+
+    bool writeBuffer(const char *pData, qint64 nSize);
+
+    QIODevice *m_pDevice;
+
+private:
+    QMutex m_mutex;
+    QByteArray m_baBuffer;
+    bool m_bIsFinished;
+};
+
+class TarOutputSink : public OutputSink {
+public:
+    explicit TarOutputSink(QIODevice *pDevice);
+
+protected:
+    bool writeHeader(const QByteArray &baName, qint64 nSize) override;
+    bool writeTrailer(qint64 nSize) override;
+    bool writeEnd() override;
+
+private:
+    bool writeBlock(const QByteArray &baName, char cType, qint64 nSize);
+    bool writePadding(qint64 nSize);
+};
+
+class FramedOutputSink : public OutputSink {
+public:
+    explicit FramedOutputSink(QIODevice *pDevice);
+
+protected:
+    bool writeHeader(const QByteArray &baName, qint64 nSize) override;
+    bool writeTrailer(qint64 nSize) override;
+    bool writeEnd() override;
+};
+
+#endif  // OUTPUTSINK_H
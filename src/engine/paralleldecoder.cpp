@@ -0,0 +1,459 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "paralleldecoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+#include "bzlib.h"
+#include "unpacktracer.h"
+
+namespace {
+
+const quint64 N_BZIP2_BLOCK_MAGIC = 0x314159265359ULL;
+const quint64 N_BZIP2_EOS_MAGIC = 0x177245385090ULL;
+const quint64 N_MAGIC_MASK = 0xFFFFFFFFFFFFULL;
+
+struct _BITWRITER {
+    QByteArray *pData;
+    quint64 nBuffer;
+    qint32 nNumberOfBits;
+};
+
+void _writeBits(_BITWRITER *pWriter, quint32 nValue, qint32 nCount)
+{
+    // MSB first, as bzip2 reads them; nCount <= 32
+    pWriter->nBuffer = (pWriter->nBuffer << nCount) | (nValue & (quint32)((1ULL << nCount) - 1));
+    pWriter->nNumberOfBits += nCount;
+
+    while (pWriter->nNumberOfBits >= 8) {
+        pWriter->pData->append((char)((pWriter->nBuffer >> (pWriter->nNumberOfBits - 8)) & 0xFF));
+        pWriter->nNumberOfBits -= 8;
+    }
+
+    pWriter->nBuffer &= (1ULL << pWriter->nNumberOfBits) - 1;
+}
+
+void _flushBits(_BITWRITER *pWriter)
+{
+    if (pWriter->nNumberOfBits) {
+        _writeBits(pWriter, 0, 8 - pWriter->nNumberOfBits);
+    }
+}
+
+// Decoder state and the block window (~3.6 MB at level 9) are the same sizes every time, so each
+// pool thread keeps its last few and BZ2_bzDecompressInit stops hitting malloc after the first block
+const size_t N_BZALLOC_HEADER = 16;
+const size_t N_BZALLOC_CACHE_MAX = 16 * 1024 * 1024;
+
+struct _BZALLOCCACHE {
+    QList<void *> listBlocks;
+    size_t nBytes = 0;
+
+    ~_BZALLOCCACHE()
+    {
+        qint32 nNumberOfBlocks = listBlocks.count();
+
+        for (qint32 i = 0; i < nNumberOfBlocks; i++) {
+            free(listBlocks.at(i));
+        }
+    }
+};
+
+thread_local _BZALLOCCACHE g_bzAllocCache;
+
+void *_bzAlloc(void *pOpaque, int nItems, int nSize)
+{
+    Q_UNUSED(pOpaque)
+
+    size_t nBlockSize = (size_t)nItems * (size_t)nSize;
+    void *pResult = nullptr;
+
+    qint32 nNumberOfBlocks = g_bzAllocCache.listBlocks.count();
+
+    for (qint32 i = 0; i < nNumberOfBlocks; i++) {
+        if (*(size_t *)g_bzAllocCache.listBlocks.at(i) == nBlockSize) {
+            pResult = g_bzAllocCache.listBlocks.takeAt(i);
+            g_bzAllocCache.nBytes -= nBlockSize;
+            break;
+        }
+    }
+
+    if (!pResult) {
+        pResult = malloc(N_BZALLOC_HEADER + nBlockSize);
+
+        if (!pResult) {
+            return nullptr;
+        }
+
+        *(size_t *)pResult = nBlockSize;
+    }
+
+    return (char *)pResult + N_BZALLOC_HEADER;
+}
+
+void _bzFree(void *pOpaque, void *pAddress)
+{
+    Q_UNUSED(pOpaque)
+
+    if (pAddress) {
+        void *pBlock = (char *)pAddress - N_BZALLOC_HEADER;
+        size_t nBlockSize = *(size_t *)pBlock;
+
+        if ((g_bzAllocCache.nBytes + nBlockSize) <= N_BZALLOC_CACHE_MAX) {
+            g_bzAllocCache.listBlocks.append(pBlock);
+            g_bzAllocCache.nBytes += nBlockSize;
+        } else {
+            free(pBlock);
+        }
+    }
+}
+
+quint32 _readBits(const quint8 *pData, qint64 nSize, qint64 nBitOffset, qint32 nCount)
+{
+    quint32 nResult = 0;
+
+    for (qint32 i = 0; i < nCount; i++) {
+        qint64 nBit = nBitOffset + i;
+        quint32 nValue = 0;
+
+        if ((nBit >> 3) < nSize) {
+            nValue = (pData[nBit >> 3] >> (7 - (nBit & 7))) & 1;
+        }
+
+        nResult = (nResult << 1) | nValue;
+    }
+
+    return nResult;
+}
+
+}  // namespace
+
+QList<ParallelDecoder::BLOCK> ParallelDecoder::findBzip2Blocks(const char *pData, qint64 nSize, QThreadPool *pThreadPool, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<BLOCK> listResult;
+
+    // The marker search itself is split across the pool; ranges overlap by the magic size
+    qint32 nNumberOfRanges = qMax(1, pThreadPool ? pThreadPool->maxThreadCount() : 1);
+    qint64 nRangeSize = (nSize + nNumberOfRanges - 1) / nNumberOfRanges;
+
+    QList<QFuture<QList<MARKER>>> listFutures;
+
+    for (qint32 i = 0; i < nNumberOfRanges; i++) {
+        qint64 nBegin = i * nRangeSize;
+        qint64 nEnd = qMin(nSize, nBegin + nRangeSize);
+
+        if (nBegin >= nEnd) {
+            break;
+        }
+
+        if (pThreadPool) {
+            listFutures.append(QtConcurrent::run(pThreadPool, [pData, nBegin, nEnd, nSize, pPdStruct]() { return findBzip2Markers(pData, nBegin, nEnd, nSize, pPdStruct); }));
+        } else {
+            listFutures.append(QtConcurrent::run([pData, nBegin, nEnd, nSize, pPdStruct]() { return findBzip2Markers(pData, nBegin, nEnd, nSize, pPdStruct); }));
+        }
+    }
+
+    QList<MARKER> listMarkers;
+
+    qint32 nNumberOfFutures = listFutures.count();
+
+    for (qint32 i = 0; i < nNumberOfFutures; i++) {
+        listMarkers.append(listFutures[i].result());
+    }
+
+    qint32 nNumberOfMarkers = listMarkers.count();
+
+    for (qint32 i = 0; i < nNumberOfMarkers; i++) {
+        if (listMarkers.at(i).bIsEndOfStream) {
+            continue;
+        }
+
+        BLOCK block = {};
+        block.nBitOffset = listMarkers.at(i).nBitOffset;
+
+        if ((i + 1) < nNumberOfMarkers) {
+            block.nBitSize = listMarkers.at(i + 1).nBitOffset - block.nBitOffset;
+        } else {
+            // No end-of-stream marker: truncated input
+            break;
+        }
+
+        listResult.append(block);
+    }
+
+    return listResult;
+}
+
+qint64 ParallelDecoder::decompressBzip2ToDevice(const char *pData, qint64 nSize, qint64 nMaxSize, QIODevice *pOutput, QThreadPool *pThreadPool, bool *pIsValid,
+                                                XBinary::PDSTRUCT *pPdStruct)
+{
+    qint64 nResult = 0;
+    bool bResult = false;
+
+    if ((nSize >= 4) && (pData[0] == 'B') && (pData[1] == 'Z') && (pData[2] == 'h')) {
+        QList<BLOCK> listBlocks = findBzip2Blocks(pData, nSize, pThreadPool, pPdStruct);
+
+        qint32 nNumberOfBlocks = listBlocks.count();
+
+        if (nNumberOfBlocks && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            // Only a window of blocks is in flight and each is written as soon as its turn comes,
+            // so memory follows the number of threads, not the size of the payload
+            qint32 nWindow = 2 * qMax(1, pThreadPool ? pThreadPool->maxThreadCount() : QThreadPool::globalInstance()->maxThreadCount());
+
+            QList<QFuture<QByteArray>> listFutures;
+            QAtomicInt nIsStopped(0);
+            QAtomicInt *pIsStopped = &nIsStopped;
+            qint32 nNext = 0;
+
+            bResult = true;
+
+            for (qint32 i = 0; i < nNumberOfBlocks; i++) {
+                while ((nNext < nNumberOfBlocks) && ((nNext - i) < nWindow)) {
+                    BLOCK block = listBlocks.at(nNext);
+
+                    auto decodeBlock = [pData, nSize, block, pIsStopped, pPdStruct]() {
+                        XFU_TRACE_ZONE("bzip2 block");
+
+                        QByteArray baBlock;
+
+                        if (XBinary::isPdStructNotCanceled(pPdStruct) && (!pIsStopped->loadAcquire())) {
+                            QByteArray baStream = wrapBzip2Block(pData, nSize, block);
+
+                            if (!decompressBzip2Stream(baStream, &baBlock)) {
+                                baBlock.clear();
+                            }
+                        }
+
+                        return baBlock;
+                    };
+
+                    if (pThreadPool) {
+                        listFutures.append(QtConcurrent::run(pThreadPool, decodeBlock));
+                    } else {
+                        listFutures.append(QtConcurrent::run(decodeBlock));
+                    }
+
+                    nNext++;
+                }
+
+                QByteArray baBlock = listFutures.takeFirst().result();
+
+                // A block never decodes to nothing; empty means a bad split or a CRC error
+                if (baBlock.isEmpty() || (pOutput->write(baBlock) != baBlock.size())) {
+                    bResult = false;
+                    break;
+                }
+
+                nResult += baBlock.size();
+
+                if ((nMaxSize > 0) && (nResult > nMaxSize)) {
+                    // The caller sees the oversized output and reports the limit
+                    break;
+                }
+            }
+
+            // Blocks still queued see the stop and return at once; the running ones still use pData
+            nIsStopped.storeRelease(1);
+
+            qint32 nNumberOfFutures = listFutures.count();
+
+            for (qint32 i = 0; i < nNumberOfFutures; i++) {
+                listFutures[i].waitForFinished();
+            }
+
+            bResult = bResult && XBinary::isPdStructNotCanceled(pPdStruct);
+        }
+    }
+
+    if (pIsValid) {
+        *pIsValid = bResult;
+    }
+
+    return nResult;
+}
+
+QByteArray ParallelDecoder::decompressBzip2(const char *pData, qint64 nSize, qint64 nMaxSize, QThreadPool *pThreadPool, bool *pIsValid,
+                                            XBinary::PDSTRUCT *pPdStruct)
+{
+    QByteArray baResult;
+    bool bResult = false;
+
+    // Decoding stops once the buffer passes half the QByteArray limit; the block that crossed it still fits
+    qint64 nCapacity = std::numeric_limits<int>::max() / 2;
+    qint64 nLimit = (nMaxSize > 0) ? qMin(nMaxSize, nCapacity) : nCapacity;
+
+    QBuffer buffer(&baResult);
+
+    if (buffer.open(QIODevice::WriteOnly)) {
+        qint64 nWritten = decompressBzip2ToDevice(pData, nSize, nLimit, &buffer, pThreadPool, &bResult, pPdStruct);
+        buffer.close();
+
+        if (nWritten > nCapacity) {
+            // Too large for memory; the caller decodes it to a file instead
+            bResult = false;
+        }
+    }
+
+    if (!bResult) {
+        baResult.clear();
+    }
+
+    if (pIsValid) {
+        *pIsValid = bResult;
+    }
+
+    return baResult;
+}
+
+QList<ParallelDecoder::MARKER> ParallelDecoder::findBzip2Markers(const char *pData, qint64 nBegin, qint64 nEnd, qint64 nSize, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<MARKER> listResult;
+
+    // For a magic starting at bit s of byte i, byte i + 1 is fully known: a table on it
+    // rejects almost every position before the 48-bit compare
+    quint16 table[256] = {};
+
+    for (qint32 s = 0; s < 8; s++) {
+        table[((N_BZIP2_BLOCK_MAGIC << (16 - s)) >> 48) & 0xFF] |= (quint16)(1 << s);
+        table[((N_BZIP2_EOS_MAGIC << (16 - s)) >> 48) & 0xFF] |= (quint16)(0x100 << s);
+    }
+
+    const quint8 *_pData = (const quint8 *)pData;
+
+    // A window needs 8 bytes; the tail is compared bit by bit through _readBits
+    for (qint64 i = nBegin; (i < nEnd) && (i + 1 < nSize); i++) {
+        if (((i & 0xFFFFF) == 0) && (!XBinary::isPdStructNotCanceled(pPdStruct))) {
+            break;
+        }
+
+        quint16 nShifts = table[_pData[i + 1]];
+
+        if (!nShifts) {
+            continue;
+        }
+
+        quint64 nWindow = 0;
+
+        for (qint32 j = 0; j < 8; j++) {
+            nWindow = (nWindow << 8) | (((i + j) < nSize) ? _pData[i + j] : 0);
+        }
+
+        for (qint32 s = 0; s < 8; s++) {
+            quint64 nValue = (nWindow >> (16 - s)) & N_MAGIC_MASK;
+
+            if ((nShifts & (1 << s)) && (nValue == N_BZIP2_BLOCK_MAGIC)) {
+                MARKER marker = {i * 8 + s, false};
+                listResult.append(marker);
+            } else if ((nShifts & (0x100 << s)) && (nValue == N_BZIP2_EOS_MAGIC)) {
+                MARKER marker = {i * 8 + s, true};
+                listResult.append(marker);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QByteArray ParallelDecoder::wrapBzip2Block(const char *pData, qint64 nSize, const BLOCK &block)
+{
+    QByteArray baResult;
+    baResult.reserve((qint32)(block.nBitSize / 8) + 16);
+
+    // Level 9 accepts blocks of every level
+    baResult.append("BZh9", 4);
+
+    _BITWRITER writer = {&baResult, 0, 0};
+
+    const quint8 *_pData = (const quint8 *)pData;
+
+    qint64 nBitOffset = block.nBitOffset;
+    qint64 nBitEnd = block.nBitOffset + block.nBitSize;
+
+    while ((nBitEnd - nBitOffset) >= 32) {
+        if ((nBitOffset & 7) == 0) {
+            qint64 nByte = nBitOffset >> 3;
+            quint32 nValue = ((quint32)_pData[nByte] << 24) | ((quint32)_pData[nByte + 1] << 16) | ((quint32)_pData[nByte + 2] << 8) | _pData[nByte + 3];
+            _writeBits(&writer, nValue, 32);
+        } else {
+            _writeBits(&writer, _readBits(_pData, nSize, nBitOffset, 32), 32);
+        }
+
+        nBitOffset += 32;
+    }
+
+    if (nBitEnd > nBitOffset) {
+        qint32 nCount = (qint32)(nBitEnd - nBitOffset);
+        _writeBits(&writer, _readBits(_pData, nSize, nBitOffset, nCount), nCount);
+    }
+
+    // One block: the stream CRC equals the block CRC that follows the block magic
+    quint32 nBlockCRC = _readBits(_pData, nSize, block.nBitOffset + 48, 32);
+
+    _writeBits(&writer, (quint32)(N_BZIP2_EOS_MAGIC >> 16), 32);
+    _writeBits(&writer, (quint32)(N_BZIP2_EOS_MAGIC & 0xFFFF), 16);
+    _writeBits(&writer, nBlockCRC, 32);
+    _flushBits(&writer);
+
+    return baResult;
+}
+
+bool ParallelDecoder::decompressBzip2Stream(const QByteArray &baStream, QByteArray *pResult)
+{
+    bool bResult = false;
+
+    bz_stream stream = {};
+    stream.bzalloc = _bzAlloc;
+    stream.bzfree = _bzFree;
+
+    if (BZ2_bzDecompressInit(&stream, 0, 0) == BZ_OK) {
+        stream.next_in = (char *)baStream.constData();
+        stream.avail_in = (unsigned int)baStream.size();
+
+        const qint32 nChunkSize = 0x100000;
+
+        while (true) {
+            qint32 nOldSize = pResult->size();
+            pResult->resize(nOldSize + nChunkSize);
+
+            stream.next_out = pResult->data() + nOldSize;
+            stream.avail_out = (unsigned int)nChunkSize;
+
+            int nRet = BZ2_bzDecompress(&stream);
+
+            pResult->resize(nOldSize + nChunkSize - (qint32)stream.avail_out);
+
+            if (nRet == BZ_STREAM_END) {
+                bResult = true;
+                break;
+            }
+
+            if ((nRet != BZ_OK) || ((stream.avail_in == 0) && (stream.avail_out != 0))) {
+                break;
+            }
+        }
+
+        BZ2_bzDecompressEnd(&stream);
+    }
+
+    return bResult;
+}
@@ -0,0 +1,62 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef PARALLELDECODER_H
+#define PARALLELDECODER_H
+
+#include <QBuffer>
+#include <QFuture>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "xbinary.h"
+
+// Block-parallel decoding of a single compressed payload. bzip2 blocks are independent:
+// each one is cut at its bit-aligned magic, rewrapped as a one-block stream and decoded
+// on the pool; outputs are written in order. Blocks check their own CRC when decoded.
+class ParallelDecoder {
+public:
+    struct BLOCK {
+        qint64 nBitOffset;  // Block magic
+        qint64 nBitSize;    // Up to the next block or end-of-stream magic
+    };
+
+    static QList<BLOCK> findBzip2Blocks(const char *pData, qint64 nSize, QThreadPool *pThreadPool, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // False in *pIsValid if the payload does not split cleanly; the caller decodes it sequentially then.
+    // Decoding stops at the first block that takes the output past nMaxSize (0: unlimited).
+    // Returns the number of bytes written to pOutput.
+    static qint64 decompressBzip2ToDevice(const char *pData, qint64 nSize, qint64 nMaxSize, QIODevice *pOutput, QThreadPool *pThreadPool, bool *pIsValid,
+                                          XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // In-memory form for payloads within the memory budget; a result of more than 1 GB is not valid
+    static QByteArray decompressBzip2(const char *pData, qint64 nSize, qint64 nMaxSize, QThreadPool *pThreadPool, bool *pIsValid,
+                                      XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+private:
+    struct MARKER {
+        qint64 nBitOffset;
+        bool bIsEndOfStream;
+    };
+
+    static QList<MARKER> findBzip2Markers(const char *pData, qint64 nBegin, qint64 nEnd, qint64 nSize, XBinary::PDSTRUCT *pPdStruct);
+    static QByteArray wrapBzip2Block(const char *pData, qint64 nSize, const BLOCK &block);
+    static bool decompressBzip2Stream(const QByteArray &baStream, QByteArray *pResult);
+};
+
+#endif  // PARALLELDECODER_H
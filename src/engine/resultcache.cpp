@@ -0,0 +1,344 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "resultcache.h"
+
+#include <QDirIterator>
+#include <QTemporaryDir>
+
+#include <algorithm>
+
+namespace {
+
+const qint32 N_CACHE_VERSION = 1;
+
+struct CACHE_ENTRY {
+    QString sPath;
+    QDateTime dtLastUsed;
+    qint64 nSize;
+};
+
+}  // namespace
+
+ResultCache::ResultCache(const QString &sDirectory, qint64 nLimit) : m_sDirectory(sDirectory), m_nLimit(nLimit), m_nTotalSize(-1), m_nNumberOfHits(0), m_nNumberOfMisses(0)
+{
+    QDir().mkpath(m_sDirectory);
+}
+
+QString ResultCache::getKey(QIODevice *pDevice, const QString &sOptionsKey, XBinary::PDSTRUCT *pPdStruct)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    MappedDevice *pMappedDevice = qobject_cast<MappedDevice *>(pDevice);
+
+    if (pMappedDevice && pMappedDevice->data()) {
+        hash.addData(pMappedDevice->data(), (int)qMin(pMappedDevice->size(), (qint64)0x7FFFFFFF));
+
+        // Inputs above 2 GiB are hashed in slices
+        for (qint64 nOffset = 0x7FFFFFFF; (nOffset < pMappedDevice->size()) && XBinary::isPdStructNotCanceled(pPdStruct); nOffset += 0x7FFFFFFF) {
+            hash.addData(pMappedDevice->data() + nOffset, (int)qMin(pMappedDevice->size() - nOffset, (qint64)0x7FFFFFFF));
+        }
+    } else {
+        pDevice->seek(0);
+        hash.addData(pDevice);
+        pDevice->seek(0);
+    }
+
+    hash.addData(sOptionsKey.toUtf8());
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+bool ResultCache::load(const QString &sKey, const QString &sOutputDirectory, UnpackEngine::RESULT *pResult)
+{
+    bool bResult = false;
+
+    QString sEntryPath = getEntryPath(sKey);
+    QFile file(sEntryPath + QStringLiteral("/result.json"));
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QJsonObject jsRoot = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+
+        bool bHasData = jsRoot.value(QStringLiteral("data")).toBool();
+
+        if ((jsRoot.value(QStringLiteral("version")).toInt() == N_CACHE_VERSION) && (sOutputDirectory.isEmpty() || bHasData)) {
+            bResult = true;
+
+            pResult->sFileType = jsRoot.value(QStringLiteral("filetype")).toString();
+            pResult->scanResult = scanResultFromJson(jsRoot.value(QStringLiteral("scan")).toArray());
+
+            QJsonArray jsEntries = jsRoot.value(QStringLiteral("entries")).toArray();
+
+            qint32 nNumberOfEntries = jsEntries.count();
+
+            for (qint32 i = 0; i < nNumberOfEntries; i++) {
+                QJsonObject jsEntry = jsEntries.at(i).toObject();
+
+                UnpackEngine::ENTRY entry = {};
+                entry.sName = jsEntry.value(QStringLiteral("name")).toString();
+                entry.sPath = jsEntry.value(QStringLiteral("path")).toString();
+                entry.nLevel = jsEntry.value(QStringLiteral("level")).toInt();
+                entry.nCompressedSize = (qint64)jsEntry.value(QStringLiteral("csize")).toDouble();
+                entry.nUncompressedSize = (qint64)jsEntry.value(QStringLiteral("usize")).toDouble();
+                entry.sFileType = jsEntry.value(QStringLiteral("filetype")).toString();
+                entry.bIsValid = jsEntry.value(QStringLiteral("valid")).toBool();
+                entry.sErrorString = jsEntry.value(QStringLiteral("error")).toString();
+                entry.scanResult = scanResultFromJson(jsEntry.value(QStringLiteral("scan")).toArray());
+
+                QString sOutput = jsEntry.value(QStringLiteral("output")).toString();
+
+                if ((!sOutputDirectory.isEmpty()) && (!sOutput.isEmpty())) {
+                    entry.sOutputFileName = sOutputDirectory + QDir::separator() + sOutput;
+
+                    QDir().mkpath(QFileInfo(entry.sOutputFileName).absolutePath());
+                    QFile::remove(entry.sOutputFileName);
+
+                    if (!QFile::copy(sEntryPath + QStringLiteral("/data/%1").arg(i), entry.sOutputFileName)) {
+                        bResult = false;
+                        break;
+                    }
+                }
+
+                pResult->listEntries.append(entry);
+                pResult->nNumberOfEntries++;
+            }
+        }
+
+        if (bResult) {
+            pResult->status = UnpackEngine::STATUS_OK;
+            pResult->bIsCached = true;
+
+            // The modification time of result.json is the LRU stamp
+            if (file.open(QIODevice::Append)) {
+                file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+                file.close();
+            }
+        } else {
+            pResult->sFileType.clear();
+            pResult->scanResult = XScanEngine::SCAN_RESULT();
+            pResult->listEntries.clear();
+            pResult->nNumberOfEntries = 0;
+        }
+    }
+
+    if (bResult) {
+        m_nNumberOfHits.ref();
+    } else {
+        m_nNumberOfMisses.ref();
+    }
+
+    return bResult;
+}
+
+void ResultCache::store(const QString &sKey, const QString &sOutputDirectory, const UnpackEngine::RESULT &result)
+{
+    QTemporaryDir tempDir(m_sDirectory + QStringLiteral("/tmp-XXXXXX"));
+
+    if (!tempDir.isValid()) {
+        return;
+    }
+
+    bool bHasData = !sOutputDirectory.isEmpty();
+    QDir dirOutput(sOutputDirectory);
+
+    QJsonObject jsRoot;
+    jsRoot.insert(QStringLiteral("version"), N_CACHE_VERSION);
+    jsRoot.insert(QStringLiteral("filetype"), result.sFileType);
+    jsRoot.insert(QStringLiteral("size"), (double)result.nSize);
+    jsRoot.insert(QStringLiteral("scan"), scanResultToJson(result.scanResult));
+
+    QJsonArray jsEntries;
+
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        const UnpackEngine::ENTRY &entry = result.listEntries.at(i);
+
+        QJsonObject jsEntry;
+        jsEntry.insert(QStringLiteral("name"), entry.sName);
+        jsEntry.insert(QStringLiteral("path"), entry.sPath);
+        jsEntry.insert(QStringLiteral("level"), entry.nLevel);
+        jsEntry.insert(QStringLiteral("csize"), (double)entry.nCompressedSize);
+        jsEntry.insert(QStringLiteral("usize"), (double)entry.nUncompressedSize);
+        jsEntry.insert(QStringLiteral("filetype"), entry.sFileType);
+        jsEntry.insert(QStringLiteral("valid"), entry.bIsValid);
+        jsEntry.insert(QStringLiteral("error"), entry.sErrorString);
+        jsEntry.insert(QStringLiteral("scan"), scanResultToJson(entry.scanResult));
+
+        if (bHasData && (!entry.sOutputFileName.isEmpty())) {
+            QDir().mkpath(tempDir.path() + QStringLiteral("/data"));
+
+            if (QFile::copy(entry.sOutputFileName, tempDir.path() + QStringLiteral("/data/%1").arg(i))) {
+                jsEntry.insert(QStringLiteral("output"), dirOutput.relativeFilePath(entry.sOutputFileName));
+            } else {
+                bHasData = false;
+            }
+        }
+
+        jsEntries.append(jsEntry);
+    }
+
+    jsRoot.insert(QStringLiteral("entries"), jsEntries);
+    jsRoot.insert(QStringLiteral("data"), bHasData);
+
+    QFile file(tempDir.path() + QStringLiteral("/result.json"));
+
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(jsRoot).toJson(QJsonDocument::Compact));
+        file.close();
+
+        QString sEntryPath = getEntryPath(sKey);
+        QDir().mkpath(QFileInfo(sEntryPath).absolutePath());
+
+        // Another worker may have stored the same input meanwhile; its entry is kept
+        if (QDir().rename(tempDir.path(), sEntryPath)) {
+            QMutexLocker locker(&m_mutex);
+
+            if (m_nTotalSize != -1) {
+                m_nTotalSize += getDirectorySize(sEntryPath);
+            } else {
+                m_nTotalSize = getDirectorySize(m_sDirectory);
+            }
+
+            if ((m_nLimit > 0) && (m_nTotalSize > m_nLimit)) {
+                evict();
+            }
+        }
+    }
+}
+
+qint64 ResultCache::getNumberOfHits() const
+{
+    return m_nNumberOfHits.loadAcquire();
+}
+
+qint64 ResultCache::getNumberOfMisses() const
+{
+    return m_nNumberOfMisses.loadAcquire();
+}
+
+QString ResultCache::getEntryPath(const QString &sKey) const
+{
+    return m_sDirectory + QLatin1Char('/') + sKey.left(2) + QLatin1Char('/') + sKey;
+}
+
+QJsonArray ResultCache::scanResultToJson(const XScanEngine::SCAN_RESULT &scanResult)
+{
+    QJsonArray jsResult;
+
+    qint32 nNumberOfRecords = scanResult.listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const XScanEngine::SCANSTRUCT &scanStruct = scanResult.listRecords.at(i);
+
+        QJsonObject jsRecord;
+        jsRecord.insert(QStringLiteral("type"), scanStruct.sType);
+        jsRecord.insert(QStringLiteral("name"), scanStruct.sName);
+        jsRecord.insert(QStringLiteral("version"), scanStruct.sVersion);
+        jsRecord.insert(QStringLiteral("info"), scanStruct.sInfo);
+
+        jsResult.append(jsRecord);
+    }
+
+    return jsResult;
+}
+
+XScanEngine::SCAN_RESULT ResultCache::scanResultFromJson(const QJsonArray &jsArray)
+{
+    XScanEngine::SCAN_RESULT result = {};
+
+    qint32 nNumberOfRecords = jsArray.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        QJsonObject jsRecord = jsArray.at(i).toObject();
+
+        XScanEngine::SCANSTRUCT scanStruct = {};
+        scanStruct.sType = jsRecord.value(QStringLiteral("type")).toString();
+        scanStruct.sName = jsRecord.value(QStringLiteral("name")).toString();
+        scanStruct.sVersion = jsRecord.value(QStringLiteral("version")).toString();
+        scanStruct.sInfo = jsRecord.value(QStringLiteral("info")).toString();
+
+        result.listRecords.append(scanStruct);
+    }
+
+    return result;
+}
+
+qint64 ResultCache::getDirectorySize(const QString &sDirectory)
+{
+    qint64 nResult = 0;
+
+    QDirIterator it(sDirectory, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext()) {
+        it.next();
+        nResult += it.fileInfo().size();
+    }
+
+    return nResult;
+}
+
+void ResultCache::evict()
+{
+    QList<CACHE_ENTRY> listEntries;
+
+    QDirIterator itPrefix(m_sDirectory, QDir::Dirs | QDir::NoDotAndDotDot);
+
+    while (itPrefix.hasNext()) {
+        itPrefix.next();
+
+        if (itPrefix.fileName().startsWith(QStringLiteral("tmp-"))) {
+            continue;
+        }
+
+        QDirIterator itEntry(itPrefix.filePath(), QDir::Dirs | QDir::NoDotAndDotDot);
+
+        while (itEntry.hasNext()) {
+            itEntry.next();
+
+            CACHE_ENTRY entry = {};
+            entry.sPath = itEntry.filePath();
+            entry.dtLastUsed = QFileInfo(entry.sPath + QStringLiteral("/result.json")).lastModified();
+            entry.nSize = getDirectorySize(entry.sPath);
+
+            listEntries.append(entry);
+        }
+    }
+
+    std::sort(listEntries.begin(), listEntries.end(), [](const CACHE_ENTRY &a, const CACHE_ENTRY &b) { return a.dtLastUsed < b.dtLastUsed; });
+
+    // Down to 90% of the limit, so the next stores do not trigger another pass right away
+    qint64 nTarget = (m_nLimit / 10) * 9;
+
+    m_nTotalSize = 0;
+
+    qint32 nNumberOfEntries = listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        m_nTotalSize += listEntries.at(i).nSize;
+    }
+
+    for (qint32 i = 0; (i < nNumberOfEntries) && (m_nTotalSize > nTarget); i++) {
+        if (QDir(listEntries.at(i).sPath).removeRecursively()) {
+            m_nTotalSize -= listEntries.at(i).nSize;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+
+#include "unpackengine.h"
+
+// On-disk cache of unpack results, keyed by the input content and the options.
+// An entry holds result.json and, when the run extracted files, a copy of every
+// child under data/. Entries are evicted least recently used first.
+class ResultCache {
+public:
+    explicit ResultCache(const QString &sDirectory, qint64 nLimit);
+
+    static QString getKey(QIODevice *pDevice, const QString &sOptionsKey, XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+    bool load(const QString &sKey, const QString &sOutputDirectory, UnpackEngine::RESULT *pResult);
+    void store(const QString &sKey, const QString &sOutputDirectory, const UnpackEngine::RESULT &result);
+
+    qint64 getNumberOfHits() const;
+    qint64 getNumberOfMisses() const;
+
+    static QJsonArray scanResultToJson(const XScanEngine::SCAN_RESULT &scanResult);
+    static XScanEngine::SCAN_RESULT scanResultFromJson(const QJsonArray &jsArray);
+
+private:
+    QString getEntryPath(const QString &sKey) const;
+    static qint64 getDirectorySize(const QString &sDirectory);
+    void evict();
+
+    QMutex m_mutex;
+    QString m_sDirectory;
+    qint64 m_nLimit;
+    qint64 m_nTotalSize;  // -1 until the directory was measured
+    QAtomicInteger<qint64> m_nNumberOfHits;
+    QAtomicInteger<qint64> m_nNumberOfMisses;
+};
+
+#endif  // RESULTCACHE_H
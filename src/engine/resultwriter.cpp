@@ -0,0 +1,289 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "resultwriter.h"
+
+#include <QtEndian>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "resultcache.h"
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+template <typename T>
+static void _appendBigEndian(QByteArray *pData, quint8 nType, T value)
+{
+    char buffer[sizeof(T)];
+    qToBigEndian(value, buffer);
+
+    pData->append((char)nType);
+    pData->append(buffer, sizeof(T));
+}
+
+static void _appendMessagePackSize(QByteArray *pData, quint8 nFixType, qint32 nFixLimit, quint8 nType16, quint32 nSize)
+{
+    if (nSize < (quint32)nFixLimit) {
+        pData->append((char)(nFixType | nSize));
+    } else if (nSize <= 0xFFFF) {
+        _appendBigEndian<quint16>(pData, nType16, (quint16)nSize);
+    } else {
+        _appendBigEndian<quint32>(pData, nType16 + 1, nSize);
+    }
+}
+
+ResultWriter::ResultWriter(FORMAT format, QFile *pFile) : m_format(format), m_pFile(pFile)
+{
+    // A reserved array keeps its capacity through resize(0), in Qt 5 as well
+    m_baRecord.reserve(N_RECORD_CAPACITY);
+}
+
+ResultWriter::~ResultWriter()
+{
+    m_pFile->flush();
+    delete m_pFile;
+}
+
+ResultWriter::FORMAT ResultWriter::stringToFormat(const QString &sString)
+{
+    FORMAT result = FORMAT_UNKNOWN;
+
+    QString _sString = sString.toLower();
+
+    if (_sString == QStringLiteral("jsonl")) {
+        result = FORMAT_JSONL;
+    } else if (_sString == QStringLiteral("msgpack")) {
+        result = FORMAT_MSGPACK;
+    }
+
+    return result;
+}
+
+ResultWriter *ResultWriter::create(FORMAT format, const QString &sTarget, QString *pErrorString, bool bAppend)
+{
+    ResultWriter *pResult = nullptr;
+
+    QFile *pFile = new QFile;
+    bool bIsOpened = false;
+
+    // Buffered: records are small, a flush follows every input record
+    if (sTarget == QStringLiteral("-")) {
+#ifdef Q_OS_WIN
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        std::fflush(stdout);
+        bIsOpened = pFile->open(fileno(stdout), QIODevice::WriteOnly, QFileDevice::DontCloseHandle);
+    } else {
+        pFile->setFileName(sTarget);
+        bIsOpened = pFile->open(QIODevice::WriteOnly | (bAppend ? QIODevice::Append : QIODevice::Truncate));
+    }
+
+    if (!bIsOpened) {
+        if (pErrorString) {
+            *pErrorString = QStringLiteral("Cannot open: %1").arg(sTarget);
+        }
+
+        delete pFile;
+    } else if (format != FORMAT_UNKNOWN) {
+        pResult = new ResultWriter(format, pFile);
+    } else {
+        if (pErrorString) {
+            *pErrorString = QStringLiteral("Unknown record format");
+        }
+
+        delete pFile;
+    }
+
+    return pResult;
+}
+
+void ResultWriter::writeEntry(const QString &sInputFileName, const UnpackEngine::ENTRY &entry)
+{
+    writeRecord(entryToJson(sInputFileName, entry), false);
+}
+
+void ResultWriter::writeResult(const UnpackEngine::RESULT &result)
+{
+    qint32 nNumberOfEntries = result.listEntries.count();
+
+    for (qint32 i = 0; i < nNumberOfEntries; i++) {
+        writeRecord(entryToJson(result.sFileName, result.listEntries.at(i)), false);
+    }
+
+    writeRecord(resultToJson(result), true);
+}
+
+QJsonObject ResultWriter::entryToJson(const QString &sInputFileName, const UnpackEngine::ENTRY &entry)
+{
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("record"), QStringLiteral("entry"));
+    jsResult.insert(QStringLiteral("input"), sInputFileName);
+    jsResult.insert(QStringLiteral("path"), entry.sPath);
+    jsResult.insert(QStringLiteral("level"), entry.nLevel);
+    jsResult.insert(QStringLiteral("csize"), (double)entry.nCompressedSize);
+    jsResult.insert(QStringLiteral("usize"), (double)entry.nUncompressedSize);
+    jsResult.insert(QStringLiteral("filetype"), entry.sFileType);
+    jsResult.insert(QStringLiteral("valid"), entry.bIsValid);
+    jsResult.insert(QStringLiteral("scan"), ResultCache::scanResultToJson(entry.scanResult));
+
+    if (!entry.sOutputFileName.isEmpty()) {
+        jsResult.insert(QStringLiteral("output"), entry.sOutputFileName);
+    }
+
+    if (!entry.sHash.isEmpty()) {
+        jsResult.insert(QStringLiteral("sha1"), entry.sHash);
+        jsResult.insert(QStringLiteral("duplicate"), entry.bIsDuplicate);
+    }
+
+    if (!entry.sErrorString.isEmpty()) {
+        jsResult.insert(QStringLiteral("error"), entry.sErrorString);
+    }
+
+    return jsResult;
+}
+
+QJsonObject ResultWriter::resultToJson(const UnpackEngine::RESULT &result)
+{
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("record"), QStringLiteral("input"));
+    jsResult.insert(QStringLiteral("input"), result.sFileName);
+    jsResult.insert(QStringLiteral("status"), UnpackEngine::statusToString(result.status));
+    jsResult.insert(QStringLiteral("filetype"), result.sFileType);
+    jsResult.insert(QStringLiteral("size"), (double)result.nSize);
+    jsResult.insert(QStringLiteral("entries"), result.nNumberOfEntries);
+    jsResult.insert(QStringLiteral("elapsed_ms"), (double)result.nElapsed);
+    jsResult.insert(QStringLiteral("cached"), result.bIsCached);
+    jsResult.insert(QStringLiteral("scan"), ResultCache::scanResultToJson(result.scanResult));
+
+    if (!result.sLimit.isEmpty()) {
+        jsResult.insert(QStringLiteral("limit"), result.sLimit);
+    }
+
+    if (!result.sErrorString.isEmpty()) {
+        jsResult.insert(QStringLiteral("error"), result.sErrorString);
+    }
+
+    return jsResult;
+}
+
+void ResultWriter::appendMessagePack(QByteArray *pData, const QJsonValue &value)
+{
+    if (value.isObject()) {
+        QJsonObject jsObject = value.toObject();
+        _appendMessagePackSize(pData, 0x80, 16, 0xDE, jsObject.count());
+
+        for (QJsonObject::const_iterator it = jsObject.constBegin(); it != jsObject.constEnd(); ++it) {
+            appendMessagePack(pData, it.key());
+            appendMessagePack(pData, it.value());
+        }
+    } else if (value.isArray()) {
+        QJsonArray jsArray = value.toArray();
+        _appendMessagePackSize(pData, 0x90, 16, 0xDC, jsArray.count());
+
+        qint32 nNumberOfValues = jsArray.count();
+
+        for (qint32 i = 0; i < nNumberOfValues; i++) {
+            appendMessagePack(pData, jsArray.at(i));
+        }
+    } else if (value.isString()) {
+        QByteArray baString = value.toString().toUtf8();
+
+        if (baString.size() < 32) {
+            pData->append((char)(0xA0 | baString.size()));
+        } else if (baString.size() <= 0xFF) {
+            pData->append((char)0xD9);
+            pData->append((char)baString.size());
+        } else {
+            _appendMessagePackSize(pData, 0xA0, 0, 0xDA, baString.size());
+        }
+
+        pData->append(baString);
+    } else if (value.isBool()) {
+        pData->append((char)(value.toBool() ? 0xC3 : 0xC2));
+    } else if (value.isDouble()) {
+        double dValue = value.toDouble();
+
+        // Sizes and counts arrive as doubles; integral values go out as integers
+        if ((std::floor(dValue) == dValue) && (std::fabs(dValue) < 9007199254740992.0)) {
+            qint64 nValue = (qint64)dValue;
+
+            if (nValue >= 0) {
+                if (nValue < 0x80) {
+                    pData->append((char)nValue);
+                } else if (nValue <= 0xFF) {
+                    pData->append((char)0xCC);
+                    pData->append((char)(quint8)nValue);
+                } else if (nValue <= 0xFFFF) {
+                    _appendBigEndian<quint16>(pData, 0xCD, (quint16)nValue);
+                } else if (nValue <= 0xFFFFFFFFLL) {
+                    _appendBigEndian<quint32>(pData, 0xCE, (quint32)nValue);
+                } else {
+                    _appendBigEndian<quint64>(pData, 0xCF, (quint64)nValue);
+                }
+            } else {
+                if (nValue >= -32) {
+                    pData->append((char)(qint8)nValue);
+                } else if (nValue >= -0x80) {
+                    pData->append((char)0xD0);
+                    pData->append((char)(qint8)nValue);
+                } else if (nValue >= -0x8000) {
+                    _appendBigEndian<qint16>(pData, 0xD1, (qint16)nValue);
+                } else if (nValue >= -0x80000000LL) {
+                    _appendBigEndian<qint32>(pData, 0xD2, (qint32)nValue);
+                } else {
+                    _appendBigEndian<qint64>(pData, 0xD3, nValue);
+                }
+            }
+        } else {
+            quint64 nBits = 0;
+            std::memcpy(&nBits, &dValue, sizeof(nBits));
+
+            _appendBigEndian<quint64>(pData, 0xCB, nBits);
+        }
+    } else {
+        pData->append((char)0xC0);
+    }
+}
+
+void ResultWriter::writeRecord(const QJsonObject &jsRecord, bool bFlush)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // One buffer for all records; reserved in the constructor, so this does not free it
+    m_baRecord.resize(0);
+
+    if (m_format == FORMAT_JSONL) {
+        m_baRecord.append(QJsonDocument(jsRecord).toJson(QJsonDocument::Compact));
+        m_baRecord.append('\n');
+    } else {
+        appendMessagePack(&m_baRecord, jsRecord);
+    }
+
+    m_pFile->write(m_baRecord);
+
+    if (bFlush) {
+        m_pFile->flush();
+    }
+}
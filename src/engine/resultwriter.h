@@ -0,0 +1,74 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutex>
+
+#include "unpackengine.h"
+
+// Machine-readable batch output, one record per entry and one per input. Entry records
+// are written as the engine finishes them, so a result never has to hold its entries;
+// the input record follows its last entry. Records of different inputs interleave and
+// carry the input file name.
+//
+// jsonl: one compact JSON object per line. msgpack: the same objects as consecutive
+// MessagePack maps, integers in their smallest encoding.
+class ResultWriter {
+public:
+    enum FORMAT {
+        FORMAT_UNKNOWN = 0,
+        FORMAT_JSONL,
+        FORMAT_MSGPACK
+    };
+
+    ~ResultWriter();
+
+    static FORMAT stringToFormat(const QString &sString);
+    // sTarget: "-" for stdout, otherwise a file; bAppend keeps the records of an earlier run
+    static ResultWriter *create(FORMAT format, const QString &sTarget, QString *pErrorString, bool bAppend = false);
+
+    // Thread-safe
+    void writeEntry(const QString &sInputFileName, const UnpackEngine::ENTRY &entry);
+    // Entries still held by the result (cached results), then the input record
+    void writeResult(const UnpackEngine::RESULT &result);
+
+    static QJsonObject entryToJson(const QString &sInputFileName, const UnpackEngine::ENTRY &entry);
+    static QJsonObject resultToJson(const UnpackEngine::RESULT &result);
+    static void appendMessagePack(QByteArray *pData, const QJsonValue &value);
+
+private:
+    ResultWriter(FORMAT format, QFile *pFile);
+
+    void writeRecord(const QJsonObject &jsRecord, bool bFlush);
+
+    static const qint32 N_RECORD_CAPACITY = 4096;  // Bytes
+
+    FORMAT m_format;
+    QFile *m_pFile;
+    QMutex m_mutex;
+    QByteArray m_baRecord;
+};
+
+#endif  // RESULTWRITER_H
@@ -0,0 +1,125 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "scanenginepool.h"
+
+ScanEnginePool::ScanEnginePool(qint32 nMaxEngines) : m_nMaxEngines(qMax(1, nMaxEngines)), m_nNumberOfCreating(0), m_nWaitTime(0)
+{
+}
+
+ScanEnginePool::~ScanEnginePool()
+{
+    qDeleteAll(m_listEngines);
+}
+
+qint32 ScanEnginePool::getMaxEngines() const
+{
+    return m_nMaxEngines;
+}
+
+qint32 ScanEnginePool::getNumberOfEngines() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_listEngines.count();
+}
+
+void ScanEnginePool::warmUp()
+{
+    QList<QFuture<XScanEngine *>> listFutures;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        qint32 nNumberOfMissing = m_nMaxEngines - m_listEngines.count() - m_nNumberOfCreating;
+
+        for (qint32 i = 0; i < nNumberOfMissing; i++) {
+            listFutures.append(QtConcurrent::run([]() { return new XScanEngine; }));
+        }
+
+        m_nNumberOfCreating += listFutures.count();
+    }
+
+    qint32 nNumberOfFutures = listFutures.count();
+
+    for (qint32 i = 0; i < nNumberOfFutures; i++) {
+        XScanEngine *pScanEngine = listFutures[i].result();
+
+        QMutexLocker locker(&m_mutex);
+
+        m_nNumberOfCreating--;
+        m_listEngines.append(pScanEngine);
+        m_listFreeEngines.append(pScanEngine);
+        m_waitCondition.wakeOne();
+    }
+}
+
+XScanEngine *ScanEnginePool::acquire(XBinary::PDSTRUCT *pPdStruct)
+{
+    XScanEngine *pResult = nullptr;
+
+    QMutexLocker locker(&m_mutex);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (XBinary::isPdStructNotCanceled(pPdStruct)) {
+        if (!m_listFreeEngines.isEmpty()) {
+            pResult = m_listFreeEngines.takeLast();
+            break;
+        }
+
+        if ((m_listEngines.count() + m_nNumberOfCreating) < m_nMaxEngines) {
+            // Loading the databases takes a while; the others need not wait for it
+            m_nNumberOfCreating++;
+            locker.unlock();
+
+            pResult = new XScanEngine;
+
+            locker.relock();
+            m_nNumberOfCreating--;
+            m_listEngines.append(pResult);
+            break;
+        }
+
+        m_waitCondition.wait(&m_mutex, N_WAIT_INTERVAL);
+    }
+
+    m_nWaitTime += timer.nsecsElapsed();
+
+    return pResult;
+}
+
+void ScanEnginePool::release(XScanEngine *pScanEngine)
+{
+    if (pScanEngine) {
+        QMutexLocker locker(&m_mutex);
+
+        m_listFreeEngines.append(pScanEngine);
+        m_waitCondition.wakeOne();
+    }
+}
+
+qint64 ScanEnginePool::getWaitTime() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_nWaitTime;
+}
@@ -0,0 +1,63 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef SCANENGINEPOOL_H
+#define SCANENGINEPOOL_H
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QtConcurrent>
+
+#include "xscanengine.h"
+
+// Scan engines lent to the pipelines for the scan stage only. Every XScanEngine holds its
+// own compiled signatures and script state, so N workers sharing M engines hold M copies:
+// decompression, detection and output, which need no engine, still run N wide. Engines are
+// created on first demand, up to the limit, or all at once by warmUp().
+class ScanEnginePool {
+public:
+    explicit ScanEnginePool(qint32 nMaxEngines);
+    ~ScanEnginePool();
+
+    qint32 getMaxEngines() const;
+    qint32 getNumberOfEngines() const;  // Created so far
+    // Creates the missing engines in parallel and returns when they are loaded; for long-lived
+    // processes whose first job should not pay for the databases
+    void warmUp();
+    // Blocks while all engines are lent out; nullptr if pPdStruct is stopped meanwhile
+    XScanEngine *acquire(XBinary::PDSTRUCT *pPdStruct = nullptr);
+    void release(XScanEngine *pScanEngine);
+    qint64 getWaitTime() const;  // ns, all pipelines together
+
+private:
+    static const qint32 N_WAIT_INTERVAL = 100;  // ms between checks of the PDSTRUCT
+
+    qint32 m_nMaxEngines;
+    mutable QMutex m_mutex;
+    QWaitCondition m_waitCondition;
+    QList<XScanEngine *> m_listEngines;
+    QList<XScanEngine *> m_listFreeEngines;
+    qint32 m_nNumberOfCreating;
+    qint64 m_nWaitTime;
+};
+
+#endif  // SCANENGINEPOOL_H
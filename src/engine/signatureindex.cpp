@@ -0,0 +1,408 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "signatureindex.h"
+
+#include <cstring>
+
+// Layout, little endian:
+//   header  "XFUSIGIX", u32 version, u32 anchors, i32 files, u32 reserved, i64 total size, i64 latest mtime
+//   records i64 offset, u32 hash, u32 pattern offset, u32 name offset, u16 pattern size, u16 name size
+//   blob    patterns and UTF-8 names; offsets are from the start of the blob
+
+namespace {
+
+const char N_INDEX_MAGIC[8] = {'X', 'F', 'U', 'S', 'I', 'G', 'I', 'X'};
+
+bool _isHexDigit(QChar cChar)
+{
+    return ((cChar >= QLatin1Char('0')) && (cChar <= QLatin1Char('9'))) || ((cChar >= QLatin1Char('a')) && (cChar <= QLatin1Char('f'))) ||
+           ((cChar >= QLatin1Char('A')) && (cChar <= QLatin1Char('F')));
+}
+
+bool _isWildcard(QChar cChar)
+{
+    return (cChar == QLatin1Char('.')) || (cChar == QLatin1Char('?'));
+}
+
+}  // namespace
+
+SignatureIndex::STAMP SignatureIndex::getSourceStamp(const QString &sDirectory, XBinary::PDSTRUCT *pPdStruct)
+{
+    STAMP result = {};
+
+    QDirIterator it(sDirectory, QStringList() << QStringLiteral("*.sg"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext() && XBinary::isPdStructNotCanceled(pPdStruct)) {
+        it.next();
+
+        QFileInfo fi = it.fileInfo();
+
+        result.nNumberOfFiles++;
+        result.nTotalSize += fi.size();
+        result.nLatestModified = qMax(result.nLatestModified, fi.lastModified().toMSecsSinceEpoch());
+    }
+
+    return result;
+}
+
+QList<SignaturePrefilter::ANCHOR> SignatureIndex::compileDirectory(const QString &sDirectory, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<SignaturePrefilter::ANCHOR> listResult;
+    QSet<QByteArray> setAnchors;
+
+    QDirIterator it(sDirectory, QStringList() << QStringLiteral("*.sg"), QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+    while (it.hasNext() && XBinary::isPdStructNotCanceled(pPdStruct)) {
+        it.next();
+
+        QFile file(it.filePath());
+
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        QList<SignaturePrefilter::ANCHOR> listAnchors = compileScript(QString::fromUtf8(file.readAll()), it.fileInfo().completeBaseName());
+
+        qint32 nNumberOfAnchors = listAnchors.count();
+
+        for (qint32 i = 0; i < nNumberOfAnchors; i++) {
+            const SignaturePrefilter::ANCHOR &anchor = listAnchors.at(i);
+
+            // Many scripts test the same magic; one anchor is enough
+            QByteArray baKey = anchor.baPattern + QByteArray::number(anchor.nOffset);
+
+            if (!setAnchors.contains(baKey)) {
+                setAnchors.insert(baKey);
+                listResult.append(anchor);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QList<SignaturePrefilter::ANCHOR> SignatureIndex::compileScript(const QString &sScript, const QString &sName)
+{
+    QList<SignaturePrefilter::ANCHOR> listResult;
+
+    static const QRegularExpression regexCall(
+        QStringLiteral("\\.(compare|compareEP|compareOverlay|findSignature|isSignaturePresent|isSignatureInSectionPresent)\\s*\\(([^()]*)\\)"));
+    static const QRegularExpression regexString(QStringLiteral("\"([^\"]*)\""));
+    static const QRegularExpression regexOffset(QStringLiteral(",\\s*(0x[0-9A-Fa-f]+|[0-9]+)\\s*$"));
+
+    QRegularExpressionMatchIterator it = regexCall.globalMatch(sScript);
+
+    while (it.hasNext()) {
+        QRegularExpressionMatch match = it.next();
+
+        QString sFunction = match.captured(1);
+        QString sArguments = match.captured(2);
+
+        QRegularExpressionMatch matchString = regexString.match(sArguments);
+
+        if (!matchString.hasMatch()) {
+            continue;
+        }
+
+        // compare(sSignature[, nOffset]) is the only call at a known file offset
+        bool bIsFileOffset = false;
+        qint64 nOffset = 0;
+
+        if (sFunction == QStringLiteral("compare")) {
+            QString sRest = sArguments.mid(matchString.capturedEnd(0));
+
+            if (sRest.trimmed().isEmpty()) {
+                bIsFileOffset = true;
+            } else {
+                QRegularExpressionMatch matchOffset = regexOffset.match(sRest);
+
+                if (matchOffset.hasMatch()) {
+                    bool bValid = false;
+                    nOffset = matchOffset.captured(1).toLongLong(&bValid, 0);
+                    bIsFileOffset = bValid;
+                }
+            }
+        }
+
+        SignaturePrefilter::ANCHOR anchor = {};
+
+        if (parsePattern(matchString.captured(1), bIsFileOffset, nOffset, &anchor)) {
+            anchor.sName = sName;
+            listResult.append(anchor);
+        }
+    }
+
+    return listResult;
+}
+
+bool SignatureIndex::parsePattern(const QString &sPattern, bool bIsFileOffset, qint64 nOffset, SignaturePrefilter::ANCHOR *pAnchor)
+{
+    QByteArray baRun;
+    qint64 nRunStart = 0;
+    QByteArray baBest;
+    qint64 nBestStart = 0;
+    bool bIsBestFixed = false;
+    bool bIsFixed = bIsFileOffset;  // Until a jump or an unknown token
+    qint64 nPosition = 0;
+
+    qint32 nLength = sPattern.length();
+    qint32 i = 0;
+
+    auto endRun = [&]() {
+        if (baRun.size() > baBest.size()) {
+            baBest = baRun;
+            nBestStart = nRunStart;
+            bIsBestFixed = bIsFixed;
+        }
+
+        baRun.clear();
+    };
+
+    while (i < nLength) {
+        QChar cChar = sPattern.at(i);
+
+        if (cChar.isSpace()) {
+            i++;
+        } else if ((i + 1 < nLength) && _isHexDigit(cChar) && _isHexDigit(sPattern.at(i + 1))) {
+            if (baRun.isEmpty()) {
+                nRunStart = nPosition;
+            }
+
+            baRun.append((char)sPattern.mid(i, 2).toUInt(nullptr, 16));
+            nPosition++;
+            i += 2;
+        } else if ((i + 1 < nLength) && (_isWildcard(cChar) || _isHexDigit(cChar)) && (_isWildcard(sPattern.at(i + 1)) || _isHexDigit(sPattern.at(i + 1)))) {
+            // ".." or a half-known byte
+            endRun();
+            nPosition++;
+            i += 2;
+        } else if (cChar == QLatin1Char('\'')) {
+            qint32 nEnd = sPattern.indexOf(QLatin1Char('\''), i + 1);
+
+            if (nEnd == -1) {
+                break;
+            }
+
+            QByteArray baText = sPattern.mid(i + 1, nEnd - i - 1).toLatin1();
+
+            if (baRun.isEmpty()) {
+                nRunStart = nPosition;
+            }
+
+            baRun.append(baText);
+            nPosition += baText.size();
+            i = nEnd + 1;
+        } else {
+            // $$$$ / #### follow a jump; '*' and the rest skip an unknown distance
+            endRun();
+            bIsFixed = false;
+            i++;
+        }
+    }
+
+    endRun();
+
+    bool bResult = (baBest.size() >= N_MIN_ANCHOR_SIZE);
+
+    if (bResult) {
+        pAnchor->baPattern = baBest.left(N_MAX_ANCHOR_SIZE);
+        pAnchor->nOffset = bIsBestFixed ? (nOffset + nBestStart) : -1;
+    }
+
+    return bResult;
+}
+
+bool SignatureIndex::write(const QString &sFileName, const STAMP &stamp, const QList<SignaturePrefilter::ANCHOR> &listAnchors)
+{
+    qint32 nNumberOfAnchors = listAnchors.count();
+
+    QByteArray baHeader(N_HEADER_SIZE, 0);
+    QByteArray baRecords(nNumberOfAnchors * N_RECORD_SIZE, 0);
+    QByteArray baBlob;
+
+    char *pHeader = baHeader.data();
+    std::memcpy(pHeader, N_INDEX_MAGIC, sizeof(N_INDEX_MAGIC));
+    qToLittleEndian<quint32>(N_VERSION, pHeader + 8);
+    qToLittleEndian<quint32>((quint32)nNumberOfAnchors, pHeader + 12);
+    qToLittleEndian<qint32>(stamp.nNumberOfFiles, pHeader + 16);
+    qToLittleEndian<qint64>(stamp.nTotalSize, pHeader + 24);
+    qToLittleEndian<qint64>(stamp.nLatestModified, pHeader + 32);
+
+    for (qint32 i = 0; i < nNumberOfAnchors; i++) {
+        const SignaturePrefilter::ANCHOR &anchor = listAnchors.at(i);
+
+        QByteArray baPattern = anchor.baPattern.left(0xFFFF);
+        QByteArray baName = anchor.sName.toUtf8().left(0xFFFF);
+
+        char *pRecord = baRecords.data() + i * N_RECORD_SIZE;
+        qToLittleEndian<qint64>(anchor.nOffset, pRecord);
+        qToLittleEndian<quint32>(getHash(baPattern), pRecord + 8);
+        qToLittleEndian<quint32>((quint32)baBlob.size(), pRecord + 12);
+        baBlob.append(baPattern);
+        qToLittleEndian<quint32>((quint32)baBlob.size(), pRecord + 16);
+        baBlob.append(baName);
+        qToLittleEndian<quint16>((quint16)baPattern.size(), pRecord + 20);
+        qToLittleEndian<quint16>((quint16)baName.size(), pRecord + 22);
+    }
+
+    // Readers of the old index keep a consistent file until the rename
+    QSaveFile file(sFileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    file.write(baHeader);
+    file.write(baRecords);
+    file.write(baBlob);
+
+    return file.commit();
+}
+
+bool SignatureIndex::read(const QString &sFileName, STAMP *pStamp, QList<SignaturePrefilter::ANCHOR> *pListAnchors)
+{
+    bool bResult = false;
+
+    QFile file(sFileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    qint64 nSize = file.size();
+    QByteArray baData;
+    const char *pData = (const char *)file.map(0, nSize);
+
+    if (!pData) {
+        baData = file.readAll();
+        pData = baData.constData();
+    }
+
+    if ((nSize >= N_HEADER_SIZE) && (std::memcmp(pData, N_INDEX_MAGIC, sizeof(N_INDEX_MAGIC)) == 0) && (qFromLittleEndian<quint32>(pData + 8) == N_VERSION)) {
+        quint32 nNumberOfAnchors = qFromLittleEndian<quint32>(pData + 12);
+        qint64 nBlobOffset = N_HEADER_SIZE + (qint64)nNumberOfAnchors * N_RECORD_SIZE;
+
+        if (nBlobOffset <= nSize) {
+            const char *pBlob = pData + nBlobOffset;
+            qint64 nBlobSize = nSize - nBlobOffset;
+
+            pStamp->nNumberOfFiles = qFromLittleEndian<qint32>(pData + 16);
+            pStamp->nTotalSize = qFromLittleEndian<qint64>(pData + 24);
+            pStamp->nLatestModified = qFromLittleEndian<qint64>(pData + 32);
+
+            QList<SignaturePrefilter::ANCHOR> listAnchors;
+            listAnchors.reserve(nNumberOfAnchors);
+
+            bResult = true;
+
+            for (quint32 i = 0; (i < nNumberOfAnchors) && bResult; i++) {
+                const char *pRecord = pData + N_HEADER_SIZE + (qint64)i * N_RECORD_SIZE;
+
+                quint32 nPatternOffset = qFromLittleEndian<quint32>(pRecord + 12);
+                quint32 nNameOffset = qFromLittleEndian<quint32>(pRecord + 16);
+                quint16 nPatternSize = qFromLittleEndian<quint16>(pRecord + 20);
+                quint16 nNameSize = qFromLittleEndian<quint16>(pRecord + 22);
+
+                if (((qint64)nPatternOffset + nPatternSize > nBlobSize) || ((qint64)nNameOffset + nNameSize > nBlobSize)) {
+                    bResult = false;
+                    break;
+                }
+
+                SignaturePrefilter::ANCHOR anchor = {};
+                anchor.baPattern = QByteArray(pBlob + nPatternOffset, nPatternSize);
+                anchor.nOffset = qFromLittleEndian<qint64>(pRecord);
+                anchor.sName = QString::fromUtf8(pBlob + nNameOffset, nNameSize);
+
+                // A torn or edited file is treated as stale
+                bResult = (getHash(anchor.baPattern) == qFromLittleEndian<quint32>(pRecord + 8));
+
+                listAnchors.append(anchor);
+            }
+
+            if (bResult) {
+                *pListAnchors = listAnchors;
+            }
+        }
+    }
+
+    file.close();
+
+    return bResult;
+}
+
+QList<SignaturePrefilter::ANCHOR> SignatureIndex::load(const QString &sIndexFileName, const QString &sSourceDirectory, bool *pIsFromIndex,
+                                                       XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<SignaturePrefilter::ANCHOR> listResult;
+
+    bool bIsFromIndex = false;
+    bool bHasSources = (!sSourceDirectory.isEmpty()) && QFileInfo(sSourceDirectory).isDir();
+
+    STAMP stampSources = {};
+
+    if (bHasSources) {
+        stampSources = getSourceStamp(sSourceDirectory, pPdStruct);
+    }
+
+    STAMP stampIndex = {};
+    QList<SignaturePrefilter::ANCHOR> listIndex;
+
+    if ((!sIndexFileName.isEmpty()) && read(sIndexFileName, &stampIndex, &listIndex)) {
+        // Without sources there is nothing to be stale against
+        if ((!bHasSources) || isStampEqual(stampIndex, stampSources)) {
+            listResult = listIndex;
+            bIsFromIndex = true;
+        }
+    }
+
+    if ((!bIsFromIndex) && bHasSources) {
+        listResult = compileDirectory(sSourceDirectory, pPdStruct);
+
+        if ((!sIndexFileName.isEmpty()) && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            write(sIndexFileName, stampSources, listResult);
+        }
+    }
+
+    if (pIsFromIndex) {
+        *pIsFromIndex = bIsFromIndex;
+    }
+
+    return listResult;
+}
+
+quint32 SignatureIndex::getHash(const QByteArray &baData)
+{
+    quint32 nResult = 2166136261u;
+
+    qint32 nSize = baData.size();
+    const quint8 *pData = (const quint8 *)baData.constData();
+
+    for (qint32 i = 0; i < nSize; i++) {
+        nResult = (nResult ^ pData[i]) * 16777619u;
+    }
+
+    return nResult;
+}
+
+bool SignatureIndex::isStampEqual(const STAMP &stamp1, const STAMP &stamp2)
+{
+    return (stamp1.nNumberOfFiles == stamp2.nNumberOfFiles) && (stamp1.nTotalSize == stamp2.nTotalSize) && (stamp1.nLatestModified == stamp2.nLatestModified);
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef SIGNATUREINDEX_H
+#define SIGNATUREINDEX_H
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+
+#include "signatureprefilter.h"
+
+// Compiled anchors of the DiE signature scripts. The compiler takes the byte patterns of
+// compare()/compareEP()/findSignature()-style calls, keeps their longest literal run and
+// stores it with its fixed offset where the pattern has one. The index file is mapped and
+// walked once; a stamp of the source tree tells when it is stale.
+class SignatureIndex {
+public:
+    struct STAMP {
+        qint32 nNumberOfFiles;
+        qint64 nTotalSize;
+        qint64 nLatestModified;  // ms since epoch
+    };
+
+    static STAMP getSourceStamp(const QString &sDirectory, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static QList<SignaturePrefilter::ANCHOR> compileDirectory(const QString &sDirectory, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static QList<SignaturePrefilter::ANCHOR> compileScript(const QString &sScript, const QString &sName);
+    // One DiE pattern, e.g. "E8$$$$$$$$'UPX!'..0D"; false if no literal run is long enough
+    static bool parsePattern(const QString &sPattern, bool bIsFileOffset, qint64 nOffset, SignaturePrefilter::ANCHOR *pAnchor);
+
+    static bool write(const QString &sFileName, const STAMP &stamp, const QList<SignaturePrefilter::ANCHOR> &listAnchors);
+    static bool read(const QString &sFileName, STAMP *pStamp, QList<SignaturePrefilter::ANCHOR> *pListAnchors);
+    // From the index if it matches the sources, otherwise compiled from them; the index is rewritten then
+    static QList<SignaturePrefilter::ANCHOR> load(const QString &sIndexFileName, const QString &sSourceDirectory, bool *pIsFromIndex = nullptr,
+                                                  XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+private:
+    static quint32 getHash(const QByteArray &baData);
+    static bool isStampEqual(const STAMP &stamp1, const STAMP &stamp2);
+
+    static const quint32 N_VERSION = 1;
+    static const qint32 N_HEADER_SIZE = 40;
+    static const qint32 N_RECORD_SIZE = 24;
+    static const qint32 N_MIN_ANCHOR_SIZE = 4;
+    static const qint32 N_MAX_ANCHOR_SIZE = 16;
+};
+
+#endif  // SIGNATUREINDEX_H
@@ -0,0 +1,470 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "signatureprefilter.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PREFILTER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PREFILTER_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(PREFILTER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define PREFILTER_TARGET(sTarget) __attribute__((target(sTarget)))
+#else
+#define PREFILTER_TARGET(sTarget)
+#endif
+
+namespace {
+
+inline qint32 _countTrailingZeros(quint32 nValue)
+{
+#ifdef _MSC_VER
+    unsigned long nResult = 0;
+    _BitScanForward(&nResult, nValue);
+    return (qint32)nResult;
+#else
+    return __builtin_ctz(nValue);
+#endif
+}
+
+qint64 _findCandidateScalar(const quint8 *pData, qint64 nSize, const quint8 *pLo, const quint8 *pHi)
+{
+    for (qint64 i = 0; i < nSize; i++) {
+        if (pLo[pData[i] & 0x0F] & pHi[pData[i] >> 4]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+#ifdef PREFILTER_X86
+PREFILTER_TARGET("ssse3")
+qint64 _findCandidateSSSE3(const quint8 *pData, qint64 nSize, const quint8 *pLo, const quint8 *pHi)
+{
+    const __m128i lo = _mm_loadu_si128((const __m128i *)pLo);
+    const __m128i hi = _mm_loadu_si128((const __m128i *)pHi);
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+
+    qint64 i = 0;
+
+    for (; i + 16 <= nSize; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(pData + i));
+        __m128i l = _mm_shuffle_epi8(lo, _mm_and_si128(v, mask));
+        __m128i h = _mm_shuffle_epi8(hi, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        quint32 nBits = (~(quint32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(l, h), zero))) & 0xFFFF;
+
+        if (nBits) {
+            return i + _countTrailingZeros(nBits);
+        }
+    }
+
+    qint64 nResult = _findCandidateScalar(pData + i, nSize - i, pLo, pHi);
+
+    return (nResult == -1) ? -1 : (i + nResult);
+}
+
+PREFILTER_TARGET("avx2")
+qint64 _findCandidateAVX2(const quint8 *pData, qint64 nSize, const quint8 *pLo, const quint8 *pHi)
+{
+    const __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)pLo));
+    const __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)pHi));
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i zero = _mm256_setzero_si256();
+
+    qint64 i = 0;
+
+    for (; i + 32 <= nSize; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(pData + i));
+        __m256i l = _mm256_shuffle_epi8(lo, _mm256_and_si256(v, mask));
+        __m256i h = _mm256_shuffle_epi8(hi, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+        quint32 nBits = ~(quint32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(l, h), zero));
+
+        if (nBits) {
+            return i + _countTrailingZeros(nBits);
+        }
+    }
+
+    qint64 nResult = _findCandidateSSSE3(pData + i, nSize - i, pLo, pHi);
+
+    return (nResult == -1) ? -1 : (i + nResult);
+}
+#endif
+
+#ifdef PREFILTER_NEON
+qint64 _findCandidateNEON(const quint8 *pData, qint64 nSize, const quint8 *pLo, const quint8 *pHi)
+{
+    const uint8x16_t lo = vld1q_u8(pLo);
+    const uint8x16_t hi = vld1q_u8(pHi);
+    const uint8x16_t mask = vdupq_n_u8(0x0F);
+
+    qint64 i = 0;
+
+    for (; i + 16 <= nSize; i += 16) {
+        uint8x16_t v = vld1q_u8(pData + i);
+        uint8x16_t m = vandq_u8(vqtbl1q_u8(lo, vandq_u8(v, mask)), vqtbl1q_u8(hi, vshrq_n_u8(v, 4)));
+
+        if (vmaxvq_u8(m)) {
+            break;
+        }
+    }
+
+    qint64 nResult = _findCandidateScalar(pData + i, nSize - i, pLo, pHi);
+
+    return (nResult == -1) ? -1 : (i + nResult);
+}
+#endif
+
+}  // namespace
+
+SignaturePrefilter::SignaturePrefilter() : m_lo(), m_hi(), m_nMaxLength(0), m_kernel(getBestKernel())
+{
+}
+
+QList<SignaturePrefilter::ANCHOR> SignaturePrefilter::getDefaultAnchors()
+{
+    struct _ANCHOR {
+        const char *pPattern;
+        qint32 nSize;
+        qint64 nOffset;
+        const char *pName;
+    };
+
+    // Formats that carry code or other files. Weak two-byte magics are only trusted at offset 0.
+    static const _ANCHOR anchors[] = {
+        {"MZ", 2, 0, "MSDOS"},
+        {"\x7F" "ELF", 4, 0, "ELF"},
+        {"\xCA\xFE\xBA\xBE", 4, 0, "Mach-O fat / Java class"},
+        {"\xFE\xED\xFA\xCE", 4, 0, "Mach-O"},
+        {"\xFE\xED\xFA\xCF", 4, 0, "Mach-O"},
+        {"\xCE\xFA\xED\xFE", 4, 0, "Mach-O"},
+        {"\xCF\xFA\xED\xFE", 4, 0, "Mach-O"},
+        {"dex\n", 4, 0, "DEX"},
+        {"\x00" "asm", 4, 0, "WASM"},
+        {"\x1F\x8B", 2, 0, "GZIP"},
+        {"BZh", 3, 0, "BZIP2"},
+        {"!<arch>\n", 8, 0, "AR"},
+        {"ITSF", 4, 0, "CHM"},
+        {"ustar", 5, 257, "TAR"},
+        {"CD001", 5, 0x8001, "ISO 9660"},
+        {"#!", 2, 0, "Script"},
+        {"PK\x03\x04", 4, -1, "ZIP"},
+        {"PK\x05\x06", 4, -1, "ZIP"},
+        {"Rar!\x1A\x07", 6, -1, "RAR"},
+        {"7z\xBC\xAF\x27\x1C", 6, -1, "7-Zip"},
+        {"\xFD" "7zXZ\x00", 6, -1, "XZ"},
+        {"\x1F\x8B\x08", 3, -1, "GZIP"},
+        {"1AY&SY", 6, -1, "BZIP2"},
+        {"MSCF\x00\x00\x00\x00", 8, -1, "CAB"},
+        {"\xD0\xCF\x11\xE0\xA1\xB1\x1A\xE1", 8, -1, "OLE"},
+        {"%PDF-", 5, -1, "PDF"},
+        {"\x7F" "ELF", 4, -1, "ELF"},
+        {"PE\x00\x00", 4, -1, "PE"},
+        {"UPX!", 4, -1, "UPX"},
+        {"UPX0", 4, -1, "UPX"},
+        {".aspack", 7, -1, "ASPack"},
+        {"MPRESS1", 7, -1, "MPRESS"},
+        {"PECompact2", 10, -1, "PECompact"},
+        {".themida", 8, -1, "Themida"},
+        {".vmp0", 5, -1, "VMProtect"},
+        {"NullsoftInst", 12, -1, "NSIS"},
+        {"Inno Setup", 10, -1, "Inno Setup"},
+        {"InstallShield", 13, -1, "InstallShield"},
+    };
+
+    QList<ANCHOR> listResult;
+
+    qint32 nNumberOfAnchors = sizeof(anchors) / sizeof(anchors[0]);
+
+    for (qint32 i = 0; i < nNumberOfAnchors; i++) {
+        ANCHOR anchor = {};
+        anchor.baPattern = QByteArray(anchors[i].pPattern, anchors[i].nSize);
+        anchor.nOffset = anchors[i].nOffset;
+        anchor.sName = QString::fromLatin1(anchors[i].pName);
+
+        listResult.append(anchor);
+    }
+
+    return listResult;
+}
+
+SignaturePrefilter::KERNEL SignaturePrefilter::getBestKernel()
+{
+    KERNEL result = KERNEL_SCALAR;
+#if defined(PREFILTER_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        result = KERNEL_AVX2;
+    } else if (__builtin_cpu_supports("ssse3")) {
+        result = KERNEL_SSSE3;
+    }
+#elif defined(PREFILTER_X86) && defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 1);
+
+    bool bIsSSSE3 = (info[2] & (1 << 9)) != 0;
+    bool bIsOSXSAVE = (info[2] & (1 << 27)) != 0;
+
+    __cpuidex(info, 7, 0);
+
+    bool bIsAVX2 = (info[1] & (1 << 5)) != 0;
+
+    if (bIsAVX2 && bIsOSXSAVE && ((_xgetbv(0) & 6) == 6)) {
+        result = KERNEL_AVX2;
+    } else if (bIsSSSE3) {
+        result = KERNEL_SSSE3;
+    }
+#elif defined(PREFILTER_NEON)
+    result = KERNEL_NEON;
+#endif
+    return result;
+}
+
+QString SignaturePrefilter::kernelToString(KERNEL kernel)
+{
+    QString sResult;
+
+    switch (kernel) {
+        case KERNEL_SSSE3: sResult = QStringLiteral("ssse3"); break;
+        case KERNEL_AVX2: sResult = QStringLiteral("avx2"); break;
+        case KERNEL_NEON: sResult = QStringLiteral("neon"); break;
+        default: sResult = QStringLiteral("scalar");
+    }
+
+    return sResult;
+}
+
+void SignaturePrefilter::setAnchors(const QList<ANCHOR> &listAnchors)
+{
+    m_listAnchors.clear();
+    m_listFixed.clear();
+    m_mapFloating.clear();
+    m_bitmap.fill(0, 0x10000 / 8);
+    std::memset(m_lo, 0, sizeof(m_lo));
+    std::memset(m_hi, 0, sizeof(m_hi));
+    m_nMaxLength = 0;
+
+    qint32 nNumberOfAnchors = listAnchors.count();
+
+    for (qint32 i = 0; i < nNumberOfAnchors; i++) {
+        const ANCHOR &anchor = listAnchors.at(i);
+
+        if (anchor.baPattern.size() < 2) {
+            continue;
+        }
+
+        qint32 nIndex = m_listAnchors.count();
+        m_listAnchors.append(anchor);
+
+        if (anchor.nOffset >= 0) {
+            m_listFixed.append(nIndex);
+        } else {
+            quint8 nByte0 = (quint8)anchor.baPattern.at(0);
+            quint8 nByte1 = (quint8)anchor.baPattern.at(1);
+            quint16 nPrefix = (quint16)((nByte0 << 8) | nByte1);
+
+            // Eight buckets; a byte is a candidate when both of its nibbles share one
+            quint8 nBucket = (quint8)(1 << (nByte0 & 7));
+            m_lo[nByte0 & 0x0F] |= nBucket;
+            m_hi[nByte0 >> 4] |= nBucket;
+            m_bitmap[nPrefix >> 3] |= (quint8)(1 << (nPrefix & 7));
+            m_mapFloating[nPrefix].append(nIndex);
+            m_nMaxLength = qMax(m_nMaxLength, (qint32)anchor.baPattern.size());
+        }
+    }
+}
+
+QList<SignaturePrefilter::ANCHOR> SignaturePrefilter::getAnchors() const
+{
+    return m_listAnchors;
+}
+
+SignaturePrefilter::KERNEL SignaturePrefilter::getKernel() const
+{
+    return m_kernel;
+}
+
+void SignaturePrefilter::setKernel(KERNEL kernel)
+{
+    m_kernel = kernel;
+}
+
+QList<SignaturePrefilter::HIT> SignaturePrefilter::scan(const char *pData, qint64 nSize, qint64 nBaseOffset, qint32 nMaxHits) const
+{
+    QList<HIT> listResult;
+
+    scanFixed(pData, nSize, nBaseOffset, nMaxHits, &listResult);
+    scanFloating(pData, nSize, nBaseOffset, nSize, nMaxHits, &listResult);
+
+    return listResult;
+}
+
+QList<SignaturePrefilter::HIT> SignaturePrefilter::scanDevice(QIODevice *pDevice, qint32 nMaxHits, XBinary::PDSTRUCT *pPdStruct) const
+{
+    QList<HIT> listResult;
+
+    const char *pData = nullptr;
+    qint64 nSize = pDevice->size();
+
+    if (MappedDevice *pMappedDevice = qobject_cast<MappedDevice *>(pDevice)) {
+        pData = pMappedDevice->data();
+    } else if (QBuffer *pBuffer = qobject_cast<QBuffer *>(pDevice)) {
+        pData = pBuffer->data().constData();
+    }
+
+    if (pData) {
+        listResult = scan(pData, nSize, 0, nMaxHits);
+    } else {
+        qint64 nPos = pDevice->pos();
+
+        // Fixed anchors: one small read each
+        qint32 nNumberOfFixed = m_listFixed.count();
+
+        for (qint32 i = 0; (i < nNumberOfFixed) && ((nMaxHits < 0) || (listResult.count() < nMaxHits)); i++) {
+            const ANCHOR &anchor = m_listAnchors.at(m_listFixed.at(i));
+
+            if ((anchor.nOffset + anchor.baPattern.size()) <= nSize) {
+                pDevice->seek(anchor.nOffset);
+
+                if (pDevice->read(anchor.baPattern.size()) == anchor.baPattern) {
+                    HIT hit = {anchor.nOffset, m_listFixed.at(i)};
+                    listResult.append(hit);
+                }
+            }
+        }
+
+        // Floating anchors: chunks overlap by the longest pattern, a hit belongs to the chunk it starts in
+        const qint64 nChunkSize = 0x100000;
+        qint64 nOverlap = qMax(m_nMaxLength - 1, 0);
+        QByteArray baBuffer;
+
+        for (qint64 nOffset = 0; (nOffset < nSize) && XBinary::isPdStructNotCanceled(pPdStruct) && ((nMaxHits < 0) || (listResult.count() < nMaxHits));
+             nOffset += nChunkSize) {
+            pDevice->seek(nOffset);
+            baBuffer = pDevice->read(qMin(nChunkSize + nOverlap, nSize - nOffset));
+
+            if (baBuffer.isEmpty()) {
+                break;
+            }
+
+            scanFloating(baBuffer.constData(), baBuffer.size(), nOffset, qMin(nChunkSize, (qint64)baBuffer.size()), nMaxHits, &listResult);
+        }
+
+        pDevice->seek(nPos);
+    }
+
+    return listResult;
+}
+
+bool SignaturePrefilter::hasHits(QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct) const
+{
+    return !scanDevice(pDevice, 1, pPdStruct).isEmpty();
+}
+
+void SignaturePrefilter::scanFixed(const char *pData, qint64 nSize, qint64 nBaseOffset, qint32 nMaxHits, QList<HIT> *pListHits) const
+{
+    qint32 nNumberOfFixed = m_listFixed.count();
+
+    for (qint32 i = 0; (i < nNumberOfFixed) && ((nMaxHits < 0) || (pListHits->count() < nMaxHits)); i++) {
+        const ANCHOR &anchor = m_listAnchors.at(m_listFixed.at(i));
+        qint64 nOffset = anchor.nOffset - nBaseOffset;
+
+        if ((nOffset >= 0) && ((nOffset + anchor.baPattern.size()) <= nSize) &&
+            (std::memcmp(pData + nOffset, anchor.baPattern.constData(), anchor.baPattern.size()) == 0)) {
+            HIT hit = {anchor.nOffset, m_listFixed.at(i)};
+            pListHits->append(hit);
+        }
+    }
+}
+
+void SignaturePrefilter::scanFloating(const char *pData, qint64 nSize, qint64 nBaseOffset, qint64 nEnd, qint32 nMaxHits, QList<HIT> *pListHits) const
+{
+    if (m_mapFloating.isEmpty()) {
+        return;
+    }
+
+    const quint8 *_pData = (const quint8 *)pData;
+
+    qint64 nPos = 0;
+
+    // The last byte cannot start a two-byte prefix
+    while ((nPos < nEnd) && (nPos + 1 < nSize) && ((nMaxHits < 0) || (pListHits->count() < nMaxHits))) {
+        qint64 nCandidate = findCandidate(_pData + nPos, qMin(nEnd, nSize - 1) - nPos);
+
+        if (nCandidate == -1) {
+            break;
+        }
+
+        nPos += nCandidate;
+
+        quint16 nPrefix = (quint16)((_pData[nPos] << 8) | _pData[nPos + 1]);
+
+        if (m_bitmap.at(nPrefix >> 3) & (1 << (nPrefix & 7))) {
+            const QVector<qint32> listIndexes = m_mapFloating.value(nPrefix);
+
+            qint32 nNumberOfIndexes = listIndexes.count();
+
+            for (qint32 i = 0; i < nNumberOfIndexes; i++) {
+                const ANCHOR &anchor = m_listAnchors.at(listIndexes.at(i));
+
+                if (((nPos + anchor.baPattern.size()) <= nSize) && (std::memcmp(pData + nPos, anchor.baPattern.constData(), anchor.baPattern.size()) == 0)) {
+                    HIT hit = {nBaseOffset + nPos, listIndexes.at(i)};
+                    pListHits->append(hit);
+
+                    if ((nMaxHits >= 0) && (pListHits->count() >= nMaxHits)) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        nPos++;
+    }
+}
+
+qint64 SignaturePrefilter::findCandidate(const quint8 *pData, qint64 nSize) const
+{
+    qint64 nResult = -1;
+
+    if (nSize > 0) {
+        switch (m_kernel) {
+#ifdef PREFILTER_X86
+            case KERNEL_SSSE3: nResult = _findCandidateSSSE3(pData, nSize, m_lo, m_hi); break;
+            case KERNEL_AVX2: nResult = _findCandidateAVX2(pData, nSize, m_lo, m_hi); break;
+#endif
+#ifdef PREFILTER_NEON
+            case KERNEL_NEON: nResult = _findCandidateNEON(pData, nSize, m_lo, m_hi); break;
+#endif
+            default: nResult = _findCandidateScalar(pData, nSize, m_lo, m_hi);
+        }
+    }
+
+    return nResult;
+}
@@ -0,0 +1,87 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef SIGNATUREPREFILTER_H
+#define SIGNATUREPREFILTER_H
+
+#include <QBuffer>
+#include <QHash>
+#include <QIODevice>
+#include <QVector>
+
+#include "mappeddevice.h"
+#include "xbinary.h"
+
+// One pass over the data for all signature anchors. Anchors with a fixed offset are
+// compared in place; floating ones go through a nibble classifier on their first byte
+// (pshufb / vqtbl1q), a two-byte bitmap and a final memcmp. The scan engine only needs
+// to run where something hit.
+class SignaturePrefilter {
+public:
+    enum KERNEL {
+        KERNEL_SCALAR = 0,
+        KERNEL_SSSE3,
+        KERNEL_AVX2,
+        KERNEL_NEON
+    };
+
+    struct ANCHOR {
+        QByteArray baPattern;  // At least 2 bytes
+        qint64 nOffset;        // -1: anywhere
+        QString sName;
+    };
+
+    struct HIT {
+        qint64 nOffset;
+        qint32 nAnchor;
+    };
+
+    SignaturePrefilter();
+
+    static QList<ANCHOR> getDefaultAnchors();
+    static KERNEL getBestKernel();
+    static QString kernelToString(KERNEL kernel);
+
+    void setAnchors(const QList<ANCHOR> &listAnchors);
+    QList<ANCHOR> getAnchors() const;
+    KERNEL getKernel() const;
+    void setKernel(KERNEL kernel);  // Reference runs; must be supported by the CPU
+
+    QList<HIT> scan(const char *pData, qint64 nSize, qint64 nBaseOffset = 0, qint32 nMaxHits = -1) const;
+    // Served from the mapping or the buffer where possible, otherwise read in overlapping chunks
+    QList<HIT> scanDevice(QIODevice *pDevice, qint32 nMaxHits = -1, XBinary::PDSTRUCT *pPdStruct = nullptr) const;
+    bool hasHits(QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct = nullptr) const;
+
+private:
+    void scanFixed(const char *pData, qint64 nSize, qint64 nBaseOffset, qint32 nMaxHits, QList<HIT> *pListHits) const;
+    void scanFloating(const char *pData, qint64 nSize, qint64 nBaseOffset, qint64 nEnd, qint32 nMaxHits, QList<HIT> *pListHits) const;
+    qint64 findCandidate(const quint8 *pData, qint64 nSize) const;
+
+    QList<ANCHOR> m_listAnchors;
+    QVector<qint32> m_listFixed;
+    QHash<quint16, QVector<qint32>> m_mapFloating;  // First two bytes -> anchors
+    QVector<quint8> m_bitmap;                       // 64 Kbit, first two bytes
+    alignas(16) quint8 m_lo[16];
+    alignas(16) quint8 m_hi[16];
+    qint32 m_nMaxLength;
+    KERNEL m_kernel;
+};
+
+#endif  // SIGNATUREPREFILTER_H
@@ -0,0 +1,1198 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackengine.h"
+
+#include "batchjournal.h"
+#include "entryfilter.h"
+#include "filestateindex.h"
+#include "formattriage.h"
+#include "outputsink.h"
+#include "paralleldecoder.h"
+#include "resultcache.h"
+#include "resultwriter.h"
+#include "unpacktracer.h"
+
+#include <limits>
+
+UnpackEngine::UnpackEngine(QObject *pParent) : QObject(pParent), m_pScanEngine(nullptr), m_nNumberOfFiles(0), m_nWatch(-1), m_pWriteGroup(nullptr)
+{
+}
+
+UnpackEngine::~UnpackEngine()
+{
+    delete m_pScanEngine;
+}
+
+UnpackEngine::OPTIONS UnpackEngine::getDefaultOptions()
+{
+    OPTIONS result = {};
+
+    result.scanOptions.bShowType = true;
+    result.scanOptions.bShowVersion = true;
+    result.scanOptions.bShowInfo = true;
+    result.bScan = true;
+    result.bExtract = true;
+    result.bUnpackExecutables = true;
+    result.bMemoryMap = true;
+    result.nMaxDepth = 1;
+
+    return result;
+}
+
+QString UnpackEngine::statusToString(STATUS status)
+{
+    QString sResult;
+
+    if (status == STATUS_OK) {
+        sResult = QStringLiteral("ok");
+    } else if (status == STATUS_ERROR) {
+        sResult = QStringLiteral("error");
+    } else if (status == STATUS_LIMIT) {
+        sResult = QStringLiteral("limit");
+    } else {
+        sResult = QStringLiteral("unknown");
+    }
+
+    return sResult;
+}
+
+QString UnpackEngine::getOptionsKey(const OPTIONS &options)
+{
+    return QStringLiteral("scan=%1;extract=%2;carve=%3;depth=%4;recursive=%5;deep=%6;heuristic=%7;verbose=%8;alltypes=%9;prefilter=%10;limits=%11;triage=%12;entries=%13;spill=%14;unpackpe=%15;signatures=%16")
+        .arg(options.bScan)
+        .arg(options.bExtract)
+        .arg(options.bCarve)
+        .arg(options.nMaxDepth)
+        .arg(options.scanOptions.bIsRecursiveScan)
+        .arg(options.scanOptions.bIsDeepScan)
+        .arg(options.scanOptions.bIsHeuristicScan)
+        .arg(options.scanOptions.bIsVerbose)
+        .arg(options.scanOptions.bIsAllTypesScan)
+        .arg(options.pPrefilter != nullptr)
+        .arg(QStringLiteral("%1/%2/%3/%4")
+                 .arg(options.limits.nMaxOutputSize)
+                 .arg(options.limits.nMaxRatio)
+                 .arg(options.limits.nMaxEntries)
+                 .arg(options.limits.nMaxTime))
+        .arg(options.bTriage)
+        .arg(options.pEntryFilter ? options.pEntryFilter->getPatterns().join(QLatin1Char('|')) : QString())
+        .arg(!options.sSpillDirectory.isEmpty())
+        .arg(options.bUnpackExecutables)
+        .arg(options.sSignatureStamp);
+}
+
+QString UnpackEngine::getSafeRelativePath(const QString &sRecordName)
+{
+    QString sName = sRecordName;
+    sName.replace(QLatin1Char('\\'), QLatin1Char('/'));
+
+    QStringList listParts = sName.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    QStringList listResult;
+
+    qint32 nNumberOfParts = listParts.count();
+
+    for (qint32 i = 0; i < nNumberOfParts; i++) {
+        QString sPart = listParts.at(i);
+
+        if ((sPart == QStringLiteral(".")) || (sPart == QStringLiteral("..")) || sPart.endsWith(QLatin1Char(':'))) {
+            continue;
+        }
+
+        listResult.append(sPart);
+    }
+
+    return listResult.join(QLatin1Char('/'));
+}
+
+UnpackEngine::RESULT UnpackEngine::processFile(const QString &sFileName, const QString &sOutputDirectory, const OPTIONS &options, XBinary::PDSTRUCT *pPdStruct)
+{
+    XFU_TRACE_ZONE_ARG("file", sFileName);
+
+    RESULT result = {};
+    result.sFileName = sFileName;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    qint64 nCpuStart = UnpackProfiler::getThreadCpuTime();
+    quint64 nAllocationsStart = UnpackProfiler::getThreadAllocations();
+    quint64 nAllocatedBytesStart = UnpackProfiler::getThreadAllocatedBytes();
+
+    // With limits, the input gets its own PDSTRUCT: a hit stops this file, not the batch
+    const LIMITS &limits = options.limits;
+    bool bHasLimits = limits.nMaxOutputSize || limits.nMaxRatio || limits.nMaxEntries || limits.nMaxTime;
+
+    XBinary::PDSTRUCT pdStructFile = XBinary::createPdStruct();
+    XBinary::PDSTRUCT *pParentPdStruct = pPdStruct;
+    qint32 nWatch = -1;
+
+    if (bHasLimits) {
+        pPdStruct = &pdStructFile;
+        nWatch = LimitWatchdog::getInstance()->add(&pdStructFile, pParentPdStruct, limits.nMaxTime);
+    }
+
+    m_nWatch = nWatch;
+
+    QIODevice *pDevice = nullptr;
+
+    {
+        UnpackProfiler::Scope scope(&result.profile, UnpackProfiler::STAGE_OPEN);
+        XFU_TRACE_ZONE("open");
+        pDevice = MappedDevice::createInputDevice(sFileName, options.bMemoryMap);
+    }
+
+    if (pDevice) {
+        result.nSize = pDevice->size();
+        result.bIsMemoryMapped = (qobject_cast<MappedDevice *>(pDevice) != nullptr);
+
+        QString sCacheKey;
+
+        if (options.pResultCache && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            {
+                UnpackProfiler::Scope scope(&result.profile, UnpackProfiler::STAGE_HASH);
+                XFU_TRACE_ZONE("hash");
+                sCacheKey = ResultCache::getKey(pDevice, getOptionsKey(options), pPdStruct);
+            }
+
+            options.pResultCache->load(sCacheKey, sOutputDirectory, &result);
+        }
+
+        if (!result.bIsCached) {
+            AsyncWriter::GROUP writeGroup = {};
+            m_pWriteGroup = options.pAsyncWriter ? &writeGroup : nullptr;
+
+            processDevice(pDevice, sOutputDirectory, options, &result, pPdStruct);
+
+            if (m_pWriteGroup) {
+                // Reported and recorded as processed only once its files are on disk
+                setWriteFailures(options.pAsyncWriter->waitForGroup(m_pWriteGroup), &result);
+                m_pWriteGroup = nullptr;
+            }
+
+            // Under memory pressure the same input can unpack further next time; only complete results are kept
+            if (options.pResultCache && (result.status == STATUS_OK) && (!result.bIsBudgetLimited)) {
+                options.pResultCache->store(sCacheKey, sOutputDirectory, result);
+            }
+        }
+
+        pDevice->close();
+        delete pDevice;
+    } else {
+        result.status = STATUS_ERROR;
+        result.sErrorString = tr("Cannot open file: %1").arg(sFileName);
+    }
+
+    if (nWatch != -1) {
+        // A deadline that passed after the work was done did not cut anything short
+        if ((LimitWatchdog::getInstance()->remove(nWatch) == LimitWatchdog::REASON_TIME) && (result.status != STATUS_OK) && result.sLimit.isEmpty()) {
+            setLimitExceeded(&result, QStringLiteral("time"), pPdStruct);
+        }
+
+        m_nWatch = -1;
+    }
+
+    if (!result.sLimit.isEmpty()) {
+        result.status = STATUS_LIMIT;
+        result.sErrorString = tr("Limit exceeded: %1").arg(result.sLimit);
+    }
+
+    result.nElapsed = timer.elapsed();
+    result.profile.nCpuTime = UnpackProfiler::getThreadCpuTime() - nCpuStart;
+    result.profile.nAllocations = UnpackProfiler::getThreadAllocations() - nAllocationsStart;
+    result.profile.nAllocatedBytes = UnpackProfiler::getThreadAllocatedBytes() - nAllocatedBytesStart;
+
+    // Freed pages of large inputs and of every N files go back to the OS; RSS stays flat in long batches
+    m_nNumberOfFiles++;
+
+    if ((result.nSize >= N_TRIM_INPUT_SIZE) || ((m_nNumberOfFiles % N_TRIM_INTERVAL) == 0)) {
+        BufferPool::trimHeap();
+    }
+
+    return result;
+}
+
+void UnpackEngine::processDevice(QIODevice *pDevice, const QString &sOutputDirectory, const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    NODE node = analyzeDevice(pDevice, options, pResult, pPdStruct);
+
+    pResult->sFileType = node.sFileType;
+    pResult->scanResult = node.scanResult;
+
+    if (options.bExtract) {
+        processChildren(pDevice, node.fileType, QString(), 1, sOutputDirectory, options, pResult, pPdStruct);
+    }
+
+    if (pResult->status == STATUS_UNKNOWN) {
+        pResult->status = XBinary::isPdStructNotCanceled(pPdStruct) ? STATUS_OK : STATUS_ERROR;
+    }
+}
+
+UnpackEngine::NODE UnpackEngine::analyzeDevice(QIODevice *pDevice, const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    NODE result = {};
+
+    bool bIsSkipped = false;
+
+    // Carving looks for files anywhere, so it cannot go by the head
+    if (options.bTriage && (!options.bCarve)) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_TRIAGE);
+        XFU_TRACE_ZONE("triage");
+
+        FormatTriage::RESULT triage = FormatTriage::classify(pDevice);
+
+        if (triage.verdict == FormatTriage::VERDICT_SKIP) {
+            result.fileType = XBinary::FT_BINARY;
+            result.sFileType = triage.sName;
+            bIsSkipped = true;
+        }
+    }
+
+    if (!bIsSkipped) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_DETECT);
+        XFU_TRACE_ZONE("detect");
+
+        QSet<XBinary::FT> stFileTypes = XFormats::getFileTypes(pDevice, true, pPdStruct);
+        result.fileType = XBinary::_getPrefFileType(&stFileTypes);
+        result.sFileType = XBinary::fileTypeIdToString(result.fileType);
+    }
+
+    bool bScan = options.bScan && (!bIsSkipped);
+
+    if (bScan && options.pPrefilter) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_PREFILTER);
+        XFU_TRACE_ZONE("prefilter");
+
+        bScan = options.pPrefilter->hasHits(pDevice, pPdStruct);
+    }
+
+    if (bScan) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_SCAN);
+        XFU_TRACE_ZONE("scan");
+
+        XScanEngine::SCAN_OPTIONS scanOptions = options.scanOptions;
+
+        if (options.pScanEnginePool) {
+            XScanEngine *pScanEngine = options.pScanEnginePool->acquire(pPdStruct);
+
+            if (pScanEngine) {
+                result.scanResult = pScanEngine->scanDevice(pDevice, &scanOptions, pPdStruct);
+                options.pScanEnginePool->release(pScanEngine);
+            }
+        } else {
+            if (!m_pScanEngine) {
+                m_pScanEngine = new XScanEngine;
+            }
+
+            result.scanResult = m_pScanEngine->scanDevice(pDevice, &scanOptions, pPdStruct);
+        }
+    }
+
+    return result;
+}
+
+void UnpackEngine::processChildren(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory,
+                                   const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    if ((options.nMaxDepth > 0) && (nLevel > options.nMaxDepth)) {
+        return;
+    }
+
+    bool bIsUnpacked = false;
+
+    if (options.bUnpackExecutables && ((fileType == XBinary::FT_PE32) || (fileType == XBinary::FT_PE64))) {
+        bIsUnpacked = processUnpackedImage(pDevice, fileType, sParentPath, nLevel, sOutputDirectory, options, pResult, pPdStruct);
+    }
+
+    if (XArchives::getArchiveOpenValidFileTypes().contains(fileType)) {
+        processArchiveRecords(pDevice, fileType, sParentPath, nLevel, sOutputDirectory, options, pResult, pPdStruct);
+    } else if (options.bCarve && (!bIsUnpacked)) {
+        processCarvedRecords(pDevice, sParentPath, nLevel, sOutputDirectory, options, pResult, pPdStruct);
+    }
+}
+
+void UnpackEngine::processArchiveRecords(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory,
+                                         const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<XArchive::RECORD> listRecords;
+    QVector<qint32> listMatches;  // EntryFilter::MATCH flags
+
+    {
+        XFU_TRACE_ZONE_ARG("records", XBinary::fileTypeIdToString(fileType));
+
+        QList<XArchive::RECORD> _listRecords = XArchives::getRecords(pDevice, fileType, -1, pPdStruct);
+
+        qint32 _nNumberOfRecords = _listRecords.count();
+
+        for (qint32 i = 0; i < _nNumberOfRecords; i++) {
+            const QString &sRecordName = _listRecords.at(i).spInfo.sRecordName;
+
+            if (sRecordName.endsWith(QLatin1Char('/')) || sRecordName.endsWith(QLatin1Char('\\'))) {
+                continue;
+            }
+
+            // Records off the filter are dropped before anything is decoded
+            qint32 nMatch = EntryFilter::MATCH_TARGET;
+
+            if (options.pEntryFilter) {
+                nMatch = options.pEntryFilter->match(sParentPath.isEmpty() ? sRecordName : (sParentPath + QLatin1Char('/') + sRecordName));
+            }
+
+            if (nMatch != EntryFilter::MATCH_NONE) {
+                listRecords.append(_listRecords.at(i));
+                listMatches.append(nMatch);
+            }
+        }
+    }
+
+    qint32 nNumberOfRecords = listRecords.count();
+
+    // Entries of an in-memory parent are decoded a window at a time on the pool, each through
+    // its own QBuffer over the shared bytes; children are still processed in record order
+    const char *pData = options.pDecodePool ? getDeviceData(pDevice) : nullptr;
+    qint64 nDataSize = pDevice->size();
+    bool bIsFanOut = pData && (nNumberOfRecords > 1) && (nDataSize <= (qint64)std::numeric_limits<int>::max());
+    qint32 nWindow = bIsFanOut ? qMax(1, options.pDecodePool->maxThreadCount()) : 1;
+
+    for (qint32 i = 0; (i < nNumberOfRecords) && XBinary::isPdStructNotCanceled(pPdStruct); i += nWindow) {
+        qint32 nCount = qMin(nWindow, nNumberOfRecords - i);
+
+        QVector<qint64> listReserved(nCount, -1);  // -1: over budget
+        QVector<bool> listCommitted(nCount, false);
+        QVector<bool> listUnbounded(nCount, false);
+        QList<QFuture<DECODED>> listFutures;
+
+        qint64 nDeclaredSize = pResult->nOutputSize;
+
+        for (qint32 j = 0; j < nCount; j++) {
+            const XArchive::RECORD &record = listRecords.at(i + j);
+
+            // Header sizes catch the honest bombs before anything is decoded
+            nDeclaredSize += qMax(record.spInfo.nUncompressedSize, (qint64)0);
+
+            if ((options.limits.nMaxEntries > 0) && ((pResult->nNumberOfEntries + j) >= options.limits.nMaxEntries)) {
+                setLimitExceeded(pResult, QStringLiteral("entries"), pPdStruct);
+            } else {
+                checkOutputSize(nDeclaredSize, record.spInfo.nUncompressedSize, record.nDataSize, options.limits, pResult, pPdStruct);
+            }
+
+            if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+                nCount = j;
+                break;
+            }
+
+            QString sRelativePath = getSafeRelativePath(record.spInfo.sRecordName);
+
+            if ((!sOutputDirectory.isEmpty()) && (!sRelativePath.isEmpty()) && (listMatches.at(i + j) & EntryFilter::MATCH_TARGET)) {
+                listCommitted[j] = isCommitted(sOutputDirectory + QDir::separator() + sRelativePath, options);
+            }
+
+            if (listCommitted.at(j)) {
+                // Read back from its file later; nothing to decode or reserve
+                listReserved[j] = 0;
+
+                if (bIsFanOut) {
+                    listFutures.append(QFuture<DECODED>());
+                }
+
+                continue;
+            }
+
+            // A decoder filling a QByteArray is not watched, so a record that could inflate past the allowance,
+            // whatever its header says, is decoded to a file the watchdog follows
+            listUnbounded[j] = !isDecodeBounded(record, getOutputAllowance(options.limits, pResult, record.nDataSize));
+
+            // The child is decompressed once into memory and handed to the next stage from there
+            qint64 nReserved = qMax(record.spInfo.nUncompressedSize, (qint64)0);
+
+            bool bIsSpillOnly = listUnbounded.at(j);
+
+            if ((!bIsSpillOnly) && options.pMemoryBudget && (nReserved == 0)) {
+                // No size in the header: straight to disk when it can spill, otherwise an estimate is held
+                // until the decoded size is known and re-reserved
+                if (options.sSpillDirectory.isEmpty()) {
+                    nReserved = qMax(record.nDataSize * N_UNKNOWN_SIZE_RATIO, N_RATIO_MIN_SIZE);
+                } else {
+                    bIsSpillOnly = true;
+                }
+            }
+
+            if ((!bIsSpillOnly) && ((!options.pMemoryBudget) || options.pMemoryBudget->tryAcquire(nReserved))) {
+                listReserved[j] = nReserved;
+            }
+
+            if (bIsFanOut) {
+                if (listReserved.at(j) != -1) {
+                    listFutures.append(QtConcurrent::run(options.pDecodePool, [pData, nDataSize, record, fileType, pPdStruct]() {
+                        QByteArray baParent = QByteArray::fromRawData(pData, (int)nDataSize);
+                        QBuffer buffer(&baParent);
+                        buffer.open(QIODevice::ReadOnly);
+
+                        return decodeRecord(&buffer, record, fileType, 0, nullptr, pPdStruct);
+                    }));
+                } else {
+                    listFutures.append(QFuture<DECODED>());
+                }
+            }
+        }
+
+        for (qint32 j = 0; j < nCount; j++) {
+            XArchive::RECORD record = listRecords.at(i + j);
+
+            ENTRY entry = {};
+            entry.sName = record.spInfo.sRecordName;
+            entry.sPath = sParentPath.isEmpty() ? entry.sName : (sParentPath + QLatin1Char('/') + entry.sName);
+            entry.nLevel = nLevel;
+            entry.nCompressedSize = record.nDataSize;
+            entry.nUncompressedSize = record.spInfo.nUncompressedSize;
+
+            QString sRelativePath = getSafeRelativePath(entry.sName);
+
+            if (!sOutputDirectory.isEmpty() && !sRelativePath.isEmpty()) {
+                entry.sOutputFileName = sOutputDirectory + QDir::separator() + sRelativePath;
+            }
+
+            qint64 nReserved = listReserved.at(j);
+            bool bIsTarget = (listMatches.at(i + j) & EntryFilter::MATCH_TARGET);
+
+            if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+                // Decoders already running see the stop too; the rest of the window is dropped
+                if (bIsFanOut) {
+                    listFutures[j].waitForFinished();
+                }
+
+                if (options.pMemoryBudget && (nReserved != -1)) {
+                    options.pMemoryBudget->release(nReserved);
+                }
+
+                continue;
+            }
+
+            if (listCommitted.at(j)) {
+                QIODevice *pCommitted = MappedDevice::createInputDevice(entry.sOutputFileName, options.bMemoryMap);
+
+                if (pCommitted) {
+                    qint64 nFileSize = pCommitted->size();
+                    pResult->nOutputSize += nFileSize;
+
+                    if (checkOutputSize(pResult->nOutputSize, nFileSize, entry.nCompressedSize, options.limits, pResult, pPdStruct)) {
+                        processChild(pCommitted, &entry, bIsTarget, true, options, pResult, pPdStruct);
+                    } else {
+                        entry.sErrorString = tr("Limit exceeded: %1").arg(pResult->sLimit);
+                        addEntry(entry, options, pResult);
+                    }
+
+                    pCommitted->close();
+                    delete pCommitted;
+                } else {
+                    entry.sErrorString = tr("Cannot open file: %1").arg(entry.sOutputFileName);
+                    addEntry(entry, options, pResult);
+                }
+
+                continue;
+            }
+
+            if ((nReserved == -1) && ((!options.sSpillDirectory.isEmpty()) || listUnbounded.at(j))) {
+                // Decoded to disk and processed through a mapping, which the kernel can page out; nested children are still reached
+                bool bIsDirect = bIsTarget && (!entry.sOutputFileName.isEmpty()) && (!options.pOutputSink) && (!options.pDedupStore);
+                QString sSpillDirectory = options.sSpillDirectory.isEmpty() ? QDir::tempPath() : options.sSpillDirectory;
+
+                QTemporaryFile fileSpill(sSpillDirectory + QStringLiteral("/spill-XXXXXX"));
+                QString sFileName = entry.sOutputFileName;
+
+                if (!bIsDirect) {
+                    fileSpill.open();
+                    fileSpill.close();
+                    sFileName = fileSpill.fileName();
+                }
+
+                if (sFileName.isEmpty()) {
+                    entry.sErrorString = tr("Cannot spill: %1").arg(sSpillDirectory);
+                    addEntry(entry, options, pResult);
+                } else if (decodeRecordToFile(pDevice, &record, fileType, sFileName, options, &entry, pResult, pPdStruct)) {
+                    if (bIsDirect && options.pJournal) {
+                        options.pJournal->addOutput(sFileName, QFileInfo(sFileName).size());
+                    }
+
+                    processChildFile(sFileName, &entry, bIsTarget, bIsDirect, options, pResult, pPdStruct);
+                } else {
+                    addEntry(entry, options, pResult);
+                }
+
+                continue;
+            }
+
+            if (nReserved == -1) {
+                entry.sErrorString = tr("Memory budget exceeded");
+                pResult->bIsBudgetLimited = true;
+
+                // Written straight to disk, so a parent that is never a target cannot be opened
+                if (!entry.sOutputFileName.isEmpty() && bIsTarget) {
+                    // A sink cannot take a path, so the entry is staged on disk and streamed from there
+                    QTemporaryFile fileTemp;
+                    QString sFileName = entry.sOutputFileName;
+
+                    if (options.pOutputSink) {
+                        fileTemp.open();
+                        fileTemp.close();
+                        sFileName = fileTemp.fileName();
+                    } else if (options.pDedupStore && !options.pDedupStore->getDirectory().isEmpty()) {
+                        sFileName = options.pDedupStore->createTempFileName();
+                    }
+
+                    decodeRecordToFile(pDevice, &record, fileType, sFileName, options, &entry, pResult, pPdStruct);
+
+                    if ((sFileName != entry.sOutputFileName) && (!options.pOutputSink)) {
+                        // Too large to hash in memory, so the file is hashed after the decoder wrote it
+                        QByteArray baHash = entry.bIsValid ? FileStateIndex::getFileHash(sFileName, pPdStruct) : QByteArray();
+
+                        if (!baHash.isEmpty()) {
+                            qint64 nFileSize = QFileInfo(sFileName).size();
+
+                            entry.sHash = QString::fromLatin1(baHash.toHex());
+                            entry.bIsDuplicate = !options.pDedupStore->addObject(sFileName, baHash, nFileSize);
+                            entry.sOutputFileName = options.pDedupStore->getObjectFileName(baHash);
+                            options.pDedupStore->addReference(pResult->sFileName, entry.sPath, baHash, nFileSize);
+                        } else {
+                            entry.bIsValid = false;
+                            QFile::remove(sFileName);
+                        }
+                    }
+
+                    if (options.pJournal && entry.bIsValid && (sFileName == entry.sOutputFileName)) {
+                        options.pJournal->addOutput(sFileName, QFileInfo(sFileName).size());
+                    }
+
+                    if (options.pOutputSink && entry.bIsValid) {
+                        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_WRITE);
+                        XFU_TRACE_ZONE("write");
+
+                        QFile file(sFileName);
+
+                        entry.bIsValid = file.open(QIODevice::ReadOnly) && options.pOutputSink->writeEntry(entry.sOutputFileName, &file, pPdStruct);
+                    }
+                }
+
+                addEntry(entry, options, pResult);
+
+                continue;
+            }
+
+            DECODED decoded = {};
+            bool bIsSpilled = false;
+
+            {
+                // With fan-out this is the wait for the pool
+                UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_DECOMPRESS);
+
+                if (bIsFanOut) {
+                    decoded = listFutures[j].result();
+                } else {
+                    qint64 nAllowance = getOutputAllowance(options.limits, pResult, entry.nCompressedSize);
+                    decoded = decodeRecord(pDevice, record, fileType, nAllowance, options.pDecodePool, pPdStruct);
+                }
+            }
+
+            UnpackProfiler::addDecompressor(&pResult->profile, XArchive::compressMethodToString(record.spInfo.compressMethod), entry.nCompressedSize,
+                                            decoded.baData.size(), decoded.nWallTime);
+
+            pResult->nOutputSize += decoded.baData.size();
+
+            // Headers can lie; the decoded size is checked before the child goes any further
+            if (!checkOutputSize(pResult->nOutputSize, decoded.baData.size(), entry.nCompressedSize, options.limits, pResult, pPdStruct)) {
+                decoded.baData.clear();
+                entry.sErrorString = tr("Limit exceeded: %1").arg(pResult->sLimit);
+            }
+
+            if (options.pMemoryBudget && (decoded.baData.size() != nReserved)) {
+                // The header size was only an estimate
+                options.pMemoryBudget->release(nReserved);
+                nReserved = decoded.baData.size();
+
+                if (!options.pMemoryBudget->tryAcquire(nReserved)) {
+                    nReserved = 0;
+
+                    if (options.sSpillDirectory.isEmpty()) {
+                        decoded.baData.clear();
+                        entry.sErrorString = tr("Memory budget exceeded");
+                        pResult->bIsBudgetLimited = true;
+                    } else {
+                        bIsSpilled = true;
+                    }
+                }
+            }
+
+            QBuffer buffer(&decoded.baData);
+
+            if (bIsSpilled && entry.sErrorString.isEmpty()) {
+                // Larger than its header said; the bytes leave the heap before the child is opened
+                QTemporaryFile fileSpill(options.sSpillDirectory + QStringLiteral("/spill-XXXXXX"));
+
+                if (fileSpill.open() && (fileSpill.write(decoded.baData) == decoded.baData.size())) {
+                    fileSpill.close();
+                    decoded.baData.clear();
+
+                    processChildFile(fileSpill.fileName(), &entry, bIsTarget, false, options, pResult, pPdStruct);
+                } else {
+                    entry.sErrorString = tr("Cannot spill: %1").arg(options.sSpillDirectory);
+                    addEntry(entry, options, pResult);
+                }
+            } else if (entry.sErrorString.isEmpty() && buffer.open(QIODevice::ReadOnly)) {
+                processChild(&buffer, &entry, bIsTarget, false, options, pResult, pPdStruct);
+                buffer.close();
+            } else {
+                addEntry(entry, options, pResult);
+            }
+
+            decoded.baData.clear();
+
+            if (options.pMemoryBudget) {
+                options.pMemoryBudget->release(nReserved);
+            }
+        }
+    }
+}
+
+UnpackEngine::DECODED UnpackEngine::decodeRecord(QIODevice *pDevice, const XArchive::RECORD &record, XBinary::FT fileType, qint64 nMaxSize,
+                                                 QThreadPool *pDecodePool, XBinary::PDSTRUCT *pPdStruct)
+{
+    XFU_TRACE_ZONE_ARG("decompress", XArchive::compressMethodToString(record.spInfo.compressMethod));
+
+    DECODED result = {};
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool bIsValid = false;
+
+    if ((fileType == XBinary::FT_BZIP2) && pDecodePool) {
+        // A .bz2 is one record over the whole device
+        const char *pData = getDeviceData(pDevice);
+
+        if (pData) {
+            result.baData = ParallelDecoder::decompressBzip2(pData, pDevice->size(), nMaxSize, pDecodePool, &bIsValid, pPdStruct);
+        }
+    }
+
+    if (!bIsValid) {
+        XArchive::RECORD _record = record;
+        result.baData = XArchives::decompress(pDevice, &_record, pPdStruct);
+    }
+
+    result.nWallTime = timer.nsecsElapsed();
+
+    return result;
+}
+
+bool UnpackEngine::decodeRecordToFile(QIODevice *pDevice, XArchive::RECORD *pRecord, XBinary::FT fileType, const QString &sFileName, const OPTIONS &options,
+                                      ENTRY *pEntry, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_DECOMPRESS);
+    XFU_TRACE_ZONE_ARG("decompress", XArchive::compressMethodToString(pRecord->spInfo.compressMethod));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QDir().mkpath(QFileInfo(sFileName).absolutePath());
+
+    // The decoder writes the file itself; the watchdog follows its size
+    qint64 nAllowance = getOutputAllowance(options.limits, pResult, pEntry->nCompressedSize);
+
+    if ((m_nWatch != -1) && (nAllowance > 0)) {
+        LimitWatchdog::getInstance()->watchFile(m_nWatch, sFileName, nAllowance);
+    }
+
+    bool bIsDecoded = false;
+
+    if ((fileType == XBinary::FT_BZIP2) && options.pDecodePool) {
+        // Blocks go to the file in order as they finish, a window at a time, so size is not bounded by memory
+        const char *pData = getDeviceData(pDevice);
+
+        if (pData) {
+            QFile file(sFileName);
+
+            if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+                ParallelDecoder::decompressBzip2ToDevice(pData, pDevice->size(), nAllowance, &file, options.pDecodePool, &bIsDecoded, pPdStruct);
+                file.close();
+            }
+        }
+    }
+
+    pEntry->bIsValid = bIsDecoded || XArchives::decompressToFile(pDevice, pRecord, sFileName, pPdStruct);
+
+    if (m_nWatch != -1) {
+        LimitWatchdog::getInstance()->unwatchFile(m_nWatch);
+    }
+
+    qint64 nFileSize = QFileInfo(sFileName).size();
+    pResult->nOutputSize += nFileSize;
+
+    if (!checkOutputSize(pResult->nOutputSize, nFileSize, pEntry->nCompressedSize, options.limits, pResult, pPdStruct)) {
+        pEntry->bIsValid = false;
+        pEntry->sErrorString = tr("Limit exceeded: %1").arg(pResult->sLimit);
+    }
+
+    if (!pEntry->bIsValid) {
+        // Failed, canceled or cut off by the watchdog; nothing truncated stays in the output tree
+        QFile::remove(sFileName);
+    }
+
+    UnpackProfiler::addDecompressor(&pResult->profile, XArchive::compressMethodToString(pRecord->spInfo.compressMethod), pEntry->nCompressedSize, nFileSize,
+                                    timer.nsecsElapsed());
+
+    return pEntry->bIsValid;
+}
+
+void UnpackEngine::processChildFile(const QString &sFileName, ENTRY *pEntry, bool bIsTarget, bool bIsCommitted, const OPTIONS &options, RESULT *pResult,
+                                    XBinary::PDSTRUCT *pPdStruct)
+{
+    QIODevice *pDevice = MappedDevice::createInputDevice(sFileName, options.bMemoryMap);
+
+    if (pDevice) {
+        processChild(pDevice, pEntry, bIsTarget, bIsCommitted, options, pResult, pPdStruct);
+
+        pDevice->close();
+        delete pDevice;
+    } else {
+        pEntry->sErrorString = tr("Cannot open file: %1").arg(sFileName);
+        addEntry(*pEntry, options, pResult);
+    }
+}
+
+const char *UnpackEngine::getDeviceData(QIODevice *pDevice)
+{
+    const char *pResult = nullptr;
+
+    if (MappedDevice *pMappedDevice = qobject_cast<MappedDevice *>(pDevice)) {
+        pResult = pMappedDevice->data();
+    } else if (QBuffer *pBuffer = qobject_cast<QBuffer *>(pDevice)) {
+        pResult = pBuffer->data().constData();
+    }
+
+    return pResult;
+}
+
+qint64 UnpackEngine::getOutputAllowance(const LIMITS &limits, const RESULT *pResult, qint64 nCompressedSize)
+{
+    qint64 nResult = 0;
+
+    if (limits.nMaxOutputSize > 0) {
+        nResult = qMax(limits.nMaxOutputSize - pResult->nOutputSize, (qint64)1);
+    }
+
+    if ((limits.nMaxRatio > 0) && (nCompressedSize > 0)) {
+        qint64 nRatioSize = qMax(nCompressedSize * limits.nMaxRatio, N_RATIO_MIN_SIZE);
+        nResult = (nResult > 0) ? qMin(nResult, nRatioSize) : nRatioSize;
+    }
+
+    return nResult;
+}
+
+bool UnpackEngine::isDecodeBounded(const XArchive::RECORD &record, qint64 nAllowance)
+{
+    bool bResult = true;
+
+    if (nAllowance > 0) {
+        qint64 nMaxSize = -1;  // -1: no bound short of decoding it
+
+        if (record.spInfo.compressMethod == XArchive::COMPRESS_METHOD_STORE) {
+            nMaxSize = record.nDataSize;
+        } else if (record.spInfo.compressMethod == XArchive::COMPRESS_METHOD_DEFLATE) {
+            nMaxSize = record.nDataSize * N_DEFLATE_MAX_RATIO;
+        }
+
+        bResult = (nMaxSize != -1) && (nMaxSize <= nAllowance);
+    }
+
+    return bResult;
+}
+
+bool UnpackEngine::checkOutputSize(qint64 nTotalSize, qint64 nEntrySize, qint64 nCompressedSize, const LIMITS &limits, RESULT *pResult,
+                                   XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = true;
+
+    if ((limits.nMaxOutputSize > 0) && (nTotalSize > limits.nMaxOutputSize)) {
+        setLimitExceeded(pResult, QStringLiteral("output"), pPdStruct);
+        bResult = false;
+    } else if ((limits.nMaxRatio > 0) && (nCompressedSize > 0) && (nEntrySize > qMax(nCompressedSize * limits.nMaxRatio, N_RATIO_MIN_SIZE))) {
+        // Small entries are exempt: a few bytes of header can legitimately expand a hundredfold
+        setLimitExceeded(pResult, QStringLiteral("ratio"), pPdStruct);
+        bResult = false;
+    }
+
+    return bResult;
+}
+
+void UnpackEngine::setLimitExceeded(RESULT *pResult, const QString &sLimit, XBinary::PDSTRUCT *pPdStruct)
+{
+    if (pResult->sLimit.isEmpty()) {
+        pResult->sLimit = sLimit;
+    }
+
+    // Every loop below polls this; the whole input is abandoned
+    if (pPdStruct) {
+        pPdStruct->bIsStop = true;
+    }
+}
+
+void UnpackEngine::processCarvedRecords(QIODevice *pDevice, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory, const OPTIONS &options,
+                                        RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    XExtractor::DATA extractorData = {};
+    extractorData.options = XExtractor::getDefaultOptions();
+
+    XExtractor extractor;
+
+    {
+        XFU_TRACE_ZONE("carve");
+
+        extractor.setData(pDevice, &extractorData, pPdStruct);
+        extractor.process();
+    }
+
+    qint64 nDeviceSize = pDevice->size();
+    qint32 nNumberOfRecords = extractorData.listRecords.count();
+
+    for (qint32 i = 0; (i < nNumberOfRecords) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        const XExtractor::RECORD &record = extractorData.listRecords.at(i);
+
+        if ((record.nOffset == 0) && (record.nSize == nDeviceSize)) {
+            continue;
+        }
+
+        if ((options.limits.nMaxEntries > 0) && (pResult->nNumberOfEntries >= options.limits.nMaxEntries)) {
+            setLimitExceeded(pResult, QStringLiteral("entries"), pPdStruct);
+            break;
+        }
+
+        ENTRY entry = {};
+        entry.sName = QStringLiteral("%1.%2").arg(XBinary::valueToHex((quint64)record.nOffset), XBinary::fileTypeIdToString(record.fileType).toLower());
+        entry.sPath = sParentPath.isEmpty() ? entry.sName : (sParentPath + QLatin1Char('/') + entry.sName);
+        entry.nLevel = nLevel;
+        entry.nCompressedSize = record.nSize;
+        entry.nUncompressedSize = record.nSize;
+
+        if (!sOutputDirectory.isEmpty()) {
+            entry.sOutputFileName = sOutputDirectory + QDir::separator() + entry.sName;
+        }
+
+        qint32 nMatch = options.pEntryFilter ? options.pEntryFilter->match(entry.sPath) : EntryFilter::MATCH_TARGET;
+
+        if (nMatch == EntryFilter::MATCH_NONE) {
+            continue;
+        }
+
+        // Carved children are views on the parent, nothing is copied
+        SubDevice subDevice(pDevice, record.nOffset, record.nSize);
+
+        bool bIsTarget = (nMatch & EntryFilter::MATCH_TARGET);
+
+        if (subDevice.open(QIODevice::ReadOnly)) {
+            processChild(&subDevice, &entry, bIsTarget, bIsTarget && isCommitted(entry.sOutputFileName, options), options, pResult, pPdStruct);
+            subDevice.close();
+        }
+    }
+}
+
+bool UnpackEngine::processUnpackedImage(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory,
+                                        const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = false;
+
+    if ((options.limits.nMaxEntries > 0) && (pResult->nNumberOfEntries >= options.limits.nMaxEntries)) {
+        setLimitExceeded(pResult, QStringLiteral("entries"), pPdStruct);
+        return false;
+    }
+
+    ENTRY entry = {};
+    entry.sName = QStringLiteral("unpacked.%1").arg(XBinary::fileTypeIdToString(fileType).toLower());
+    entry.sPath = sParentPath.isEmpty() ? entry.sName : (sParentPath + QLatin1Char('/') + entry.sName);
+    entry.nLevel = nLevel;
+    entry.nCompressedSize = pDevice->size();
+
+    if (!sOutputDirectory.isEmpty()) {
+        entry.sOutputFileName = sOutputDirectory + QDir::separator() + entry.sName;
+    }
+
+    qint32 nMatch = options.pEntryFilter ? options.pEntryFilter->match(entry.sPath) : EntryFilter::MATCH_TARGET;
+
+    if (nMatch == EntryFilter::MATCH_NONE) {
+        return false;
+    }
+
+    // The image is held in memory like a decoded record; its size is only known afterwards
+    qint64 nReserved = qMax(entry.nCompressedSize * N_UNKNOWN_SIZE_RATIO, N_RATIO_MIN_SIZE);
+
+    if (options.pMemoryBudget && (!options.pMemoryBudget->tryAcquire(nReserved))) {
+        pResult->bIsBudgetLimited = true;
+        return false;
+    }
+
+    QByteArray baImage;
+
+    {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_DECOMPRESS);
+        XFU_TRACE_ZONE("static unpack");
+
+        QBuffer bufferImage(&baImage);
+
+        if (bufferImage.open(QIODevice::WriteOnly)) {
+            XStaticUnpacker staticUnpacker;
+            bResult = staticUnpacker.unpack(pDevice, &bufferImage, pPdStruct) && (!baImage.isEmpty());
+            bufferImage.close();
+        }
+    }
+
+    if (bResult) {
+        entry.nUncompressedSize = baImage.size();
+        pResult->nOutputSize += baImage.size();
+
+        if (!checkOutputSize(pResult->nOutputSize, baImage.size(), entry.nCompressedSize, options.limits, pResult, pPdStruct)) {
+            baImage.clear();
+            entry.sErrorString = tr("Limit exceeded: %1").arg(pResult->sLimit);
+        }
+
+        if (options.pMemoryBudget && (baImage.size() > nReserved)) {
+            options.pMemoryBudget->release(nReserved);
+            nReserved = baImage.size();
+
+            if (!options.pMemoryBudget->tryAcquire(nReserved)) {
+                nReserved = 0;
+                baImage.clear();
+                entry.sErrorString = tr("Memory budget exceeded");
+                pResult->bIsBudgetLimited = true;
+            }
+        }
+
+        QBuffer buffer(&baImage);
+        bool bIsTarget = (nMatch & EntryFilter::MATCH_TARGET);
+
+        if (entry.sErrorString.isEmpty() && buffer.open(QIODevice::ReadOnly)) {
+            processChild(&buffer, &entry, bIsTarget, bIsTarget && isCommitted(entry.sOutputFileName, options), options, pResult, pPdStruct);
+            buffer.close();
+        } else {
+            addEntry(entry, options, pResult);
+        }
+
+        baImage.clear();
+    }
+
+    if (options.pMemoryBudget) {
+        options.pMemoryBudget->release(nReserved);
+    }
+
+    return bResult;
+}
+
+void UnpackEngine::processChild(QIODevice *pDevice, ENTRY *pEntry, bool bIsTarget, bool bIsCommitted, const OPTIONS &options, RESULT *pResult,
+                                XBinary::PDSTRUCT *pPdStruct)
+{
+    pEntry->bIsValid = true;
+
+    DedupStore *pDedupStore = options.pOutputSink ? nullptr : options.pDedupStore;
+
+    // A parent of a filter match is only opened; its output name still places the children
+    QString sParentFileName = pEntry->sOutputFileName;
+
+    if (!bIsTarget) {
+        pEntry->sOutputFileName.clear();
+    } else if (bIsCommitted) {
+        // On disk since an interrupted run; pDevice reads that file
+    } else if (pDedupStore) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_WRITE);
+        XFU_TRACE_ZONE("write");
+
+        // Hashed while it is written; the store keeps the first copy and drops the others
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        QString sTempFileName = pEntry->sOutputFileName.isEmpty() ? QString() : pDedupStore->createTempFileName();
+
+        pEntry->bIsValid = writeDeviceToFile(pDevice, sTempFileName, &hash, pPdStruct);
+
+        if (pEntry->bIsValid) {
+            QByteArray baHash = hash.result();
+
+            pEntry->sHash = QString::fromLatin1(baHash.toHex());
+            pEntry->bIsDuplicate = !pDedupStore->addObject(sTempFileName, baHash, pDevice->size());
+
+            if (!sTempFileName.isEmpty()) {
+                pEntry->sOutputFileName = pDedupStore->getObjectFileName(baHash);
+                pDedupStore->addReference(pResult->sFileName, pEntry->sPath, baHash, pDevice->size());
+            }
+        } else if (!sTempFileName.isEmpty()) {
+            QFile::remove(sTempFileName);
+        }
+    } else if (!pEntry->sOutputFileName.isEmpty()) {
+        UnpackProfiler::Scope scope(&pResult->profile, UnpackProfiler::STAGE_WRITE);
+        XFU_TRACE_ZONE("write");
+
+        QBuffer *pBuffer = qobject_cast<QBuffer *>(pDevice);
+
+        // The cache copies the files right after processing, so it keeps the synchronous path
+        bool bIsQueued = (!options.pOutputSink) && options.pAsyncWriter && pBuffer && (!options.pResultCache) &&
+                         options.pAsyncWriter->write(pEntry->sOutputFileName, pBuffer->data(), options.pMemoryBudget, m_pWriteGroup);
+
+        if (options.pOutputSink) {
+            pEntry->bIsValid = options.pOutputSink->writeEntry(pEntry->sOutputFileName, pDevice, pPdStruct);
+        } else if (bIsQueued) {
+            pEntry->bIsValid = true;
+        } else {
+            pEntry->bIsValid = writeDeviceToFile(pDevice, pEntry->sOutputFileName, nullptr, pPdStruct);
+
+            if (pEntry->bIsValid && options.pJournal) {
+                options.pJournal->addOutput(pEntry->sOutputFileName, pDevice->size());
+            }
+        }
+    }
+
+    if (!pEntry->bIsValid) {
+        pEntry->sErrorString = tr("Cannot write: %1").arg(pEntry->sOutputFileName);
+        pResult->status = STATUS_ERROR;
+        pResult->sErrorString = tr("Cannot extract: %1").arg(pEntry->sPath);
+    }
+
+    if (pEntry->bIsDuplicate) {
+        // Detections and children are reported once, with the first copy
+        addEntry(*pEntry, options, pResult);
+    } else {
+        NODE node = {};
+
+        if (bIsTarget) {
+            node = analyzeDevice(pDevice, options, pResult, pPdStruct);
+        } else {
+            OPTIONS optionsParent = options;
+            optionsParent.bScan = false;
+
+            node = analyzeDevice(pDevice, optionsParent, pResult, pPdStruct);
+        }
+
+        pEntry->sFileType = node.sFileType;
+        pEntry->scanResult = node.scanResult;
+
+        if (bIsTarget) {
+            addEntry(*pEntry, options, pResult);
+        } else {
+            pEntry->sOutputFileName = sParentFileName;
+        }
+
+        QString sOutputDirectory;
+
+        if (!pEntry->sOutputFileName.isEmpty()) {
+            sOutputDirectory = pEntry->sOutputFileName + QStringLiteral(".unpacked");
+        }
+
+        processChildren(pDevice, node.fileType, pEntry->sPath, pEntry->nLevel + 1, sOutputDirectory, options, pResult, pPdStruct);
+    }
+}
+
+bool UnpackEngine::isCommitted(const QString &sOutputFileName, const OPTIONS &options)
+{
+    // Streams and the dedup store name their files differently; they are always decoded
+    return options.pJournal && (!options.pOutputSink) && (!options.pDedupStore) && (!sOutputFileName.isEmpty()) &&
+           options.pJournal->isOutputCommitted(sOutputFileName);
+}
+
+void UnpackEngine::setWriteFailures(const QStringList &listFileNames, RESULT *pResult)
+{
+    qint32 nNumberOfFileNames = listFileNames.count();
+
+    for (qint32 i = 0; i < nNumberOfFileNames; i++) {
+        // Entries already handed to OPTIONS::pResultWriter cannot be corrected; the input still fails
+        qint32 nNumberOfEntries = pResult->listEntries.count();
+
+        for (qint32 j = 0; j < nNumberOfEntries; j++) {
+            ENTRY &entry = pResult->listEntries[j];
+
+            if (entry.sOutputFileName == listFileNames.at(i)) {
+                entry.bIsValid = false;
+                entry.sErrorString = tr("Cannot write: %1").arg(entry.sOutputFileName);
+            }
+        }
+
+        pResult->status = STATUS_ERROR;
+        pResult->sErrorString = tr("Cannot write: %1").arg(listFileNames.at(i));
+    }
+}
+
+void UnpackEngine::addEntry(const ENTRY &entry, const OPTIONS &options, RESULT *pResult)
+{
+    pResult->nNumberOfEntries++;
+
+    // The cache stores the whole result, so it needs the list; with a journal the entry records go out
+    // with the input record, so an input cut short by a crash leaves none to be written again on resume
+    if (options.pResultWriter && (!options.pResultCache) && (!options.pJournal)) {
+        options.pResultWriter->writeEntry(pResult->sFileName, entry);
+    } else {
+        pResult->listEntries.append(entry);
+    }
+}
+
+bool UnpackEngine::writeDeviceToFile(QIODevice *pDevice, const QString &sFileName, QCryptographicHash *pHash, XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = false;
+
+    QFile file(sFileName);
+
+    if (!sFileName.isEmpty()) {
+        QDir().mkpath(QFileInfo(sFileName).absolutePath());
+        bResult = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    } else {
+        bResult = (pHash != nullptr);
+    }
+
+    if (bResult) {
+        const qint32 nBufferSize = 0x100000;
+        QByteArray baBuffer = m_bufferPool.acquire(nBufferSize);
+
+        pDevice->seek(0);
+
+        while (bResult && XBinary::isPdStructNotCanceled(pPdStruct)) {
+            qint64 nRead = pDevice->read(baBuffer.data(), nBufferSize);
+
+            if (nRead <= 0) {
+                bResult = (nRead == 0);
+                break;
+            }
+
+            if (pHash) {
+                pHash->addData(baBuffer.constData(), (int)nRead);
+            }
+
+            if (file.isOpen()) {
+                bResult = (file.write(baBuffer.constData(), nRead) == nRead);
+            }
+        }
+
+        m_bufferPool.release(baBuffer);
+
+        // A stop leaves a truncated file, which must not pass for the entry
+        bResult = bResult && XBinary::isPdStructNotCanceled(pPdStruct);
+
+        if (file.isOpen()) {
+            file.close();
+
+            if (!bResult) {
+                file.remove();
+            }
+        }
+    }
+
+    return bResult;
+}
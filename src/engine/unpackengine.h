@@ -0,0 +1,209 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKENGINE_H
+#define UNPACKENGINE_H
+
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include "asyncwriter.h"
+#include "bufferpool.h"
+#include "dedupstore.h"
+#include "limitwatchdog.h"
+#include "mappeddevice.h"
+#include "memorybudget.h"
+#include "scanenginepool.h"
+#include "signatureprefilter.h"
+#include "subdevice.h"
+#include "unpackprofiler.h"
+#include "xarchives.h"
+#include "xextractor.h"
+#include "xformats.h"
+#include "xscanengine.h"
+#include "xstaticunpacker.h"
+
+class BatchJournal;
+class OutputSink;
+class EntryFilter;
+class ResultCache;
+class ResultWriter;
+
+// One unpack/scan pipeline. An instance is not thread-safe; batch workers own one each.
+class UnpackEngine : public QObject {
+    Q_OBJECT
+
+public:
+    enum STATUS {
+        STATUS_UNKNOWN = 0,
+        STATUS_OK,
+        STATUS_ERROR,
+        STATUS_LIMIT  // Aborted by OPTIONS::limits; sLimit names the one that was hit
+    };
+
+    // Per input, over all nesting levels; 0: unlimited
+    struct LIMITS {
+        qint64 nMaxOutputSize;  // Bytes decompressed
+        qint64 nMaxRatio;       // Uncompressed / compressed size of one entry
+        qint32 nMaxEntries;
+        qint64 nMaxTime;        // ms
+    };
+
+    struct OPTIONS {
+        XScanEngine::SCAN_OPTIONS scanOptions;
+        bool bScan;
+        bool bExtract;
+        bool bCarve;                           // XExtractor pass over files that are not archives
+        bool bUnpackExecutables;               // XStaticUnpacker pass over PE files; the unpacked image becomes their child
+        bool bMemoryMap;                       // Falls back to buffered reads where mapping is unsafe
+        bool bTriage;                          // Plain data by FormatTriage skips detection, scan and unpacking; off with bCarve
+        qint32 nMaxDepth;                      // 1: entries of the input only
+        MemoryBudget *pMemoryBudget;           // Shared by all workers; nullptr: unlimited
+        ResultCache *pResultCache;             // nullptr: no cache
+        OutputSink *pOutputSink;               // Receives entries instead of files; output names become stream names
+        const SignaturePrefilter *pPrefilter;  // Scan runs only where an anchor hits; nullptr: always
+        ScanEnginePool *pScanEnginePool;       // Engines shared by all pipelines; nullptr: one per UnpackEngine
+        const EntryFilter *pEntryFilter;       // Only matching entries and the containers on their way; nullptr: all
+        QThreadPool *pDecodePool;              // Entries and bzip2 blocks decoded in parallel; nullptr: sequential
+        DedupStore *pDedupStore;               // Identical children written and scanned once; ignored with pOutputSink
+        AsyncWriter *pAsyncWriter;             // In-memory entries written in the background; the input waits for its own; not with pResultCache
+        ResultWriter *pResultWriter;           // Takes entries as they finish instead of RESULT::listEntries; not with pResultCache or pJournal
+        BatchJournal *pJournal;                // Written entry files are recorded; committed ones are read back, not decoded
+        QString sSpillDirectory;               // Children over pMemoryBudget are decoded to files here; empty: not unpacked
+        QString sSignatureStamp;               // Version of the scan engine's signature database; a new one invalidates pResultCache
+        LIMITS limits;
+    };
+
+    struct ENTRY {
+        QString sName;
+        QString sPath;  // Chain from the input, e.g. a.zip/b.msi/c.exe
+        qint32 nLevel;
+        qint64 nCompressedSize;
+        qint64 nUncompressedSize;
+        QString sFileType;
+        QString sOutputFileName;
+        XScanEngine::SCAN_RESULT scanResult;
+        bool bIsValid;
+        QString sErrorString;
+        QString sHash;      // SHA-1, with OPTIONS::pDedupStore
+        bool bIsDuplicate;  // Seen before in this run; not scanned or unpacked again
+    };
+
+    struct RESULT {
+        QString sFileName;
+        qint64 nSize;
+        bool bIsMemoryMapped;
+        bool bIsCached;
+        STATUS status;
+        QString sFileType;
+        QList<ENTRY> listEntries;  // Empty for entries that went to OPTIONS::pResultWriter
+        qint32 nNumberOfEntries;
+        XScanEngine::SCAN_RESULT scanResult;
+        QString sErrorString;
+        qint64 nElapsed;
+        qint64 nOutputSize;     // Bytes decompressed from all entries
+        QString sLimit;         // output, ratio, entries or time
+        bool bIsBudgetLimited;  // A child was not unpacked for lack of OPTIONS::pMemoryBudget; not cached
+        UnpackProfiler::PROFILE profile;
+    };
+
+    explicit UnpackEngine(QObject *pParent = nullptr);
+    ~UnpackEngine() override;
+
+    static OPTIONS getDefaultOptions();
+    static QString statusToString(STATUS status);
+    // Everything in OPTIONS that changes the result
+    static QString getOptionsKey(const OPTIONS &options);
+    // Keeps archive record names inside the output directory
+    static QString getSafeRelativePath(const QString &sRecordName);
+
+    RESULT processFile(const QString &sFileName, const QString &sOutputDirectory, const OPTIONS &options, XBinary::PDSTRUCT *pPdStruct = nullptr);
+
+private:
+    struct NODE {
+        XBinary::FT fileType;
+        QString sFileType;
+        XScanEngine::SCAN_RESULT scanResult;
+    };
+
+    struct DECODED {
+        QByteArray baData;
+        qint64 nWallTime;  // ns, on the decoding thread
+    };
+
+    void processDevice(QIODevice *pDevice, const QString &sOutputDirectory, const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    NODE analyzeDevice(QIODevice *pDevice, const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    void processChildren(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory, const OPTIONS &options,
+                         RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    void processArchiveRecords(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory,
+                               const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    static DECODED decodeRecord(QIODevice *pDevice, const XArchive::RECORD &record, XBinary::FT fileType, qint64 nMaxSize, QThreadPool *pDecodePool,
+                                XBinary::PDSTRUCT *pPdStruct);
+    // Under the watchdog and the output limits; false: pEntry carries the reason, if any
+    bool decodeRecordToFile(QIODevice *pDevice, XArchive::RECORD *pRecord, XBinary::FT fileType, const QString &sFileName, const OPTIONS &options, ENTRY *pEntry,
+                            RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    // Bytes the entry may decompress to before a limit is hit; 0: unlimited
+    static qint64 getOutputAllowance(const LIMITS &limits, const RESULT *pResult, qint64 nCompressedSize);
+    // Whatever the header says, the method cannot expand the record past nAllowance
+    static bool isDecodeBounded(const XArchive::RECORD &record, qint64 nAllowance);
+    static bool checkOutputSize(qint64 nTotalSize, qint64 nEntrySize, qint64 nCompressedSize, const LIMITS &limits, RESULT *pResult,
+                                XBinary::PDSTRUCT *pPdStruct);
+    static void setLimitExceeded(RESULT *pResult, const QString &sLimit, XBinary::PDSTRUCT *pPdStruct);
+    static const char *getDeviceData(QIODevice *pDevice);
+    void processCarvedRecords(QIODevice *pDevice, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory, const OPTIONS &options,
+                              RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    // False if XStaticUnpacker does not support the packer, or pDevice is not packed
+    bool processUnpackedImage(QIODevice *pDevice, XBinary::FT fileType, const QString &sParentPath, qint32 nLevel, const QString &sOutputDirectory,
+                              const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    // bIsTarget false: a parent of an EntryFilter match, opened for its children only; bIsCommitted: pDevice is the output file itself
+    void processChild(QIODevice *pDevice, ENTRY *pEntry, bool bIsTarget, bool bIsCommitted, const OPTIONS &options, RESULT *pResult, XBinary::PDSTRUCT *pPdStruct);
+    // processChild() over a mapping of sFileName
+    void processChildFile(const QString &sFileName, ENTRY *pEntry, bool bIsTarget, bool bIsCommitted, const OPTIONS &options, RESULT *pResult,
+                          XBinary::PDSTRUCT *pPdStruct);
+    // The entry file was written completely by an earlier, interrupted run
+    static bool isCommitted(const QString &sOutputFileName, const OPTIONS &options);
+    static void addEntry(const ENTRY &entry, const OPTIONS &options, RESULT *pResult);
+    // Files AsyncWriter could not write fail their entries and the input
+    static void setWriteFailures(const QStringList &listFileNames, RESULT *pResult);
+    // Empty sFileName: hash only
+    bool writeDeviceToFile(QIODevice *pDevice, const QString &sFileName, QCryptographicHash *pHash, XBinary::PDSTRUCT *pPdStruct);
+
+    static const qint32 N_TRIM_INTERVAL = 64;                  // Files
+    static const qint64 N_TRIM_INPUT_SIZE = 64 * 1024 * 1024;  // Bytes
+    static const qint64 N_RATIO_MIN_SIZE = 1024 * 1024;        // Entries below are not ratio-checked
+    static const qint64 N_UNKNOWN_SIZE_RATIO = 8;              // Reserved per compressed byte when the header has no size
+    static const qint64 N_DEFLATE_MAX_RATIO = 1032;            // Largest expansion a deflate stream can encode
+
+    XScanEngine *m_pScanEngine;  // Own engine; created on the first scan without OPTIONS::pScanEnginePool
+    BufferPool m_bufferPool;
+    qint64 m_nNumberOfFiles;
+    qint32 m_nWatch;                    // Watchdog id of the current input; -1: none
+    AsyncWriter::GROUP *m_pWriteGroup;  // Queued files of the current input; nullptr: no OPTIONS::pAsyncWriter
+};
+
+#endif  // UNPACKENGINE_H
@@ -0,0 +1,226 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpackprofiler.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef USE_ALLOCATION_COUNTERS
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local quint64 g_nThreadAllocations = 0;
+thread_local quint64 g_nThreadAllocatedBytes = 0;
+
+void *_allocate(std::size_t nSize)
+{
+    g_nThreadAllocations++;
+    g_nThreadAllocatedBytes += nSize;
+
+    return std::malloc(nSize ? nSize : 1);
+}
+
+}  // namespace
+
+void *operator new(std::size_t nSize)
+{
+    void *pResult = _allocate(nSize);
+
+    if (!pResult) {
+        throw std::bad_alloc();
+    }
+
+    return pResult;
+}
+
+void *operator new[](std::size_t nSize)
+{
+    return operator new(nSize);
+}
+
+void *operator new(std::size_t nSize, const std::nothrow_t &) noexcept
+{
+    return _allocate(nSize);
+}
+
+void *operator new[](std::size_t nSize, const std::nothrow_t &) noexcept
+{
+    return _allocate(nSize);
+}
+
+void operator delete(void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, const std::nothrow_t &) noexcept
+{
+    std::free(pMemory);
+}
+#endif
+
+UnpackProfiler::Scope::Scope(PROFILE *pProfile, STAGE stage) : m_pStageTime(&pProfile->stages[stage]), m_nCpuStart(getThreadCpuTime())
+{
+    m_timer.start();
+}
+
+UnpackProfiler::Scope::~Scope()
+{
+    m_pStageTime->nWallTime += m_timer.nsecsElapsed();
+    m_pStageTime->nCpuTime += getThreadCpuTime() - m_nCpuStart;
+    m_pStageTime->nCount++;
+}
+
+QString UnpackProfiler::stageToString(STAGE stage)
+{
+    QString sResult;
+
+    switch (stage) {
+        case STAGE_OPEN: sResult = QStringLiteral("open"); break;
+        case STAGE_HASH: sResult = QStringLiteral("hash"); break;
+        case STAGE_TRIAGE: sResult = QStringLiteral("triage"); break;
+        case STAGE_DETECT: sResult = QStringLiteral("detect"); break;
+        case STAGE_PREFILTER: sResult = QStringLiteral("prefilter"); break;
+        case STAGE_SCAN: sResult = QStringLiteral("scan"); break;
+        case STAGE_DECOMPRESS: sResult = QStringLiteral("decompress"); break;
+        case STAGE_WRITE: sResult = QStringLiteral("write"); break;
+        default: sResult = QStringLiteral("unknown");
+    }
+
+    return sResult;
+}
+
+qint64 UnpackProfiler::getThreadCpuTime()
+{
+    qint64 nResult = 0;
+#ifdef Q_OS_WIN
+    FILETIME ftCreation, ftExit, ftKernel, ftUser;
+
+    if (GetThreadTimes(GetCurrentThread(), &ftCreation, &ftExit, &ftKernel, &ftUser)) {
+        quint64 nKernel = ((quint64)ftKernel.dwHighDateTime << 32) | ftKernel.dwLowDateTime;
+        quint64 nUser = ((quint64)ftUser.dwHighDateTime << 32) | ftUser.dwLowDateTime;
+
+        nResult = (qint64)((nKernel + nUser) * 100);
+    }
+#else
+    struct timespec ts = {};
+
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        nResult = (qint64)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+#endif
+    return nResult;
+}
+
+quint64 UnpackProfiler::getThreadAllocations()
+{
+#ifdef USE_ALLOCATION_COUNTERS
+    return g_nThreadAllocations;
+#else
+    return 0;
+#endif
+}
+
+quint64 UnpackProfiler::getThreadAllocatedBytes()
+{
+#ifdef USE_ALLOCATION_COUNTERS
+    return g_nThreadAllocatedBytes;
+#else
+    return 0;
+#endif
+}
+
+void UnpackProfiler::addDecompressor(PROFILE *pProfile, const QString &sMethod, qint64 nBytesIn, qint64 nBytesOut, qint64 nWallTime)
+{
+    DECOMPRESSOR_STAT &stat = pProfile->mapDecompressors[sMethod];
+    stat.nCount++;
+    stat.nBytesIn += nBytesIn;
+    stat.nBytesOut += nBytesOut;
+    stat.nWallTime += nWallTime;
+}
+
+QJsonObject UnpackProfiler::profileToJson(const PROFILE &profile)
+{
+    QJsonObject jsStages;
+
+    for (qint32 i = 0; i < __STAGE_SIZE; i++) {
+        const STAGE_TIME &stageTime = profile.stages[i];
+
+        if (stageTime.nCount) {
+            QJsonObject jsStage;
+            jsStage.insert(QStringLiteral("wall_us"), (double)(stageTime.nWallTime / 1000));
+            jsStage.insert(QStringLiteral("cpu_us"), (double)(stageTime.nCpuTime / 1000));
+            jsStage.insert(QStringLiteral("count"), (double)stageTime.nCount);
+
+            jsStages.insert(stageToString((STAGE)i), jsStage);
+        }
+    }
+
+    QJsonObject jsDecompressors;
+
+    QMapIterator<QString, DECOMPRESSOR_STAT> it(profile.mapDecompressors);
+
+    while (it.hasNext()) {
+        it.next();
+
+        QJsonObject jsDecompressor;
+        jsDecompressor.insert(QStringLiteral("count"), (double)it.value().nCount);
+        jsDecompressor.insert(QStringLiteral("bytes_in"), (double)it.value().nBytesIn);
+        jsDecompressor.insert(QStringLiteral("bytes_out"), (double)it.value().nBytesOut);
+        jsDecompressor.insert(QStringLiteral("wall_us"), (double)(it.value().nWallTime / 1000));
+
+        jsDecompressors.insert(it.key(), jsDecompressor);
+    }
+
+    QJsonObject jsResult;
+    jsResult.insert(QStringLiteral("cpu_us"), (double)(profile.nCpuTime / 1000));
+    jsResult.insert(QStringLiteral("stages"), jsStages);
+    jsResult.insert(QStringLiteral("decompressors"), jsDecompressors);
+    jsResult.insert(QStringLiteral("allocations"), (double)profile.nAllocations);
+    jsResult.insert(QStringLiteral("allocated_bytes"), (double)profile.nAllocatedBytes);
+
+    return jsResult;
+}
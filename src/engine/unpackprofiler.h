@@ -0,0 +1,85 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKPROFILER_H
+#define UNPACKPROFILER_H
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+
+// Per-file counters of the unpack pipeline. Always collected: a stage costs two
+// clock reads, allocations one thread-local increment.
+class UnpackProfiler {
+public:
+    enum STAGE {
+        STAGE_OPEN = 0,
+        STAGE_HASH,
+        STAGE_TRIAGE,
+        STAGE_DETECT,
+        STAGE_PREFILTER,
+        STAGE_SCAN,
+        STAGE_DECOMPRESS,
+        STAGE_WRITE,
+        __STAGE_SIZE
+    };
+
+    struct STAGE_TIME {
+        qint64 nWallTime;  // ns
+        qint64 nCpuTime;   // ns, calling thread
+        qint64 nCount;
+    };
+
+    struct DECOMPRESSOR_STAT {
+        qint64 nCount;
+        qint64 nBytesIn;
+        qint64 nBytesOut;
+        qint64 nWallTime;  // ns
+    };
+
+    struct PROFILE {
+        STAGE_TIME stages[__STAGE_SIZE];
+        QMap<QString, DECOMPRESSOR_STAT> mapDecompressors;
+        qint64 nCpuTime;
+        quint64 nAllocations;  // operator new calls with USE_ALLOCATION_COUNTERS, else 0; QByteArray/QString data goes to malloc and is not counted
+        quint64 nAllocatedBytes;
+    };
+
+    class Scope {
+    public:
+        Scope(PROFILE *pProfile, STAGE stage);
+        ~Scope();
+
+    private:
+        STAGE_TIME *m_pStageTime;
+        QElapsedTimer m_timer;
+        qint64 m_nCpuStart;
+    };
+
+    static QString stageToString(STAGE stage);
+    static qint64 getThreadCpuTime();
+    static quint64 getThreadAllocations();
+    static quint64 getThreadAllocatedBytes();
+    static void addDecompressor(PROFILE *pProfile, const QString &sMethod, qint64 nBytesIn, qint64 nBytesOut, qint64 nWallTime);
+    static QJsonObject profileToJson(const PROFILE &profile);
+};
+
+#endif  // UNPACKPROFILER_H
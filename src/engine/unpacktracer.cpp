@@ -0,0 +1,202 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "unpacktracer.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+
+namespace {
+
+struct EVENT {
+    const char *pszName;
+    QString sArg;
+    qint64 nBegin;     // ns since start()
+    qint64 nDuration;  // ns
+};
+
+struct THREAD {
+    qint32 nId;
+    QString sName;
+    QMutex mutex;  // Taken by the owner per event and by the export; never contended during a run
+    QVector<EVENT> listEvents;
+    qint64 nNumberOfDropped;
+};
+
+const qint32 N_MAX_EVENTS = 1000000;  // Per thread; later zones are counted, not kept
+
+QBasicAtomicInt g_nIsStarted = Q_BASIC_ATOMIC_INITIALIZER(0);
+QElapsedTimer g_timer;
+QMutex g_mutexThreads;
+QList<THREAD *> g_listThreads;  // Kept after their threads exit
+thread_local THREAD *g_pThread = nullptr;
+
+THREAD *getThread()
+{
+    if (!g_pThread) {
+        QMutexLocker locker(&g_mutexThreads);
+
+        THREAD *pThread = new THREAD;
+        pThread->nId = g_listThreads.count() + 1;
+        pThread->sName = QThread::currentThread()->objectName();
+        pThread->nNumberOfDropped = 0;
+
+        if (pThread->sName.isEmpty()) {
+            pThread->sName = QStringLiteral("thread %1").arg(pThread->nId);
+        }
+
+        g_listThreads.append(pThread);
+        g_pThread = pThread;
+    }
+
+    return g_pThread;
+}
+
+}  // namespace
+
+UnpackTracer::Zone::Zone(const char *pszName, const QString &sArg) : m_pszName(pszName), m_nBegin(-1)
+{
+    if (isStarted()) {
+        m_sArg = sArg;
+        m_nBegin = g_timer.nsecsElapsed();
+    }
+}
+
+UnpackTracer::Zone::~Zone()
+{
+    if (m_nBegin != -1) {
+        addEvent(m_pszName, m_sArg, m_nBegin, g_timer.nsecsElapsed());
+    }
+}
+
+void UnpackTracer::start()
+{
+    g_timer.start();
+    g_nIsStarted.storeRelease(1);
+}
+
+bool UnpackTracer::isStarted()
+{
+    return g_nIsStarted.loadAcquire();
+}
+
+bool UnpackTracer::writeChromeTrace(const QString &sFileName, QString *pErrorString)
+{
+    QFile file(sFileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (pErrorString) {
+            *pErrorString = QObject::tr("Cannot create file: %1").arg(sFileName);
+        }
+
+        return false;
+    }
+
+    // One event per line, so a trace of millions of zones is never held as one document
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    bool bIsFirst = true;
+
+    QMutexLocker lockerThreads(&g_mutexThreads);
+
+    qint32 nNumberOfThreads = g_listThreads.count();
+
+    for (qint32 i = 0; i < nNumberOfThreads; i++) {
+        THREAD *pThread = g_listThreads.at(i);
+        QMutexLocker locker(&pThread->mutex);
+
+        QJsonObject jsArgs;
+        jsArgs.insert(QStringLiteral("name"), pThread->sName);
+
+        QJsonObject jsName;
+        jsName.insert(QStringLiteral("name"), QStringLiteral("thread_name"));
+        jsName.insert(QStringLiteral("ph"), QStringLiteral("M"));
+        jsName.insert(QStringLiteral("pid"), 1);
+        jsName.insert(QStringLiteral("tid"), pThread->nId);
+        jsName.insert(QStringLiteral("args"), jsArgs);
+
+        file.write(bIsFirst ? "" : ",\n");
+        file.write(QJsonDocument(jsName).toJson(QJsonDocument::Compact));
+        bIsFirst = false;
+
+        qint32 nNumberOfEvents = pThread->listEvents.count();
+
+        for (qint32 j = 0; j < nNumberOfEvents; j++) {
+            const EVENT &event = pThread->listEvents.at(j);
+
+            QJsonObject jsEvent;
+            jsEvent.insert(QStringLiteral("name"), QString::fromLatin1(event.pszName));
+            jsEvent.insert(QStringLiteral("cat"), QStringLiteral("xfu"));
+            jsEvent.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            jsEvent.insert(QStringLiteral("ts"), (double)event.nBegin / 1000.0);
+            jsEvent.insert(QStringLiteral("dur"), (double)event.nDuration / 1000.0);
+            jsEvent.insert(QStringLiteral("pid"), 1);
+            jsEvent.insert(QStringLiteral("tid"), pThread->nId);
+
+            if (!event.sArg.isEmpty()) {
+                QJsonObject jsEventArgs;
+                jsEventArgs.insert(QStringLiteral("detail"), event.sArg);
+                jsEvent.insert(QStringLiteral("args"), jsEventArgs);
+            }
+
+            file.write(",\n");
+            file.write(QJsonDocument(jsEvent).toJson(QJsonDocument::Compact));
+        }
+
+        if (pThread->nNumberOfDropped) {
+            QJsonObject jsDroppedArgs;
+            jsDroppedArgs.insert(QStringLiteral("dropped"), (double)pThread->nNumberOfDropped);
+
+            QJsonObject jsDropped;
+            jsDropped.insert(QStringLiteral("name"), QStringLiteral("dropped"));
+            jsDropped.insert(QStringLiteral("ph"), QStringLiteral("i"));
+            jsDropped.insert(QStringLiteral("s"), QStringLiteral("t"));
+            jsDropped.insert(QStringLiteral("ts"), (double)g_timer.nsecsElapsed() / 1000.0);
+            jsDropped.insert(QStringLiteral("pid"), 1);
+            jsDropped.insert(QStringLiteral("tid"), pThread->nId);
+            jsDropped.insert(QStringLiteral("args"), jsDroppedArgs);
+
+            file.write(",\n");
+            file.write(QJsonDocument(jsDropped).toJson(QJsonDocument::Compact));
+        }
+    }
+
+    file.write("\n]}\n");
+
+    return true;
+}
+
+void UnpackTracer::addEvent(const char *pszName, const QString &sArg, qint64 nBegin, qint64 nEnd)
+{
+    THREAD *pThread = getThread();
+    QMutexLocker locker(&pThread->mutex);
+
+    if (pThread->listEvents.count() < N_MAX_EVENTS) {
+        EVENT event = {pszName, sArg, nBegin, nEnd - nBegin};
+        pThread->listEvents.append(event);
+    } else {
+        pThread->nNumberOfDropped++;
+    }
+}
@@ -0,0 +1,61 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef UNPACKTRACER_H
+#define UNPACKTRACER_H
+
+#include <QString>
+
+// Timeline of the pipeline across threads, exported as Chrome trace JSON for chrome://tracing
+// and ui.perfetto.dev. Zones are placed with XFU_TRACE_ZONE; without USE_TRACE they compile
+// to nothing. With it, a zone costs one atomic load until start() and two clock reads after.
+class UnpackTracer {
+public:
+    class Zone {
+    public:
+        explicit Zone(const char *pszName, const QString &sArg = QString());
+        ~Zone();
+
+    private:
+        const char *m_pszName;
+        QString m_sArg;
+        qint64 m_nBegin;  // ns; -1: not recording
+    };
+
+    static void start();
+    static bool isStarted();
+    // Zones still open are not in the file
+    static bool writeChromeTrace(const QString &sFileName, QString *pErrorString);
+
+private:
+    static void addEvent(const char *pszName, const QString &sArg, qint64 nBegin, qint64 nEnd);
+};
+
+#ifdef USE_TRACE
+#define XFU_TRACE_CONCAT_(a, b) a##b
+#define XFU_TRACE_CONCAT(a, b) XFU_TRACE_CONCAT_(a, b)
+#define XFU_TRACE_ZONE(pszName) UnpackTracer::Zone XFU_TRACE_CONCAT(_traceZone, __LINE__)(pszName)
+#define XFU_TRACE_ZONE_ARG(pszName, sArg) UnpackTracer::Zone XFU_TRACE_CONCAT(_traceZone, __LINE__)(pszName, sArg)
+#else
+#define XFU_TRACE_ZONE(pszName)
+#define XFU_TRACE_ZONE_ARG(pszName, sArg)
+#endif
+
+#endif  // UNPACKTRACER_H
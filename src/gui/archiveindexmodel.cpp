@@ -0,0 +1,260 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "archiveindexmodel.h"
+
+ArchiveIndexModel::ArchiveIndexModel(QObject *pParent)
+    : QAbstractTableModel(pParent), m_pdStruct(XBinary::createPdStruct()), m_nGeneration(0), m_nNumberOfRows(0), m_bIsLoading(false)
+{
+}
+
+ArchiveIndexModel::~ArchiveIndexModel()
+{
+    stop();
+}
+
+void ArchiveIndexModel::setFileName(const QString &sFileName)
+{
+    clear();
+
+    m_sFileName = sFileName;
+    m_bIsLoading = true;
+    m_pdStruct = XBinary::createPdStruct();
+
+    quint32 nGeneration = m_nGeneration;
+
+    m_future = QtConcurrent::run([this, sFileName, nGeneration]() { loadRecords(sFileName, nGeneration); });
+}
+
+void ArchiveIndexModel::clear()
+{
+    stop();
+
+    beginResetModel();
+
+    m_nGeneration++;
+    m_sFileName.clear();
+    m_listRecords.clear();
+    m_nNumberOfRows = 0;
+    m_bIsLoading = false;
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_listPending.clear();
+    }
+
+    endResetModel();
+}
+
+bool ArchiveIndexModel::isLoading() const
+{
+    return m_bIsLoading;
+}
+
+QString ArchiveIndexModel::getFileName() const
+{
+    return m_sFileName;
+}
+
+XArchive::RECORD ArchiveIndexModel::getRecord(const QModelIndex &index) const
+{
+    XArchive::RECORD result = {};
+
+    if (index.isValid() && (index.row() < m_nNumberOfRows)) {
+        result = m_listRecords.at(index.row());
+    }
+
+    return result;
+}
+
+bool ArchiveIndexModel::extractRecord(const QString &sFileName, const XArchive::RECORD &record, const QString &sResultFileName, XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = false;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        XArchive::RECORD _record = record;
+        bResult = XArchives::decompressToFile(&file, &_record, sResultFileName, pPdStruct);
+
+        file.close();
+    }
+
+    return bResult;
+}
+
+int ArchiveIndexModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_nNumberOfRows;
+}
+
+int ArchiveIndexModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : __COLUMN_SIZE;
+}
+
+QVariant ArchiveIndexModel::data(const QModelIndex &index, int nRole) const
+{
+    QVariant result;
+
+    if (index.isValid() && (index.row() < m_nNumberOfRows)) {
+        const XArchive::RECORD &record = m_listRecords.at(index.row());
+
+        if (nRole == Qt::DisplayRole) {
+            qint32 nColumn = index.column();
+
+            if (nColumn == COLUMN_NAME) {
+                result = record.spInfo.sRecordName;
+            } else if (nColumn == COLUMN_SIZE) {
+                result = record.spInfo.nUncompressedSize;
+            } else if (nColumn == COLUMN_COMPRESSEDSIZE) {
+                result = record.nDataSize;
+            } else if (nColumn == COLUMN_METHOD) {
+                result = XArchive::compressMethodToString(record.spInfo.compressMethod);
+            }
+        } else if (nRole == Qt::TextAlignmentRole) {
+            if ((index.column() == COLUMN_SIZE) || (index.column() == COLUMN_COMPRESSEDSIZE)) {
+                result = (qint32)(Qt::AlignRight | Qt::AlignVCenter);
+            }
+        }
+    }
+
+    return result;
+}
+
+QVariant ArchiveIndexModel::headerData(int nSection, Qt::Orientation orientation, int nRole) const
+{
+    QVariant result;
+
+    if ((orientation == Qt::Horizontal) && (nRole == Qt::DisplayRole)) {
+        if (nSection == COLUMN_NAME) {
+            result = tr("Name");
+        } else if (nSection == COLUMN_SIZE) {
+            result = tr("Size");
+        } else if (nSection == COLUMN_COMPRESSEDSIZE) {
+            result = tr("Compressed");
+        } else if (nSection == COLUMN_METHOD) {
+            result = tr("Method");
+        }
+    }
+
+    return result;
+}
+
+bool ArchiveIndexModel::canFetchMore(const QModelIndex &parent) const
+{
+    return (!parent.isValid()) && (m_nNumberOfRows < m_listRecords.count());
+}
+
+void ArchiveIndexModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    qint32 nNumberOfNewRows = qMin(N_FETCH_SIZE, (qint32)m_listRecords.count() - m_nNumberOfRows);
+
+    if (nNumberOfNewRows > 0) {
+        beginInsertRows(QModelIndex(), m_nNumberOfRows, m_nNumberOfRows + nNumberOfNewRows - 1);
+        m_nNumberOfRows += nNumberOfNewRows;
+        endInsertRows();
+    }
+}
+
+void ArchiveIndexModel::onRecordsAvailable(quint32 nGeneration)
+{
+    if (nGeneration != m_nGeneration) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_listRecords.append(m_listPending);
+        m_listPending.clear();
+    }
+
+    // Views only ask for more when scrolled to the end; the first page is pushed
+    if (m_nNumberOfRows < N_FETCH_SIZE) {
+        fetchMore(QModelIndex());
+    }
+}
+
+void ArchiveIndexModel::onLoadingFinished(quint32 nGeneration)
+{
+    if (nGeneration != m_nGeneration) {
+        return;
+    }
+
+    onRecordsAvailable(nGeneration);
+
+    m_bIsLoading = false;
+
+    emit loadingFinished(m_listRecords.count());
+}
+
+void ArchiveIndexModel::stop()
+{
+    if (m_future.isRunning()) {
+        m_pdStruct.bIsStop = true;
+        m_future.waitForFinished();
+    }
+}
+
+void ArchiveIndexModel::loadRecords(const QString &sFileName, quint32 nGeneration)
+{
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QSet<XBinary::FT> stFileTypes = XFormats::getFileTypes(&file, true, &m_pdStruct);
+        XBinary::FT fileType = XBinary::_getPrefFileType(&stFileTypes);
+
+        if (XArchives::getArchiveOpenValidFileTypes().contains(fileType)) {
+            qint32 nLimit = N_FIRST_CHUNK;
+            qint32 nNumberOfLoaded = 0;
+
+            while (XBinary::isPdStructNotCanceled(&m_pdStruct)) {
+                // getRecords always starts at the first record; the limit grows 4x so the rereads stay small
+                QList<XArchive::RECORD> listRecords = XArchives::getRecords(&file, fileType, nLimit, &m_pdStruct);
+                qint32 nNumberOfRecords = listRecords.count();
+
+                if (nNumberOfRecords > nNumberOfLoaded) {
+                    {
+                        QMutexLocker locker(&m_mutexPending);
+                        m_listPending.append(listRecords.mid(nNumberOfLoaded));
+                    }
+
+                    nNumberOfLoaded = nNumberOfRecords;
+
+                    QMetaObject::invokeMethod(this, "onRecordsAvailable", Qt::QueuedConnection, Q_ARG(quint32, nGeneration));
+                }
+
+                if (nNumberOfRecords < nLimit) {
+                    break;
+                }
+
+                nLimit = (nLimit > (INT_MAX / 4)) ? INT_MAX : (nLimit * 4);
+            }
+        }
+
+        file.close();
+    }
+
+    QMetaObject::invokeMethod(this, "onLoadingFinished", Qt::QueuedConnection, Q_ARG(quint32, nGeneration));
+}
@@ -0,0 +1,92 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef ARCHIVEINDEXMODEL_H
+#define ARCHIVEINDEXMODEL_H
+
+#include <QAbstractTableModel>
+#include <QFile>
+#include <QFuture>
+#include <QMutex>
+#include <QtConcurrent>
+
+#include "xarchives.h"
+#include "xformats.h"
+
+// Entry list of an archive, filled from a background thread. The directory is read in
+// growing chunks (1k, 4k, 16k... records), so the first rows show up at once and the
+// whole pass costs about a third more than a single read. Views get rows via fetchMore.
+// Nothing is decompressed here; see extractRecord.
+class ArchiveIndexModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum COLUMN {
+        COLUMN_NAME = 0,
+        COLUMN_SIZE,
+        COLUMN_COMPRESSEDSIZE,
+        COLUMN_METHOD,
+        __COLUMN_SIZE
+    };
+
+    explicit ArchiveIndexModel(QObject *pParent = nullptr);
+    ~ArchiveIndexModel() override;
+
+    void setFileName(const QString &sFileName);
+    void clear();
+    bool isLoading() const;
+    QString getFileName() const;
+    XArchive::RECORD getRecord(const QModelIndex &index) const;
+    // Decompresses one record; safe to call from any thread
+    static bool extractRecord(const QString &sFileName, const XArchive::RECORD &record, const QString &sResultFileName, XBinary::PDSTRUCT *pPdStruct);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
+    QVariant headerData(int nSection, Qt::Orientation orientation, int nRole = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void loadingFinished(qint32 nNumberOfRecords);
+
+private slots:
+    void onRecordsAvailable(quint32 nGeneration);
+    void onLoadingFinished(quint32 nGeneration);
+
+private:
+    void stop();
+    void loadRecords(const QString &sFileName, quint32 nGeneration);
+
+    static const qint32 N_FIRST_CHUNK = 1000;
+    static const qint32 N_FETCH_SIZE = 1000;
+
+    QString m_sFileName;
+    QFuture<void> m_future;
+    XBinary::PDSTRUCT m_pdStruct;
+    QMutex m_mutexPending;
+    QList<XArchive::RECORD> m_listPending;
+    QList<XArchive::RECORD> m_listRecords;
+    quint32 m_nGeneration;   // Late notifications of a previous file are dropped
+    qint32 m_nNumberOfRows;  // Rows handed to views so far
+    bool m_bIsLoading;
+};
+
+#endif  // ARCHIVEINDEXMODEL_H
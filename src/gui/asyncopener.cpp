@@ -0,0 +1,127 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "asyncopener.h"
+
+AsyncOpener::AsyncOpener(QObject *pParent) : QObject(pParent)
+{
+    m_timer.setInterval(200);
+
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(onFinished()));
+    connect(&m_timer, SIGNAL(timeout()), this, SLOT(onTimer()));
+}
+
+AsyncOpener::~AsyncOpener()
+{
+    cancel();
+}
+
+void AsyncOpener::open(const QString &sPath)
+{
+    cancel();
+
+    QSharedPointer<TASK> pTask(new TASK);
+    pTask->pdStruct = XBinary::createPdStruct();
+    pTask->nProgress.storeRelease(0);
+
+    m_pTask = pTask;
+    m_sPath = sPath;
+
+    // The task keeps its own reference: a canceled one may outlive the next open()
+    m_watcher.setFuture(QtConcurrent::run([sPath, pTask]() { return process(sPath, pTask.data()); }));
+    m_timer.start();
+}
+
+void AsyncOpener::cancel()
+{
+    if (m_pTask) {
+        m_pTask->pdStruct.bIsStop = true;
+    }
+}
+
+bool AsyncOpener::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void AsyncOpener::onFinished()
+{
+    m_timer.stop();
+
+    RESULT result = m_watcher.result();
+
+    m_pTask.reset();
+
+    if (result.bIsValid && (!result.bIsCanceled)) {
+        if (result.bIsDirectory) {
+            emit directoryReady(result.sPath, result.nNumberOfEntries);
+        } else {
+            emit fileReady(result.sPath, result.sFileType, result.bIsContainer);
+        }
+    }
+
+    emit finished(result.sPath, result.bIsValid, result.bIsCanceled);
+}
+
+void AsyncOpener::onTimer()
+{
+    if (m_pTask) {
+        emit progress(m_sPath, m_pTask->nProgress.loadAcquire());
+    }
+}
+
+AsyncOpener::RESULT AsyncOpener::process(const QString &sPath, TASK *pTask)
+{
+    RESULT result = {};
+
+    QFileInfo fi(sPath);
+
+    result.sPath = fi.absoluteFilePath();
+
+    if (fi.isDir()) {
+        result.bIsDirectory = true;
+        result.bIsValid = true;
+
+        // Warms the directory listing the explorer reads next
+        QDirIterator it(result.sPath, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+
+        while (it.hasNext() && XBinary::isPdStructNotCanceled(&(pTask->pdStruct))) {
+            it.next();
+            result.nNumberOfEntries++;
+            pTask->nProgress.storeRelease(result.nNumberOfEntries);
+        }
+    } else if (fi.isFile()) {
+        QFile file(result.sPath);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            QSet<XBinary::FT> stFileTypes = XFormats::getFileTypes(&file, true, &(pTask->pdStruct));
+            XBinary::FT fileType = XBinary::_getPrefFileType(&stFileTypes);
+            result.sFileType = XBinary::fileTypeIdToString(fileType);
+            result.bIsContainer = XArchives::getArchiveOpenValidFileTypes().contains(fileType);
+            result.bIsValid = true;
+
+            file.close();
+        }
+    }
+
+    result.bIsCanceled = !XBinary::isPdStructNotCanceled(&(pTask->pdStruct));
+
+    return result;
+}
@@ -0,0 +1,81 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef ASYNCOPENER_H
+#define ASYNCOPENER_H
+
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include "xarchives.h"
+#include "xformats.h"
+
+// Resolves, detects and enumerates a path off the GUI thread. A newer open() cancels the
+// one in flight; a task stuck in the filesystem is left to finish and its result dropped.
+class AsyncOpener : public QObject {
+    Q_OBJECT
+
+public:
+    struct RESULT {
+        QString sPath;
+        bool bIsValid;
+        bool bIsDirectory;
+        bool bIsCanceled;
+        QString sFileType;
+        bool bIsContainer;        // Has records to list
+        qint32 nNumberOfEntries;  // Directory entries
+    };
+
+    explicit AsyncOpener(QObject *pParent = nullptr);
+    ~AsyncOpener() override;
+
+    void open(const QString &sPath);
+    void cancel();
+    bool isRunning() const;
+
+signals:
+    void fileReady(const QString &sFileName, const QString &sFileType, bool bIsContainer);
+    void directoryReady(const QString &sDirectoryName, qint32 nNumberOfEntries);
+    void finished(const QString &sPath, bool bIsValid, bool bIsCanceled);
+    void progress(const QString &sPath, qint32 nValue);
+
+private slots:
+    void onFinished();
+    void onTimer();
+
+private:
+    struct TASK {
+        XBinary::PDSTRUCT pdStruct;
+        QAtomicInt nProgress;
+    };
+
+    static RESULT process(const QString &sPath, TASK *pTask);
+
+    QFutureWatcher<RESULT> m_watcher;
+    QSharedPointer<TASK> m_pTask;
+    QString m_sPath;
+    QTimer m_timer;
+};
+
+#endif  // ASYNCOPENER_H
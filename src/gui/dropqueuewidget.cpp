@@ -0,0 +1,362 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "dropqueuewidget.h"
+
+#include "ui_dropqueuewidget.h"
+
+#include <QHeaderView>
+#include <QStandardPaths>
+
+DropQueueWidget::DropQueueWidget(QWidget *pParent)
+    : QWidget(pParent),
+      ui(new Ui::DropQueueWidget),
+      m_scanEnginePool(BatchScheduler::getDefaultNumberOfWorkers()),
+      m_pdStruct(XBinary::createPdStruct()),
+      m_nNumberOfFinished(0),
+      m_bIsIndexLoaded(false)
+{
+    ui->setupUi(this);
+
+    m_pModel = new QStandardItemModel(0, __COLUMN_SIZE, this);
+    m_pModel->setHorizontalHeaderLabels(QStringList() << tr("File") << tr("Status") << tr("Type") << tr("Result"));
+
+    ui->treeViewQueue->setModel(m_pModel);
+
+    m_pResultModel = new ResultIndexModel(this);
+
+    // No sort until a header is clicked; the model sorts on its own thread
+    ui->treeViewEntries->setModel(m_pResultModel);
+    ui->treeViewEntries->header()->setSortIndicator(-1, Qt::AscendingOrder);
+    ui->treeViewEntries->setSortingEnabled(true);
+
+    m_timerRefresh.setInterval(N_REFRESH_INTERVAL);
+    ui->spinBoxWorkers->setValue(BatchScheduler::getDefaultNumberOfWorkers());
+    ui->pushButtonStop->setEnabled(false);
+
+    // Shared by every directory opened incrementally; files are keyed by absolute path
+    m_fileStateIndex.setFileName(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/fileindex.json"));
+
+    connect(this, SIGNAL(filesQueued(QStringList)), this, SLOT(onFilesQueued(QStringList)));
+    connect(&m_directoryWatcher, SIGNAL(changed()), this, SLOT(onDirectoryChanged()));
+    connect(this, SIGNAL(fileStarted(QString)), this, SLOT(onFileStarted(QString)));
+    connect(this, SIGNAL(fileFinished(QString, QString, QString, QString)), this, SLOT(onFileFinished(QString, QString, QString, QString)));
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(onRunFinished()));
+    connect(&m_timerRefresh, SIGNAL(timeout()), m_pResultModel, SLOT(refresh()));
+    connect(m_pResultModel, SIGNAL(busyChanged(bool)), this, SLOT(onEntriesBusyChanged(bool)));
+}
+
+DropQueueWidget::~DropQueueWidget()
+{
+    m_pdStruct.bIsStop = true;
+    m_watcher.waitForFinished();
+
+    delete ui;
+}
+
+void DropQueueWidget::addPaths(const QStringList &listPaths)
+{
+    // Directories are expanded here; this only walks names, nothing is read
+    QList<BatchScheduler::ITEM> listItems = BatchScheduler::collectItems(listPaths, true);
+
+    qint32 nNumberOfItems = listItems.count();
+
+    for (qint32 i = 0; i < nNumberOfItems; i++) {
+        appendRow(listItems.at(i).sFileName);
+        m_listPending.append(listItems.at(i));
+    }
+
+    if (!isRunning()) {
+        startRun();
+    }
+
+    updateStatus();
+}
+
+void DropQueueWidget::addChangedFiles(const QString &sDirectory)
+{
+    // Walking and hashing happen on the worker; rows show up once the changed files are known
+    if (!m_listPendingDirectories.contains(sDirectory)) {
+        m_listPendingDirectories.append(sDirectory);
+    }
+
+    if (!m_listWatchedDirectories.contains(sDirectory)) {
+        m_listWatchedDirectories.append(sDirectory);
+        m_directoryWatcher.setPaths(m_listWatchedDirectories, true);
+    }
+
+    if (!isRunning()) {
+        startRun();
+    }
+}
+
+bool DropQueueWidget::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void DropQueueWidget::onFilesQueued(const QStringList &listFileNames)
+{
+    qint32 nNumberOfFiles = listFileNames.count();
+
+    for (qint32 i = 0; i < nNumberOfFiles; i++) {
+        appendRow(listFileNames.at(i));
+    }
+
+    updateStatus();
+}
+
+void DropQueueWidget::onDirectoryChanged()
+{
+    qint32 nNumberOfDirectories = m_listWatchedDirectories.count();
+
+    for (qint32 i = 0; i < nNumberOfDirectories; i++) {
+        addChangedFiles(m_listWatchedDirectories.at(i));
+    }
+}
+
+void DropQueueWidget::onFileStarted(const QString &sFileName)
+{
+    qint32 nRow = m_mapRows.value(sFileName, -1);
+
+    if (nRow != -1) {
+        m_pModel->item(nRow, COLUMN_STATUS)->setText(tr("Processing"));
+    }
+}
+
+void DropQueueWidget::onFileFinished(const QString &sFileName, const QString &sStatus, const QString &sFileType, const QString &sResult)
+{
+    qint32 nRow = m_mapRows.value(sFileName, -1);
+
+    if (nRow != -1) {
+        m_pModel->item(nRow, COLUMN_STATUS)->setText(sStatus);
+        m_pModel->item(nRow, COLUMN_TYPE)->setText(sFileType);
+        m_pModel->item(nRow, COLUMN_RESULT)->setText(sResult);
+    }
+
+    m_nNumberOfFinished++;
+
+    updateStatus();
+}
+
+void DropQueueWidget::onRunFinished()
+{
+    if (XBinary::isPdStructNotCanceled(&m_pdStruct) && ((!m_listPending.isEmpty()) || (!m_listPendingDirectories.isEmpty()))) {
+        startRun();
+    } else {
+        m_listPending.clear();
+        m_listPendingDirectories.clear();
+
+        qint32 nNumberOfRows = m_pModel->rowCount();
+
+        for (qint32 i = 0; i < nNumberOfRows; i++) {
+            QStandardItem *pItem = m_pModel->item(i, COLUMN_STATUS);
+
+            if ((pItem->text() == tr("Queued")) || (pItem->text() == tr("Processing"))) {
+                pItem->setText(tr("Canceled"));
+            }
+        }
+
+        m_timerRefresh.stop();
+        m_pResultModel->refresh();
+
+        ui->pushButtonStop->setEnabled(false);
+        ui->spinBoxWorkers->setEnabled(true);
+        ui->checkBoxTriage->setEnabled(true);
+    }
+
+    updateStatus();
+}
+
+void DropQueueWidget::on_pushButtonStop_clicked()
+{
+    m_pdStruct.bIsStop = true;
+}
+
+void DropQueueWidget::on_pushButtonClear_clicked()
+{
+    if (!isRunning()) {
+        m_pModel->removeRows(0, m_pModel->rowCount());
+        m_mapRows.clear();
+        m_nNumberOfFinished = 0;
+
+        m_pResultModel->clear();
+        m_pResultWriter.reset();
+
+        updateStatus();
+    }
+}
+
+void DropQueueWidget::on_lineEditEntryFilter_textChanged(const QString &sText)
+{
+    m_pResultModel->setFilter(sText);
+}
+
+void DropQueueWidget::onEntriesBusyChanged(bool bIsBusy)
+{
+    if (bIsBusy) {
+        ui->tabWidget->setTabText(ui->tabWidget->indexOf(ui->tabEntries), tr("Entries") + QStringLiteral("..."));
+    } else {
+        ui->tabWidget->setTabText(ui->tabWidget->indexOf(ui->tabEntries), tr("Entries") + QStringLiteral(" (%1)").arg(m_pResultModel->rowCount()));
+    }
+}
+
+void DropQueueWidget::appendRow(const QString &sFileName)
+{
+    QList<QStandardItem *> listRow;
+    listRow.append(new QStandardItem(sFileName));
+    listRow.append(new QStandardItem(tr("Queued")));
+    listRow.append(new QStandardItem());
+    listRow.append(new QStandardItem());
+
+    m_mapRows.insert(sFileName, m_pModel->rowCount());
+    m_pModel->appendRow(listRow);
+}
+
+void DropQueueWidget::startRun()
+{
+    if (m_listPending.isEmpty() && m_listPendingDirectories.isEmpty()) {
+        return;
+    }
+
+    QList<BatchScheduler::ITEM> listItems = m_listPending;
+    QStringList listDirectories = m_listPendingDirectories;
+    m_listPending.clear();
+    m_listPendingDirectories.clear();
+
+    qint32 nNumberOfWorkers = ui->spinBoxWorkers->value();
+    bool bTriage = ui->checkBoxTriage->isChecked();
+
+    m_pdStruct = XBinary::createPdStruct();
+
+    if ((!m_pResultWriter) && m_tempDir.isValid()) {
+        QString sRecordsFileName = m_tempDir.filePath(QStringLiteral("entries.jsonl"));
+
+        m_pResultWriter.reset(ResultWriter::create(ResultWriter::FORMAT_JSONL, sRecordsFileName, nullptr));
+
+        if (m_pResultWriter) {
+            m_pResultModel->setFileName(sRecordsFileName);
+        }
+    }
+
+    m_timerRefresh.start();
+
+    ui->pushButtonStop->setEnabled(true);
+    ui->spinBoxWorkers->setEnabled(false);
+    ui->checkBoxTriage->setEnabled(false);
+
+    m_watcher.setFuture(QtConcurrent::run(
+        [this, listItems, listDirectories, nNumberOfWorkers, bTriage]() { processItems(listItems, listDirectories, nNumberOfWorkers, bTriage); }));
+}
+
+void DropQueueWidget::updateStatus()
+{
+    ui->labelStatus->setText(tr("%1 of %2 done").arg(QString::number(m_nNumberOfFinished), QString::number(m_pModel->rowCount())));
+}
+
+void DropQueueWidget::processItems(QList<BatchScheduler::ITEM> listItems, const QStringList &listDirectories, qint32 nNumberOfWorkers, bool bTriage)
+{
+    // Runs on the thread pool; rows are updated through queued signals
+    UnpackEngine::OPTIONS options = UnpackEngine::getDefaultOptions();
+    options.bTriage = bTriage;
+    options.pResultWriter = m_pResultWriter.data();
+    options.pScanEnginePool = &m_scanEnginePool;
+
+    // Loaded here, not at startup: the index grows with every file ever unpacked
+    if (!m_bIsIndexLoaded) {
+        m_fileStateIndex.load();
+        m_bIsIndexLoaded = true;
+    }
+
+    QSet<QString> setIncremental;
+
+    if (!listDirectories.isEmpty()) {
+        QList<BatchScheduler::ITEM> listChanged =
+            m_fileStateIndex.getChangedItems(BatchScheduler::collectItems(listDirectories, true, &m_pdStruct), &m_pdStruct);
+
+        QStringList listFileNames;
+
+        qint32 nNumberOfChanged = listChanged.count();
+
+        for (qint32 i = 0; i < nNumberOfChanged; i++) {
+            listFileNames.append(listChanged.at(i).sFileName);
+            setIncremental.insert(listChanged.at(i).sFileName);
+        }
+
+        emit filesQueued(listFileNames);
+
+        listItems.append(listChanged);
+    }
+
+    QVector<UnpackEngine *> listEngines;
+
+    for (qint32 i = 0; i < nNumberOfWorkers; i++) {
+        listEngines.append(new UnpackEngine);
+    }
+
+    BatchScheduler scheduler;
+    scheduler.setItems(listItems);
+    scheduler.process(
+        nNumberOfWorkers,
+        [&](qint32 nWorker, const BatchScheduler::ITEM &item) {
+            emit fileStarted(item.sFileName);
+
+            UnpackEngine::RESULT result = listEngines.at(nWorker)->processFile(item.sFileName, QString(), options, &m_pdStruct);
+
+            if (options.pResultWriter) {
+                options.pResultWriter->writeResult(result);
+            }
+
+            if ((result.status == UnpackEngine::STATUS_OK) && setIncremental.contains(item.sFileName)) {
+                m_fileStateIndex.setProcessed(item);
+            }
+
+            emit fileFinished(item.sFileName, UnpackEngine::statusToString(result.status), result.sFileType, getResultString(result));
+        },
+        &m_pdStruct);
+
+    qDeleteAll(listEngines);
+
+    // Also keeps the refreshed mtimes of files whose content did not change
+    if (!listDirectories.isEmpty()) {
+        m_fileStateIndex.save();
+    }
+}
+
+QString DropQueueWidget::getResultString(const UnpackEngine::RESULT &result)
+{
+    QStringList listParts;
+
+    QString sScanResult = ResultIndexModel::scanResultToString(result.scanResult);
+
+    if (!sScanResult.isEmpty()) {
+        listParts.append(sScanResult);
+    }
+
+    if (result.nNumberOfEntries > 0) {
+        listParts.append(tr("%1 entries").arg(result.nNumberOfEntries));
+    }
+
+    if (!result.sErrorString.isEmpty()) {
+        listParts.append(result.sErrorString);
+    }
+
+    return listParts.join(QStringLiteral("; "));
+}
@@ -0,0 +1,112 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef DROPQUEUEWIDGET_H
+#define DROPQUEUEWIDGET_H
+
+#include <QFutureWatcher>
+#include <QStandardItemModel>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QWidget>
+#include <QtConcurrent>
+
+#include "batchscheduler.h"
+#include "directorywatcher.h"
+#include "filestateindex.h"
+#include "resultindexmodel.h"
+#include "resultwriter.h"
+#include "scanenginepool.h"
+#include "unpackengine.h"
+
+namespace Ui {
+class DropQueueWidget;
+}
+
+// Files dropped on the window, processed by a pool of UnpackEngine workers. Rows are
+// updated as each file starts and finishes; files added during a run form the next one.
+// The scan engines outlive the runs, so the signatures are loaded once per window.
+// Directories added with addChangedFiles() only contribute files the persistent index has
+// not seen in this state, and are watched for further changes. Entries go to a records
+// file in a temporary directory and are listed from there by a ResultIndexModel.
+class DropQueueWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    enum COLUMN {
+        COLUMN_FILE = 0,
+        COLUMN_STATUS,
+        COLUMN_TYPE,
+        COLUMN_RESULT,
+        __COLUMN_SIZE
+    };
+
+    explicit DropQueueWidget(QWidget *pParent = nullptr);
+    ~DropQueueWidget() override;
+
+    void addPaths(const QStringList &listPaths);
+    void addChangedFiles(const QString &sDirectory);
+    bool isRunning() const;
+
+signals:
+    void filesQueued(const QStringList &listFileNames);
+    void fileStarted(const QString &sFileName);
+    void fileFinished(const QString &sFileName, const QString &sStatus, const QString &sFileType, const QString &sResult);
+
+private slots:
+    void onFilesQueued(const QStringList &listFileNames);
+    void onDirectoryChanged();
+    void onFileStarted(const QString &sFileName);
+    void onFileFinished(const QString &sFileName, const QString &sStatus, const QString &sFileType, const QString &sResult);
+    void onRunFinished();
+    void on_pushButtonStop_clicked();
+    void on_pushButtonClear_clicked();
+    void on_lineEditEntryFilter_textChanged(const QString &sText);
+    void onEntriesBusyChanged(bool bIsBusy);
+
+private:
+    void appendRow(const QString &sFileName);
+    void startRun();
+    void updateStatus();
+    void processItems(QList<BatchScheduler::ITEM> listItems, const QStringList &listDirectories, qint32 nNumberOfWorkers, bool bTriage);
+    static QString getResultString(const UnpackEngine::RESULT &result);
+
+    static const qint32 N_REFRESH_INTERVAL = 1000;  // ms, entries view while a run goes on
+
+    Ui::DropQueueWidget *ui;
+    QStandardItemModel *m_pModel;
+    ResultIndexModel *m_pResultModel;
+    QTemporaryDir m_tempDir;
+    QScopedPointer<ResultWriter> m_pResultWriter;  // Created by the first run, kept until cleared
+    QTimer m_timerRefresh;
+    QHash<QString, qint32> m_mapRows;  // File name -> latest row
+    QList<BatchScheduler::ITEM> m_listPending;
+    QStringList m_listPendingDirectories;
+    QStringList m_listWatchedDirectories;
+    FileStateIndex m_fileStateIndex;
+    ScanEnginePool m_scanEnginePool;  // Shared by the workers of every run
+    DirectoryWatcher m_directoryWatcher;
+    QFutureWatcher<void> m_watcher;
+    XBinary::PDSTRUCT m_pdStruct;
+    qint32 m_nNumberOfFinished;
+    bool m_bIsIndexLoaded;  // By the first run, on its worker
+};
+
+#endif  // DROPQUEUEWIDGET_H
@@ -21,11 +21,17 @@
 #include "guimainwindow.h"
 
 #include "dialogoptions.h"
+#include "dropqueuewidget.h"
+#include "entryfilter.h"
 #include "ui_guimainwindow.h"
+#include "unpackengine.h"
 
 #include <QFileInfo>
+#include <QTimer>
 
-GuiMainWindow::GuiMainWindow(QWidget *pParent) : QMainWindow(pParent), ui(new Ui::GuiMainWindow), g_pRecentFilesMenu(nullptr)
+GuiMainWindow::GuiMainWindow(QWidget *pParent)
+    : QMainWindow(pParent), ui(new Ui::GuiMainWindow), g_pRecentFilesMenu(nullptr), g_pArchiveIndexModel(nullptr), g_pAsyncOpener(nullptr),
+      g_pProgressBarOpen(nullptr), g_pToolButtonCancelOpen(nullptr), g_pDropQueueWidget(nullptr)
 {
     ui->setupUi(this);
 
@@ -55,67 +61,153 @@ GuiMainWindow::GuiMainWindow(QWidget *pParent) : QMainWindow(pParent), ui(new Ui
     connect(ui->centralwidget, SIGNAL(fileActivated(QString)), this, SLOT(openFile(QString)));
     connect(ui->centralwidget, SIGNAL(directoryActivated(QString)), this, SLOT(onDirectoryActivated(QString)));
 
-    g_pRecentFilesMenu = g_xOptions.createRecentFilesMenu(this);
-    ui->menuFile->insertMenu(ui->actionExit, g_pRecentFilesMenu);
-    ui->menuFile->insertSeparator(ui->actionExit);
-    updateRecentFilesMenu();
+    g_pArchiveIndexModel = new ArchiveIndexModel(this);
+    ui->tableViewArchive->setModel(g_pArchiveIndexModel);
+    ui->dockWidgetArchive->hide();
+    ui->dockWidgetQueue->hide();
 
-    QString sLastDirectory = g_xOptions.getLastDirectory();
-    if (!sLastDirectory.isEmpty()) {
-        ui->centralwidget->setRootPath(sLastDirectory);
-    }
+    connect(g_pArchiveIndexModel, SIGNAL(loadingFinished(qint32)), this, SLOT(onArchiveLoadingFinished(qint32)));
+    connect(ui->tableViewArchive, SIGNAL(activated(QModelIndex)), this, SLOT(onArchiveRecordActivated(QModelIndex)));
+    connect(&g_watcherExtract, SIGNAL(finished()), this, SLOT(onArchiveExtractFinished()));
+
+    g_pAsyncOpener = new AsyncOpener(this);
+
+    g_pProgressBarOpen = new QProgressBar(this);
+    g_pProgressBarOpen->setRange(0, 0);
+    g_pProgressBarOpen->setMaximumWidth(120);
+    g_pProgressBarOpen->hide();
+    ui->statusbar->addPermanentWidget(g_pProgressBarOpen);
+
+    g_pToolButtonCancelOpen = new QToolButton(this);
+    g_pToolButtonCancelOpen->setText(tr("Cancel"));
+    g_pToolButtonCancelOpen->hide();
+    ui->statusbar->addPermanentWidget(g_pToolButtonCancelOpen);
+
+    connect(g_pAsyncOpener, SIGNAL(fileReady(QString, QString, bool)), this, SLOT(onFileReady(QString, QString, bool)));
+    connect(g_pAsyncOpener, SIGNAL(directoryReady(QString, qint32)), this, SLOT(onDirectoryReady(QString, qint32)));
+    connect(g_pAsyncOpener, SIGNAL(finished(QString, bool, bool)), this, SLOT(onOpenFinished(QString, bool, bool)));
+    connect(g_pAsyncOpener, SIGNAL(progress(QString, qint32)), this, SLOT(onOpenProgress(QString, qint32)));
+    connect(g_pToolButtonCancelOpen, SIGNAL(clicked()), this, SLOT(onCancelOpen()));
 
     adjustView();
 
-    if (QCoreApplication::arguments().count() > 1) {
-        openFile(QCoreApplication::arguments().at(1));
-    }
+    // The window is painted first; everything that touches the disk follows from the event loop
+    QTimer::singleShot(0, this, SLOT(onStarted()));
 }
 
 GuiMainWindow::~GuiMainWindow()
 {
+    g_watcherExtract.waitForFinished();
     g_xOptions.save();
 
     delete ui;
 }
 
-void GuiMainWindow::openFile(const QString &sFileName)
+void GuiMainWindow::onStarted()
 {
-    QFileInfo fi(sFileName);
+    g_pRecentFilesMenu = g_xOptions.createRecentFilesMenu(this);
+    ui->menuFile->insertMenu(ui->actionExit, g_pRecentFilesMenu);
+    ui->menuFile->insertSeparator(ui->actionExit);
+    updateRecentFilesMenu();
 
-    if (!fi.exists()) {
-        return;
+    if (QCoreApplication::arguments().count() > 1) {
+        openFile(QCoreApplication::arguments().at(1));
+    } else {
+        // Through the opener: the last directory may be on a share that is gone
+        startOpen(g_xOptions.getLastDirectory());
     }
+}
 
-    if (fi.isDir()) {
-        onDirectoryActivated(fi.absoluteFilePath());
-        return;
+void GuiMainWindow::openFile(const QString &sFileName)
+{
+    startOpen(sFileName);
+}
+
+void GuiMainWindow::onDirectoryActivated(const QString &sDirectoryName)
+{
+    startOpen(sDirectoryName);
+
+    if (ui->actionUnpackChangedFiles->isChecked()) {
+        // Only files that are new or changed since they were last unpacked; the directory stays watched
+        getDropQueueWidget()->addChangedFiles(QFileInfo(sDirectoryName).absoluteFilePath());
+        ui->dockWidgetQueue->show();
     }
+}
 
-    if (!fi.isFile()) {
+void GuiMainWindow::startOpen(const QString &sPath)
+{
+    if (sPath.isEmpty()) {
         return;
     }
 
+    // Even the exists() check can block on a network share, so all of it goes to the opener
+    g_pAsyncOpener->open(sPath);
+
+    ui->statusbar->showMessage(tr("Opening %1...").arg(sPath));
+    g_pProgressBarOpen->show();
+    g_pToolButtonCancelOpen->show();
+}
+
+void GuiMainWindow::onFileReady(const QString &sFileName, const QString &sFileType, bool bIsContainer)
+{
+    QFileInfo fi(sFileName);
+
     ui->centralwidget->setCurrentPath(fi.absoluteFilePath());
+
+    // The opener has detected the type: the dock is only touched for archives, and to put away the last one
+    if (bIsContainer) {
+        // Listed in the background
+        g_pArchiveIndexModel->setFileName(fi.absoluteFilePath());
+        ui->dockWidgetArchive->setWindowTitle(tr("Archive") + QStringLiteral(" - ") + fi.fileName());
+        ui->dockWidgetArchive->show();
+    } else if (ui->dockWidgetArchive->isVisible()) {
+        g_pArchiveIndexModel->clear();
+        ui->dockWidgetArchive->hide();
+    }
+
     setWindowTitle(XOptions::getTitle(X_APPLICATIONDISPLAYNAME, X_APPLICATIONVERSION) +
                    QStringLiteral(" - ") + fi.fileName());
+    ui->statusbar->showMessage(QStringLiteral("%1 [%2]").arg(fi.fileName(), sFileType));
 
     g_xOptions.setLastFileName(fi.absoluteFilePath());
     updateRecentFilesMenu();
 }
 
-void GuiMainWindow::onDirectoryActivated(const QString &sDirectoryName)
+void GuiMainWindow::onDirectoryReady(const QString &sDirectoryName, qint32 nNumberOfEntries)
 {
     QFileInfo fi(sDirectoryName);
 
-    if (fi.isDir()) {
-        ui->centralwidget->setRootPath(fi.absoluteFilePath());
-        g_xOptions.setLastDirectory(fi.absoluteFilePath());
-        setWindowTitle(XOptions::getTitle(X_APPLICATIONDISPLAYNAME, X_APPLICATIONVERSION) +
-                       QStringLiteral(" - ") + fi.fileName());
+    ui->centralwidget->setRootPath(fi.absoluteFilePath());
+    g_xOptions.setLastDirectory(fi.absoluteFilePath());
+    setWindowTitle(XOptions::getTitle(X_APPLICATIONDISPLAYNAME, X_APPLICATIONVERSION) +
+                   QStringLiteral(" - ") + fi.fileName());
+    ui->statusbar->showMessage(tr("%1 entries").arg(nNumberOfEntries));
+}
+
+void GuiMainWindow::onOpenFinished(const QString &sPath, bool bIsValid, bool bIsCanceled)
+{
+    g_pProgressBarOpen->hide();
+    g_pToolButtonCancelOpen->hide();
+
+    if (bIsCanceled) {
+        ui->statusbar->showMessage(tr("Canceled: %1").arg(sPath));
+    } else if (!bIsValid) {
+        ui->statusbar->showMessage(tr("Cannot open: %1").arg(sPath));
+    }
+}
+
+void GuiMainWindow::onOpenProgress(const QString &sPath, qint32 nValue)
+{
+    if (nValue) {
+        ui->statusbar->showMessage(tr("Opening %1... %2 entries").arg(sPath, QString::number(nValue)));
     }
 }
 
+void GuiMainWindow::onCancelOpen()
+{
+    g_pAsyncOpener->cancel();
+}
+
 void GuiMainWindow::on_actionOpen_triggered()
 {
     QString sDirectory = g_xOptions.getLastDirectory();
@@ -158,6 +250,87 @@ void GuiMainWindow::adjustView()
     ui->centralwidget->adjustView();
 }
 
+void GuiMainWindow::onArchiveLoadingFinished(qint32 nNumberOfRecords)
+{
+    if (nNumberOfRecords) {
+        ui->statusbar->showMessage(tr("%1 entries").arg(nNumberOfRecords));
+    } else {
+        ui->dockWidgetArchive->hide();
+    }
+}
+
+void GuiMainWindow::onArchiveRecordActivated(const QModelIndex &index)
+{
+    if (g_watcherExtract.isRunning()) {
+        return;
+    }
+
+    XArchive::RECORD record = g_pArchiveIndexModel->getRecord(index);
+
+    if (record.spInfo.sRecordName.isEmpty()) {
+        return;
+    }
+
+    QString sDirectory = g_xOptions.getLastDirectory();
+    QString sRecordFileName = QFileInfo(record.spInfo.sRecordName).fileName();
+    QString sFileName = QFileDialog::getSaveFileName(this, tr("Save file") + QStringLiteral("..."), sDirectory + QDir::separator() + sRecordFileName,
+                                                     tr("All files") + QStringLiteral(" (*)"));
+
+    if (!sFileName.isEmpty()) {
+        // Only the selected entry is decompressed
+        QString sArchiveFileName = g_pArchiveIndexModel->getFileName();
+        g_sExtractFileName = sFileName;
+
+        ui->statusbar->showMessage(tr("Extracting %1...").arg(record.spInfo.sRecordName));
+
+        g_watcherExtract.setFuture(
+            QtConcurrent::run([sArchiveFileName, record, sFileName]() { return ArchiveIndexModel::extractRecord(sArchiveFileName, record, sFileName, nullptr); }));
+    }
+}
+
+void GuiMainWindow::on_pushButtonExtractMatching_clicked()
+{
+    QStringList listPatterns = ui->lineEditExtractPattern->text().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+
+    if (g_watcherExtract.isRunning() || listPatterns.isEmpty() || g_pArchiveIndexModel->getFileName().isEmpty()) {
+        return;
+    }
+
+    QString sDirectory = QFileDialog::getExistingDirectory(this, tr("Extract to") + QStringLiteral("..."), g_xOptions.getLastDirectory());
+
+    if (!sDirectory.isEmpty()) {
+        // The archive directory picks the records; only those and the containers on their way are decoded
+        QString sArchiveFileName = g_pArchiveIndexModel->getFileName();
+        g_sExtractFileName = sDirectory;
+
+        ui->statusbar->showMessage(tr("Extracting %1...").arg(listPatterns.join(QLatin1Char(' '))));
+
+        g_watcherExtract.setFuture(QtConcurrent::run([sArchiveFileName, sDirectory, listPatterns]() {
+            EntryFilter entryFilter;
+            entryFilter.setPatterns(listPatterns);
+
+            UnpackEngine::OPTIONS options = UnpackEngine::getDefaultOptions();
+            options.bScan = false;
+            options.nMaxDepth = 0;
+            options.pEntryFilter = &entryFilter;
+
+            UnpackEngine engine;
+            UnpackEngine::RESULT result = engine.processFile(sArchiveFileName, sDirectory, options);
+
+            return (result.status == UnpackEngine::STATUS_OK) && (result.nNumberOfEntries > 0);
+        }));
+    }
+}
+
+void GuiMainWindow::onArchiveExtractFinished()
+{
+    if (g_watcherExtract.result()) {
+        ui->statusbar->showMessage(tr("Saved: %1").arg(g_sExtractFileName));
+    } else {
+        ui->statusbar->showMessage(tr("Cannot save: %1").arg(g_sExtractFileName));
+    }
+}
+
 void GuiMainWindow::dragEnterEvent(QDragEnterEvent *pEvent)
 {
     pEvent->acceptProposedAction();
@@ -175,9 +348,24 @@ void GuiMainWindow::dropEvent(QDropEvent *pEvent)
     if (mimeData->hasUrls()) {
         QList<QUrl> urlList = mimeData->urls();
 
-        if (urlList.count()) {
+        if (urlList.count() == 1) {
             QString sFileName = urlList.at(0).toLocalFile();
             openFile(sFileName);
+        } else if (urlList.count() > 1) {
+            QStringList listFileNames;
+
+            qint32 nNumberOfUrls = urlList.count();
+
+            for (qint32 i = 0; i < nNumberOfUrls; i++) {
+                QString sFileName = urlList.at(i).toLocalFile();
+
+                if (!sFileName.isEmpty()) {
+                    listFileNames.append(sFileName);
+                }
+            }
+
+            getDropQueueWidget()->addPaths(listFileNames);
+            ui->dockWidgetQueue->show();
         }
     }
 }
@@ -188,3 +376,13 @@ void GuiMainWindow::updateRecentFilesMenu()
         g_pRecentFilesMenu->setEnabled(g_xOptions.getRecentFiles().count());
     }
 }
+
+DropQueueWidget *GuiMainWindow::getDropQueueWidget()
+{
+    if (!g_pDropQueueWidget) {
+        g_pDropQueueWidget = new DropQueueWidget(ui->dockWidgetQueue);
+        ui->dockWidgetQueue->setWidget(g_pDropQueueWidget);
+    }
+
+    return g_pDropQueueWidget;
+}
@@ -23,15 +23,22 @@
 
 #include <QDragEnterEvent>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMainWindow>
 #include <QMenu>
 #include <QMimeData>
+#include <QProgressBar>
+#include <QToolButton>
 
 #include "../global.h"
+#include "archiveindexmodel.h"
+#include "asyncopener.h"
 #include "dialogabout.h"
 #include "xoptions.h"
 #include "xshortcuts.h"
 
+class DropQueueWidget;
+
 namespace Ui {
 class GuiMainWindow;
 }
@@ -44,6 +51,7 @@ public:
     ~GuiMainWindow() override;
 
 private slots:
+    void onStarted();
     void openFile(const QString &sFileName);
     void onDirectoryActivated(const QString &sDirectoryName);
     void on_actionOpen_triggered();
@@ -51,6 +59,15 @@ private slots:
     void on_actionAbout_triggered();
     void on_actionExit_triggered();
     void adjustView();
+    void onFileReady(const QString &sFileName, const QString &sFileType, bool bIsContainer);
+    void onDirectoryReady(const QString &sDirectoryName, qint32 nNumberOfEntries);
+    void onOpenFinished(const QString &sPath, bool bIsValid, bool bIsCanceled);
+    void onOpenProgress(const QString &sPath, qint32 nValue);
+    void onCancelOpen();
+    void onArchiveLoadingFinished(qint32 nNumberOfRecords);
+    void onArchiveRecordActivated(const QModelIndex &index);
+    void on_pushButtonExtractMatching_clicked();
+    void onArchiveExtractFinished();
 
 protected:
     void dragEnterEvent(QDragEnterEvent *pEvent) override;
@@ -58,12 +75,22 @@ protected:
     void dropEvent(QDropEvent *pEvent) override;
 
 private:
+    void startOpen(const QString &sPath);
     void updateRecentFilesMenu();
+    // Created on the first drop or watched directory, with its engines and index
+    DropQueueWidget *getDropQueueWidget();
 
     Ui::GuiMainWindow *ui;
     XOptions g_xOptions;
     XShortcuts g_xShortcuts;
     QMenu *g_pRecentFilesMenu;
+    ArchiveIndexModel *g_pArchiveIndexModel;
+    QFutureWatcher<bool> g_watcherExtract;
+    QString g_sExtractFileName;
+    AsyncOpener *g_pAsyncOpener;
+    QProgressBar *g_pProgressBarOpen;
+    QToolButton *g_pToolButtonCancelOpen;
+    DropQueueWidget *g_pDropQueueWidget;
 };
 
 #endif  // GUIMAINWINDOW_H
@@ -24,6 +24,7 @@
 
 #include "../global.h"
 #include "guimainwindow.h"
+#include "unpacktracer.h"
 #include "xoptions.h"
 
 namespace {
@@ -76,8 +77,29 @@ int main(int argc, char *argv[])
     options.load();
     XOptions::adjustApplicationView(X_APPLICATIONNAME, &options);
 
-    GuiMainWindow window;
-    window.show();
+#ifdef USE_TRACE
+    // No command line to pass it on; the timeline covers every queue run until the window closes
+    QString sTraceFileName = qEnvironmentVariable("XFILEUNPACKER_TRACE");
 
-    return application.exec();
+    if (!sTraceFileName.isEmpty()) {
+        UnpackTracer::start();
+    }
+#endif
+
+    int nResult = 0;
+
+    {
+        GuiMainWindow window;
+        window.show();
+
+        nResult = application.exec();
+    }
+
+#ifdef USE_TRACE
+    if (!sTraceFileName.isEmpty()) {
+        UnpackTracer::writeChromeTrace(sTraceFileName, nullptr);
+    }
+#endif
+
+    return nResult;
 }
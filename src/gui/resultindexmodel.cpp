@@ -0,0 +1,661 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "resultindexmodel.h"
+
+#include <algorithm>
+#include <numeric>
+
+ResultIndexModel::ResultIndexModel(QObject *pParent)
+    : QAbstractTableModel(pParent),
+      m_bIsViewActive(false),
+      m_nNumberOfViewed(0),
+      m_nSortColumn(-1),
+      m_sortOrder(Qt::AscendingOrder),
+      m_nIndexedOffset(0),
+      m_bIsIndexing(false),
+      m_bIsRefreshPending(false),
+      m_bIsViewBuilding(false),
+      m_nPendingViewed(0),
+      m_bIsBusy(false),
+      m_pdStructIndex(XBinary::createPdStruct()),
+      m_pdStructView(XBinary::createPdStruct()),
+      m_nGeneration(0),
+      m_nViewGeneration(0)
+{
+    m_cacheRows.setMaxCost(N_CACHE_SIZE);
+}
+
+ResultIndexModel::~ResultIndexModel()
+{
+    stopIndexing();
+    stopView();
+}
+
+void ResultIndexModel::setFileName(const QString &sFileName)
+{
+    clear();
+
+    m_sFileName = sFileName;
+    m_file.setFileName(sFileName);
+
+    startIndexing();
+}
+
+void ResultIndexModel::clear()
+{
+    stopIndexing();
+    stopView();
+
+    beginResetModel();
+
+    m_nGeneration++;
+    m_sFileName.clear();
+    m_file.close();
+    m_cacheRows.clear();
+    m_listOffsets.clear();
+    m_listView.clear();
+    m_bIsViewActive = false;
+    m_nNumberOfViewed = 0;
+    m_nIndexedOffset = 0;
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        m_listPendingOffsets.clear();
+        m_listPendingView.clear();
+    }
+
+    endResetModel();
+
+    updateBusy();
+}
+
+void ResultIndexModel::refresh()
+{
+    if (!m_sFileName.isEmpty()) {
+        if (m_bIsIndexing) {
+            m_bIsRefreshPending = true;
+        } else {
+            startIndexing();
+        }
+    }
+}
+
+void ResultIndexModel::setFilter(const QString &sFilter)
+{
+    if (sFilter != m_sFilter) {
+        // Narrowing keeps the current order, sorted or not
+        bool bIsNarrowing = m_bIsViewActive && (!m_bIsViewBuilding) && (!m_sFilter.isEmpty()) && sFilter.contains(m_sFilter, Qt::CaseInsensitive);
+
+        m_sFilter = sFilter;
+
+        VIEWJOB viewJob = {};
+        viewJob.sFilter = sFilter;
+        viewJob.nSortColumn = -1;
+        viewJob.sortOrder = m_sortOrder;
+
+        if (bIsNarrowing) {
+            viewJob.listSource = m_listView;
+            viewJob.nNumberOfRecords = m_nNumberOfViewed;
+        } else {
+            viewJob.listSource = getAllRows(0);
+            viewJob.nSortColumn = m_nSortColumn;
+            viewJob.nNumberOfRecords = m_listOffsets.count();
+        }
+
+        startView(viewJob);
+    }
+}
+
+bool ResultIndexModel::isBusy() const
+{
+    return m_bIsBusy;
+}
+
+qint32 ResultIndexModel::getNumberOfRecords() const
+{
+    return m_listOffsets.count();
+}
+
+QString ResultIndexModel::scanResultToString(const XScanEngine::SCAN_RESULT &scanResult)
+{
+    QStringList listParts;
+
+    qint32 nNumberOfRecords = scanResult.listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const XScanEngine::SCANSTRUCT &scanStruct = scanResult.listRecords.at(i);
+
+        QString sRecord = QStringLiteral("%1: %2").arg(scanStruct.sType, scanStruct.sName);
+
+        if (!scanStruct.sVersion.isEmpty()) {
+            sRecord.append(QStringLiteral("(%1)").arg(scanStruct.sVersion));
+        }
+
+        listParts.append(sRecord);
+    }
+
+    return listParts.join(QStringLiteral("; "));
+}
+
+int ResultIndexModel::rowCount(const QModelIndex &parent) const
+{
+    qint32 nResult = 0;
+
+    if (!parent.isValid()) {
+        nResult = m_bIsViewActive ? m_listView.count() : m_listOffsets.count();
+    }
+
+    return nResult;
+}
+
+int ResultIndexModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : __COLUMN_SIZE;
+}
+
+QVariant ResultIndexModel::data(const QModelIndex &index, int nRole) const
+{
+    QVariant result;
+
+    if (index.isValid() && (index.row() < rowCount())) {
+        if ((nRole == Qt::DisplayRole) || (nRole == Qt::ToolTipRole)) {
+            qint32 nRecord = getRecord(index.row());
+            ROW *pRow = m_cacheRows.object(nRecord);
+
+            if (!pRow) {
+                if (!m_file.isOpen()) {
+                    m_file.open(QIODevice::ReadOnly);
+                }
+
+                ROW *pNewRow = new ROW;
+
+                if (readRow(&m_file, m_listOffsets.at(nRecord), pNewRow)) {
+                    m_cacheRows.insert(nRecord, pNewRow);
+                    pRow = pNewRow;
+                } else {
+                    delete pNewRow;
+                }
+            }
+
+            if (pRow) {
+                qint32 nColumn = index.column();
+
+                if (nRole == Qt::ToolTipRole) {
+                    if (nColumn == COLUMN_PATH) {
+                        result = pRow->sInput;
+                    } else if (nColumn == COLUMN_RESULT) {
+                        result = pRow->sResult;
+                    }
+                } else if (nColumn == COLUMN_PATH) {
+                    result = pRow->sPath;
+                } else if (nColumn == COLUMN_TYPE) {
+                    result = pRow->sFileType;
+                } else if (nColumn == COLUMN_SIZE) {
+                    result = pRow->nSize;
+                } else if (nColumn == COLUMN_COMPRESSEDSIZE) {
+                    result = pRow->nCompressedSize;
+                } else if (nColumn == COLUMN_RESULT) {
+                    result = pRow->sResult;
+                }
+            }
+        } else if (nRole == Qt::TextAlignmentRole) {
+            if ((index.column() == COLUMN_SIZE) || (index.column() == COLUMN_COMPRESSEDSIZE)) {
+                result = (qint32)(Qt::AlignRight | Qt::AlignVCenter);
+            }
+        }
+    }
+
+    return result;
+}
+
+QVariant ResultIndexModel::headerData(int nSection, Qt::Orientation orientation, int nRole) const
+{
+    QVariant result;
+
+    if ((orientation == Qt::Horizontal) && (nRole == Qt::DisplayRole)) {
+        if (nSection == COLUMN_PATH) {
+            result = tr("Path");
+        } else if (nSection == COLUMN_TYPE) {
+            result = tr("Type");
+        } else if (nSection == COLUMN_SIZE) {
+            result = tr("Size");
+        } else if (nSection == COLUMN_COMPRESSEDSIZE) {
+            result = tr("Compressed");
+        } else if (nSection == COLUMN_RESULT) {
+            result = tr("Result");
+        }
+    }
+
+    return result;
+}
+
+void ResultIndexModel::sort(int nColumn, Qt::SortOrder order)
+{
+    m_nSortColumn = ((nColumn >= 0) && (nColumn < __COLUMN_SIZE)) ? nColumn : -1;
+    m_sortOrder = order;
+
+    VIEWJOB viewJob = {};
+    viewJob.nSortColumn = m_nSortColumn;
+    viewJob.sortOrder = order;
+
+    // A finished filter is sorted as it is; file order needs the filter run again
+    if (m_bIsViewActive && (!m_bIsViewBuilding) && (!m_sFilter.isEmpty()) && (m_nSortColumn != -1)) {
+        viewJob.listSource = m_listView;
+        viewJob.nNumberOfRecords = m_nNumberOfViewed;
+    } else {
+        viewJob.listSource = getAllRows(0);
+        viewJob.sFilter = m_sFilter;
+        viewJob.nNumberOfRecords = m_listOffsets.count();
+    }
+
+    startView(viewJob);
+}
+
+void ResultIndexModel::onRecordsIndexed(quint32 nGeneration)
+{
+    if (nGeneration != m_nGeneration) {
+        return;
+    }
+
+    QVector<qint64> listOffsets;
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        listOffsets = m_listPendingOffsets;
+        m_listPendingOffsets.clear();
+    }
+
+    qint32 nNumberOfNewRecords = listOffsets.count();
+
+    if (nNumberOfNewRecords > 0) {
+        qint32 nFirst = m_listOffsets.count();
+
+        if (m_bIsViewActive) {
+            m_listOffsets += listOffsets;
+
+            startPendingView();
+        } else {
+            beginInsertRows(QModelIndex(), nFirst, nFirst + nNumberOfNewRecords - 1);
+            m_listOffsets += listOffsets;
+            endInsertRows();
+        }
+    }
+}
+
+void ResultIndexModel::onIndexingFinished(quint32 nGeneration, qint64 nOffset)
+{
+    if (nGeneration != m_nGeneration) {
+        return;
+    }
+
+    onRecordsIndexed(nGeneration);
+
+    m_futureIndex.waitForFinished();
+    m_bIsIndexing = false;
+    m_nIndexedOffset = nOffset;
+
+    if (m_bIsRefreshPending) {
+        m_bIsRefreshPending = false;
+
+        startIndexing();
+    }
+
+    updateBusy();
+}
+
+void ResultIndexModel::onViewReady(quint32 nGeneration, bool bAppend)
+{
+    if (nGeneration != m_nViewGeneration) {
+        return;
+    }
+
+    m_futureView.waitForFinished();
+    m_bIsViewBuilding = false;
+
+    QVector<qint32> listView;
+
+    {
+        QMutexLocker locker(&m_mutexPending);
+        listView = m_listPendingView;
+        m_listPendingView.clear();
+    }
+
+    if (bAppend) {
+        if (!listView.isEmpty()) {
+            qint32 nFirst = m_listView.count();
+
+            beginInsertRows(QModelIndex(), nFirst, nFirst + listView.count() - 1);
+            m_listView += listView;
+            endInsertRows();
+        }
+    } else {
+        beginResetModel();
+        m_listView = listView;
+        m_bIsViewActive = true;
+        endResetModel();
+    }
+
+    m_nNumberOfViewed = m_nPendingViewed;
+
+    startPendingView();
+    updateBusy();
+}
+
+void ResultIndexModel::stopIndexing()
+{
+    if (m_bIsIndexing) {
+        m_pdStructIndex.bIsStop = true;
+        m_futureIndex.waitForFinished();
+        m_bIsIndexing = false;
+    }
+
+    m_bIsRefreshPending = false;
+}
+
+void ResultIndexModel::stopView()
+{
+    if (m_bIsViewBuilding) {
+        m_pdStructView.bIsStop = true;
+        m_futureView.waitForFinished();
+        m_bIsViewBuilding = false;
+    }
+
+    // Drops a notification still queued
+    m_nViewGeneration++;
+}
+
+void ResultIndexModel::startIndexing()
+{
+    QString sFileName = m_sFileName;
+    qint64 nOffset = m_nIndexedOffset;
+    quint32 nGeneration = m_nGeneration;
+
+    m_pdStructIndex = XBinary::createPdStruct();
+    m_bIsIndexing = true;
+
+    m_futureIndex = QtConcurrent::run([this, sFileName, nOffset, nGeneration]() { indexRecords(sFileName, nOffset, nGeneration); });
+
+    updateBusy();
+}
+
+void ResultIndexModel::startView(const VIEWJOB &viewJob)
+{
+    stopView();
+
+    if ((!viewJob.bAppend) && viewJob.sFilter.isEmpty() && (viewJob.nSortColumn == -1)) {
+        // File order, all rows: no index needed
+        beginResetModel();
+        m_listView.clear();
+        m_bIsViewActive = false;
+        m_nNumberOfViewed = 0;
+        endResetModel();
+    } else {
+        QString sFileName = m_sFileName;
+        QVector<qint64> listOffsets = m_listOffsets;
+        quint32 nGeneration = m_nViewGeneration;
+
+        m_pdStructView = XBinary::createPdStruct();
+        m_bIsViewBuilding = true;
+        m_nPendingViewed = viewJob.nNumberOfRecords;
+
+        m_futureView =
+            QtConcurrent::run([this, sFileName, listOffsets, viewJob, nGeneration]() { buildView(sFileName, listOffsets, viewJob, nGeneration); });
+    }
+
+    updateBusy();
+}
+
+void ResultIndexModel::startPendingView()
+{
+    if (m_bIsViewActive && (!m_bIsViewBuilding) && (m_nNumberOfViewed < m_listOffsets.count())) {
+        VIEWJOB viewJob = {};
+        viewJob.listSource = getAllRows(m_nNumberOfViewed);
+        viewJob.sFilter = m_sFilter;
+        viewJob.nSortColumn = -1;
+        viewJob.sortOrder = m_sortOrder;
+        viewJob.bAppend = true;
+        viewJob.nNumberOfRecords = m_listOffsets.count();
+
+        startView(viewJob);
+    }
+}
+
+void ResultIndexModel::updateBusy()
+{
+    bool bIsBusy = m_bIsIndexing || m_bIsViewBuilding;
+
+    if (bIsBusy != m_bIsBusy) {
+        m_bIsBusy = bIsBusy;
+
+        emit busyChanged(bIsBusy);
+    }
+}
+
+void ResultIndexModel::indexRecords(const QString &sFileName, qint64 nOffset, quint32 nGeneration)
+{
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly) && file.seek(nOffset)) {
+        QByteArray baData;
+
+        while (XBinary::isPdStructNotCanceled(&m_pdStructIndex)) {
+            QByteArray baChunk = file.read(N_READ_SIZE);
+
+            if (baChunk.isEmpty()) {
+                break;
+            }
+
+            baData.append(baChunk);
+
+            QVector<qint64> listOffsets;
+            qint32 nStart = 0;
+
+            while (true) {
+                qint32 nEnd = baData.indexOf('\n', nStart);
+
+                if (nEnd == -1) {
+                    break;
+                }
+
+                // Quotes inside JSON strings are escaped, so this only matches the record key
+                if (QByteArray::fromRawData(baData.constData() + nStart, nEnd - nStart).contains("\"record\":\"entry\"")) {
+                    listOffsets.append(nOffset + nStart);
+                }
+
+                nStart = nEnd + 1;
+            }
+
+            // A record the writer has not finished yet is read again by the next pass
+            nOffset += nStart;
+            baData.remove(0, nStart);
+
+            if (!listOffsets.isEmpty()) {
+                {
+                    QMutexLocker locker(&m_mutexPending);
+                    m_listPendingOffsets += listOffsets;
+                }
+
+                QMetaObject::invokeMethod(this, "onRecordsIndexed", Qt::QueuedConnection, Q_ARG(quint32, nGeneration));
+            }
+        }
+
+        file.close();
+    }
+
+    QMetaObject::invokeMethod(this, "onIndexingFinished", Qt::QueuedConnection, Q_ARG(quint32, nGeneration), Q_ARG(qint64, nOffset));
+}
+
+void ResultIndexModel::buildView(const QString &sFileName, QVector<qint64> listOffsets, VIEWJOB viewJob, quint32 nGeneration)
+{
+    QVector<qint32> listResult;
+
+    qint32 nNumberOfSources = viewJob.listSource.count();
+    bool bFilter = !viewJob.sFilter.isEmpty();
+    bool bSort = (viewJob.nSortColumn != -1);
+    bool bIsNumeric = (viewJob.nSortColumn == COLUMN_SIZE) || (viewJob.nSortColumn == COLUMN_COMPRESSEDSIZE);
+
+    QVector<bool> listMatches(nNumberOfSources, true);
+    QVector<QString> listStringKeys;
+    QVector<qint64> listNumberKeys;
+
+    if (bSort) {
+        if (bIsNumeric) {
+            listNumberKeys.resize(nNumberOfSources);
+        } else {
+            listStringKeys.resize(nNumberOfSources);
+        }
+    }
+
+    if (bFilter || bSort) {
+        QFile file(sFileName);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            // Visited in file order so the reads stay close together
+            QVector<qint32> listPositions(nNumberOfSources);
+            std::iota(listPositions.begin(), listPositions.end(), 0);
+            std::sort(listPositions.begin(), listPositions.end(),
+                      [&viewJob](qint32 nA, qint32 nB) { return viewJob.listSource.at(nA) < viewJob.listSource.at(nB); });
+
+            for (qint32 i = 0; (i < nNumberOfSources) && XBinary::isPdStructNotCanceled(&m_pdStructView); i++) {
+                qint32 nPosition = listPositions.at(i);
+
+                ROW row = {};
+                bool bIsRead = readRow(&file, listOffsets.at(viewJob.listSource.at(nPosition)), &row);
+
+                if (bFilter) {
+                    listMatches[nPosition] = bIsRead && isRowMatched(row, viewJob.sFilter);
+                }
+
+                if (bSort) {
+                    if (viewJob.nSortColumn == COLUMN_PATH) {
+                        listStringKeys[nPosition] = row.sPath;
+                    } else if (viewJob.nSortColumn == COLUMN_TYPE) {
+                        listStringKeys[nPosition] = row.sFileType;
+                    } else if (viewJob.nSortColumn == COLUMN_SIZE) {
+                        listNumberKeys[nPosition] = row.nSize;
+                    } else if (viewJob.nSortColumn == COLUMN_COMPRESSEDSIZE) {
+                        listNumberKeys[nPosition] = row.nCompressedSize;
+                    } else if (viewJob.nSortColumn == COLUMN_RESULT) {
+                        listStringKeys[nPosition] = row.sResult;
+                    }
+                }
+            }
+
+            file.close();
+        }
+    }
+
+    if (XBinary::isPdStructNotCanceled(&m_pdStructView)) {
+        QVector<qint32> listSelected;
+
+        for (qint32 i = 0; i < nNumberOfSources; i++) {
+            if (listMatches.at(i)) {
+                listSelected.append(i);
+            }
+        }
+
+        if (bSort) {
+            bool bIsAscending = (viewJob.sortOrder == Qt::AscendingOrder);
+
+            std::stable_sort(listSelected.begin(), listSelected.end(), [&](qint32 nA, qint32 nB) {
+                bool bResult = false;
+
+                if (bIsNumeric) {
+                    bResult = bIsAscending ? (listNumberKeys.at(nA) < listNumberKeys.at(nB)) : (listNumberKeys.at(nB) < listNumberKeys.at(nA));
+                } else {
+                    qint32 nCompare = QString::compare(listStringKeys.at(nA), listStringKeys.at(nB), Qt::CaseInsensitive);
+                    bResult = bIsAscending ? (nCompare < 0) : (nCompare > 0);
+                }
+
+                return bResult;
+            });
+        }
+
+        qint32 nNumberOfSelected = listSelected.count();
+        listResult.reserve(nNumberOfSelected);
+
+        for (qint32 i = 0; i < nNumberOfSelected; i++) {
+            listResult.append(viewJob.listSource.at(listSelected.at(i)));
+        }
+
+        {
+            QMutexLocker locker(&m_mutexPending);
+            m_listPendingView = listResult;
+        }
+
+        QMetaObject::invokeMethod(this, "onViewReady", Qt::QueuedConnection, Q_ARG(quint32, nGeneration), Q_ARG(bool, viewJob.bAppend));
+    }
+}
+
+bool ResultIndexModel::readRow(QFile *pFile, qint64 nOffset, ROW *pRow)
+{
+    bool bResult = false;
+
+    if (pFile->seek(nOffset)) {
+        QJsonDocument jsDoc = QJsonDocument::fromJson(pFile->readLine());
+
+        if (jsDoc.isObject()) {
+            QJsonObject jsRecord = jsDoc.object();
+
+            pRow->sInput = jsRecord.value(QStringLiteral("input")).toString();
+            pRow->sPath = jsRecord.value(QStringLiteral("path")).toString();
+            pRow->sFileType = jsRecord.value(QStringLiteral("filetype")).toString();
+            pRow->nSize = (qint64)jsRecord.value(QStringLiteral("usize")).toDouble();
+            pRow->nCompressedSize = (qint64)jsRecord.value(QStringLiteral("csize")).toDouble();
+            pRow->sResult = scanResultToString(ResultCache::scanResultFromJson(jsRecord.value(QStringLiteral("scan")).toArray()));
+
+            QString sError = jsRecord.value(QStringLiteral("error")).toString();
+
+            if (!sError.isEmpty()) {
+                pRow->sResult = pRow->sResult.isEmpty() ? sError : (pRow->sResult + QStringLiteral("; ") + sError);
+            }
+
+            bResult = true;
+        }
+    }
+
+    return bResult;
+}
+
+bool ResultIndexModel::isRowMatched(const ROW &row, const QString &sFilter)
+{
+    return row.sPath.contains(sFilter, Qt::CaseInsensitive) || row.sFileType.contains(sFilter, Qt::CaseInsensitive) ||
+           row.sResult.contains(sFilter, Qt::CaseInsensitive);
+}
+
+QVector<qint32> ResultIndexModel::getAllRows(qint32 nFirst) const
+{
+    qint32 nNumberOfRecords = m_listOffsets.count();
+
+    QVector<qint32> listResult;
+    listResult.reserve(qMax(0, nNumberOfRecords - nFirst));
+
+    for (qint32 i = nFirst; i < nNumberOfRecords; i++) {
+        listResult.append(i);
+    }
+
+    return listResult;
+}
+
+qint32 ResultIndexModel::getRecord(qint32 nRow) const
+{
+    return m_bIsViewActive ? m_listView.at(nRow) : nRow;
+}
@@ -0,0 +1,148 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RESULTINDEXMODEL_H
+#define RESULTINDEXMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QFile>
+#include <QFuture>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVector>
+#include <QtConcurrent>
+
+#include "resultcache.h"
+
+// Entry records of a ResultWriter JSON Lines file, for results too large to hold. Only the
+// offset of each record stays in memory (8 bytes a row); rows are parsed from the file when
+// a view paints them and kept in a small cache. The file may grow while it is shown:
+// refresh() indexes what was appended since the last pass.
+//
+// Filtering and sorting build a row order on a background thread and swap it in when done.
+// A filter that extends the previous one only searches the rows that matched before. Rows
+// indexed while a filter or sort is active are filtered and appended at the end.
+class ResultIndexModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum COLUMN {
+        COLUMN_PATH = 0,
+        COLUMN_TYPE,
+        COLUMN_SIZE,
+        COLUMN_COMPRESSEDSIZE,
+        COLUMN_RESULT,
+        __COLUMN_SIZE
+    };
+
+    explicit ResultIndexModel(QObject *pParent = nullptr);
+    ~ResultIndexModel() override;
+
+    void setFileName(const QString &sFileName);
+    void clear();
+    // Case-insensitive, on path, type and result; empty: all rows
+    void setFilter(const QString &sFilter);
+    bool isBusy() const;
+    qint32 getNumberOfRecords() const;
+    static QString scanResultToString(const XScanEngine::SCAN_RESULT &scanResult);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int nRole = Qt::DisplayRole) const override;
+    QVariant headerData(int nSection, Qt::Orientation orientation, int nRole = Qt::DisplayRole) const override;
+    // nColumn -1: file order
+    void sort(int nColumn, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+public slots:
+    void refresh();
+
+signals:
+    void busyChanged(bool bIsBusy);
+
+private slots:
+    void onRecordsIndexed(quint32 nGeneration);
+    void onIndexingFinished(quint32 nGeneration, qint64 nOffset);
+    void onViewReady(quint32 nGeneration, bool bAppend);
+
+private:
+    struct ROW {
+        QString sInput;
+        QString sPath;
+        QString sFileType;
+        qint64 nSize;
+        qint64 nCompressedSize;
+        QString sResult;
+    };
+
+    struct VIEWJOB {
+        QVector<qint32> listSource;  // Rows to look at, in the order they keep without a sort
+        QString sFilter;             // Empty: rows of listSource are not filtered
+        qint32 nSortColumn;          // -1: order of listSource
+        Qt::SortOrder sortOrder;
+        bool bAppend;                // Result goes after the current view
+        qint32 nNumberOfRecords;     // Records the view covers once the job is done
+    };
+
+    void stopIndexing();
+    void stopView();
+    void startIndexing();
+    void startView(const VIEWJOB &viewJob);
+    void startPendingView();
+    void updateBusy();
+    void indexRecords(const QString &sFileName, qint64 nOffset, quint32 nGeneration);
+    void buildView(const QString &sFileName, QVector<qint64> listOffsets, VIEWJOB viewJob, quint32 nGeneration);
+    static bool readRow(QFile *pFile, qint64 nOffset, ROW *pRow);
+    static bool isRowMatched(const ROW &row, const QString &sFilter);
+    QVector<qint32> getAllRows(qint32 nFirst) const;
+    qint32 getRecord(qint32 nRow) const;
+
+    static const qint64 N_READ_SIZE = 1024 * 1024;
+    static const qint32 N_CACHE_SIZE = 4096;  // Rows
+
+    QString m_sFileName;
+    mutable QFile m_file;  // Reads for data() on the GUI thread
+    mutable QCache<qint32, ROW> m_cacheRows;
+    QVector<qint64> m_listOffsets;
+    QVector<qint32> m_listView;  // Row -> record; used while m_bIsViewActive
+    bool m_bIsViewActive;
+    qint32 m_nNumberOfViewed;  // Records m_listView was built from
+    QString m_sFilter;
+    qint32 m_nSortColumn;
+    Qt::SortOrder m_sortOrder;
+    qint64 m_nIndexedOffset;  // Start of the first record not indexed yet
+    bool m_bIsIndexing;
+    bool m_bIsRefreshPending;
+    bool m_bIsViewBuilding;
+    qint32 m_nPendingViewed;  // nNumberOfRecords of the running job
+    bool m_bIsBusy;
+    QFuture<void> m_futureIndex;
+    QFuture<void> m_futureView;
+    XBinary::PDSTRUCT m_pdStructIndex;
+    XBinary::PDSTRUCT m_pdStructView;
+    QMutex m_mutexPending;
+    QVector<qint64> m_listPendingOffsets;
+    QVector<qint32> m_listPendingView;
+    quint32 m_nGeneration;      // Late notifications of a previous file are dropped
+    quint32 m_nViewGeneration;  // Same for superseded filters and sorts
+};
+
+#endif  // RESULTINDEXMODEL_H